@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+#include "board_delta.h"
+
+// 서버 쪽 보드(octaflip.h)에는 막힌 칸이 없지만 형식은 클라이언트 보드와 같이 둔다
+#ifndef BLOCKED_CELL
+#define BLOCKED_CELL '#'
+#endif
+
+void board_masks(const GameBoard *board, uint64_t *red, uint64_t *blue, uint64_t *blocked) {
+    uint64_t r = 0, b = 0, x = 0;
+    for (int row = 0; row < BOARD_SIZE; row++) {
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            uint64_t bit = 1ull << (row * BOARD_SIZE + col);
+            switch (board->cells[row][col]) {
+                case RED_PLAYER: r |= bit; break;
+                case BLUE_PLAYER: b |= bit; break;
+                case BLOCKED_CELL: x |= bit; break;
+                default: break;
+            }
+        }
+    }
+    *red = r;
+    *blue = b;
+    *blocked = x;
+}
+
+// splitmix64 마무리 단계 (비트 하나만 달라도 결과 전체가 바뀜)
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t board_hash(const GameBoard *board) {
+    uint64_t red, blue, blocked;
+    board_masks(board, &red, &blue, &blocked);
+    return mix64(red) ^ mix64(blue + 0x9e3779b97f4a7c15ull);
+}
+
+uint64_t board_flipped(const GameBoard *before, const GameBoard *after, char player) {
+    char opponent = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    uint64_t flipped = 0;
+    for (int row = 0; row < BOARD_SIZE; row++) {
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            if (before->cells[row][col] == opponent && after->cells[row][col] == player) {
+                flipped |= 1ull << (row * BOARD_SIZE + col);
+            }
+        }
+    }
+    return flipped;
+}
+
+void board_view_reset(BoardView *view) {
+    view->seq = 0;
+    view->synced = 0;
+}
+
+static int in_board(int coord) {
+    return coord >= 1 && coord <= BOARD_SIZE;
+}
+
+// 델타의 수를 적용 (좌표는 1부터). 둔 쪽은 출발 칸의 말로 정해진다. 뒤집힌 칸이 다르면 0
+static int apply_delta_move(GameBoard *board, const DecodedMessage *message) {
+    const Move *wire = &message->move;
+    if (!in_board(wire->sourceRow) || !in_board(wire->sourceCol) ||
+        !in_board(wire->targetRow) || !in_board(wire->targetCol)) {
+        return 0;
+    }
+    Move move = {
+        .sourceRow = wire->sourceRow - 1,
+        .sourceCol = wire->sourceCol - 1,
+        .targetRow = wire->targetRow - 1,
+        .targetCol = wire->targetCol - 1,
+        .player = board->cells[wire->sourceRow - 1][wire->sourceCol - 1]
+    };
+    if (move.player != RED_PLAYER && move.player != BLUE_PLAYER) return 0;
+
+    GameBoard before = *board;
+    applyMove(board, &move);
+    if ((message->fields & DECODED_FLIPPED) && board_flipped(&before, board, move.player) != message->flipped) {
+        return 0;
+    }
+    return 1;
+}
+
+int board_view_update(BoardView *view, GameBoard *board, const DecodedMessage *message) {
+    if (message->fields & DECODED_BOARD) {
+        memcpy(board->cells, message->board.cells, sizeof(board->cells));
+        countPieces(board);
+        // 스냅샷이면 여기서부터 다시 델타를 따라감
+        if (message->fields & DECODED_SEQ) {
+            view->seq = message->seq;
+            view->synced = 1;
+            if ((message->fields & DECODED_HASH) && board_hash(board) != message->hash) {
+                fprintf(stderr, "[Client] 스냅샷 해시가 맞지 않음 (seq %u)\n", message->seq);
+            }
+        }
+        return 1;
+    }
+    if (!(message->fields & DECODED_SEQ)) return 0;
+    if (!view->synced) return 1;        // 다음 스냅샷까지 지금 보드로 버팀
+
+    int ok;
+    if (message->fields & DECODED_MOVE) {
+        ok = (message->seq == view->seq + 1) && apply_delta_move(board, message);
+    } else {
+        ok = (message->seq == view->seq);
+    }
+    if (ok && (message->fields & DECODED_HASH) && board_hash(board) != message->hash) ok = 0;
+
+    view->seq = message->seq;
+    if (!ok) {
+        fprintf(stderr, "[Client] 보드 델타가 맞지 않음 (seq %u), 다음 스냅샷까지 대기\n", message->seq);
+        view->synced = 0;
+    }
+    return 1;
+}
@@ -13,6 +13,11 @@
 #include "octaflip.h"
 #include "json.h"
 #include "message_handler.h"
+#include "msg_decoder.h"
+#include "msg_binary.h"
+#include "board_delta.h"
+#include "output_buffer.h"
+#include "framer.h"
 #include "ai_engine.h"
 
 #define BUFFER_SIZE 1024
@@ -33,11 +38,20 @@ GameBoard game_board;
 char my_username[64];
 char my_color;
 char opponent_username[64];
+LineFramer in_framer;         // 받은 데이터 (개행 단위로 잘라 처리, 여러 recv에 걸친 메시지도 이어 붙음)
+OutputBuffer out_buffer;      // 보낼 메시지 (비차단 소켓이라 한 번에 못 보낸 나머지는 POLLOUT 때 전송)
+JsonArena json_arena;         // 받은 메시지 하나를 처리하는 동안의 JSON 트리 (메시지마다 리셋)
+int binary_requested = 0;     // -binary: register에서 바이너리 프레이밍을 요청
+int binary_mode = 0;          // 서버가 받아 줘서 register_ack 다음부터 바이너리 프레임
+int delta_requested = 0;      // -delta: 보드 전체 대신 델타를 요청 (board_delta.h)
+BoardView board_view;         // 델타를 따라가는 로컬 보드의 seq
 
 // 함수 선언
-void handle_server_message(char *buffer);
+void handle_server_message(char *buffer, size_t len);
 void send_register_message();
 void send_move_message(Move *move);
+void queue_message(JsonValue *json_obj);
+void flush_output();
 Move generate_smart_move();
 void cleanup_and_exit(int status);
 void sigint_handler(int sig);
@@ -57,16 +71,51 @@ void sigint_handler(int sig __attribute__((unused))) {
     cleanup_and_exit(0);
 }
 
-// 등록 메시지 전송
-void send_register_message() {
-    JsonValue *json_obj = createRegisterMessage(my_username);
-    char *json_str = json_stringify(json_obj);
-
-    send(client_socket, json_str, strlen(json_str), 0);
-    send(client_socket, "\n", 1, 0);
+// 송신 버퍼가 빌 때까지 보내 봄 (EAGAIN이면 나머지는 poll의 POLLOUT 때)
+void flush_output() {
+    if (output_buffer_flush(&out_buffer, client_socket) < 0) {
+        perror("[Client] 메시지 전송 오류");
+        cleanup_and_exit(1);
+    }
+}
 
+// JSON 메시지 + 개행을 송신 버퍼에 쌓고 바로 보내 봄
+void queue_message(JsonValue *json_obj) {
+    char *json_str = json_stringify(json_obj);
+    if (output_buffer_append(&out_buffer, json_str, strlen(json_str)) != 0 ||
+        output_buffer_append(&out_buffer, "\n", 1) != 0) {
+        fprintf(stderr, "[Client] 송신 버퍼 할당 실패\n");
+        cleanup_and_exit(1);
+    }
     free(json_str);
     json_free(json_obj);
+    flush_output();
+}
+
+// 바이너리 프레임 하나를 송신 버퍼에 쌓고 바로 보내 봄
+void queue_binary_move(const Move *move) {
+    unsigned char frame[16];
+    BinaryWriter writer;
+    binary_begin(&writer, frame, sizeof(frame), BINARY_MOVE);
+    binary_put_move(&writer, move);
+    size_t length = binary_end(&writer);
+    if (length == 0 || output_buffer_append(&out_buffer, (const char*)frame, length) != 0) {
+        fprintf(stderr, "[Client] 송신 버퍼 할당 실패\n");
+        cleanup_and_exit(1);
+    }
+    flush_output();
+}
+
+// 등록 메시지 전송 (-binary, -delta면 capabilities로 요청)
+void send_register_message() {
+    JsonValue *json_obj = createRegisterMessage(my_username);
+    if (binary_requested || delta_requested) {
+        JsonValue *capabilities = json_array();
+        if (binary_requested) json_array_append(capabilities, json_string("binary"));
+        if (delta_requested) json_array_append(capabilities, json_string("delta"));
+        json_object_set(json_obj, "capabilities", capabilities);
+    }
+    queue_message(json_obj);
 
     printf("[Client] Sent register: %s\n", my_username);
     client_state = CLIENT_REGISTERING;
@@ -76,14 +125,12 @@ void send_register_message() {
 void send_move_message(Move *move) {
     if (move->sourceRow == 0 && move->sourceCol == 0 && move->targetRow == 0 && move->targetCol == 0) {
         // Pass move (0,0,0,0) - send as is
-        JsonValue *json_obj = createMoveMessage(my_username, move);
-        char *json_str = json_stringify(json_obj);
-
-        send(client_socket, json_str, strlen(json_str), 0);
-        send(client_socket, "\n", 1, 0);
-
-        free(json_str);
-        json_free(json_obj);
+        if (binary_mode) {
+            queue_binary_move(move);
+        } else {
+            JsonValue *json_obj = createMoveMessage(my_username, move);
+            queue_message(json_obj);
+        }
         printf("[Client] move JSON sent for (0,0)->(0,0)\n");
         goto end;
     } else {
@@ -93,14 +140,12 @@ void send_move_message(Move *move) {
         converted.sourceCol += 1;
         converted.targetRow += 1;
         converted.targetCol += 1;
-        JsonValue *json_obj = createMoveMessage(my_username, &converted);
-        char *json_str = json_stringify(json_obj);
-
-        send(client_socket, json_str, strlen(json_str), 0);
-        send(client_socket, "\n", 1, 0);
-
-        free(json_str);
-        json_free(json_obj);
+        if (binary_mode) {
+            queue_binary_move(&converted);
+        } else {
+            JsonValue *json_obj = createMoveMessage(my_username, &converted);
+            queue_message(json_obj);
+        }
 
         // 0-based → 1-based로 콘솔 로그
         printf("[Client] move JSON sent for (%d,%d)->(%d,%d)\n",
@@ -148,37 +193,54 @@ int receive_message(char *buffer, int buffer_size) {
 }
 
 // 서버 메시지 처리 (pthread 제거됨)
-void handle_server_message(char *buffer) {
-    JsonValue *json_obj = json_parse(buffer);
-    if (!json_obj) {
-        fprintf(stderr, "유효하지 않은 JSON 메시지: %s\n", buffer);
-        return;
+void handle_server_message(char *buffer, size_t len) {
+    // 고정 형식 메시지는 트리 없이 바로 디코드하고, 빠른 경로가 못 다루는 입력만 JSON 트리로 파싱
+    // 트리와 처리 중에 만드는 응답 메시지는 아레나에 두고 끝나면 한 번에 리셋
+    DecodedMessage message;
+    JsonArena *previous_arena = json_use_arena(&json_arena);
+    if (binary_mode) {
+        if (!decodeBinaryMessage(buffer, len, &message)) {
+            fprintf(stderr, "유효하지 않은 바이너리 메시지 (%zu bytes)\n", len);
+            json_use_arena(previous_arena);
+            return;
+        }
+    } else if (!decodeMessage(buffer, &message)) {
+        JsonValue *json_obj = json_parse(buffer);
+        if (!json_obj) {
+            fprintf(stderr, "유효하지 않은 JSON 메시지: %s\n", buffer);
+            json_use_arena(previous_arena);
+            json_arena_reset(&json_arena);
+            return;
+        }
+        decodeMessageTree(json_obj, &message);
     }
     
-    MessageType msg_type = parseMessageType(json_obj);
-    
-    switch (msg_type) {
+    switch (message.type) {
         case MSG_REGISTER_ACK: {
             printf("등록 성공! 다른 플레이어를 기다립니다...\n");
             client_state = CLIENT_WAITING;
+            // 서버가 바이너리를 받아 주면 이 메시지 바로 다음 바이트부터 프레임 형식이 바뀜
+            if (binary_requested && !binary_mode && (message.fields & DECODED_CAPABILITIES) &&
+                (message.capabilities & CAPABILITY_BINARY)) {
+                binary_mode = 1;
+                framer_set_binary(&in_framer);
+                printf("[Client] 바이너리 프레이밍 사용\n");
+            }
             break;
         }
         
         case MSG_REGISTER_NACK: {
-            JsonValue *reason_json = json_object_get(json_obj, "reason");
-            const char *reason = (reason_json && json_is_string(reason_json))
-                                 ? json_string_value(reason_json)
-                                 : "unknown";
+            const char *reason = (message.fields & DECODED_REASON) ? message.reason : "unknown";
             printf("[Client] register_nack received. Reason: %s\n", reason);
             cleanup_and_exit(1);
             break;
         }
         
         case MSG_GAME_START: {
-            char players[2][64];
-            char first_player[64];
-            
-            if (parseGameStartMessage(json_obj, players, first_player)) {
+            if ((message.fields & (DECODED_PLAYERS | DECODED_FIRST_PLAYER)) ==
+                (DECODED_PLAYERS | DECODED_FIRST_PLAYER)) {
+                const char *const *players = message.players;
+                const char *first_player = message.first_player;
                 printf("게임 시작! 플레이어: %s vs %s\n", players[0], players[1]);
                 printf("첫 번째 플레이어: %s\n", first_player);
                 
@@ -200,8 +262,9 @@ void handle_server_message(char *buffer) {
                 
                 printf("내 색상: %c\n", my_color);
                 
-                // 보드 초기화
+                // 보드 초기화 (델타는 첫 스냅샷부터 따라감)
                 initializeBoard(&game_board);
+                board_view_reset(&board_view);
 
                 client_state = CLIENT_WAITING;
             }
@@ -210,6 +273,7 @@ void handle_server_message(char *buffer) {
         
         case MSG_INVALID_MOVE: {
             printf("[Client] Received invalid_move. Retrying...\n");
+            board_view_update(&board_view, &game_board, &message);   // 서버 보드로 다시 맞춤
  
             Move retry_move = generate_smart_move();
             printf("[Client] Retrying Move: (%d,%d)->(%d,%d)\n",
@@ -220,9 +284,8 @@ void handle_server_message(char *buffer) {
         }
         
         case MSG_YOUR_TURN: {
-            double timeout;
-
-            if (parseYourTurnMessage(json_obj, &game_board, &timeout)) {
+            if ((message.fields & DECODED_TIMEOUT) && board_view_update(&board_view, &game_board, &message)) {
+                double timeout = message.timeout;
                 printf("[Client] Your turn. Timeout: %.1f sec\n", timeout);
                 printf("[Client] Current board:\n");
                 printBoard(&game_board);
@@ -254,11 +317,10 @@ void handle_server_message(char *buffer) {
         }
         
         case MSG_MOVE_OK: {
-            // parseMoveResultMessage()로 board 정보, next_player 추출
-            GameBoard updated_board;
-            char nextPlayer[64];
-            if (parseMoveResultMessage(json_obj, &updated_board, nextPlayer)) {
-                memcpy(&game_board, &updated_board, sizeof(GameBoard)); // 로컬 보드 동기화
+            // board 정보, next_player (게임이 끝나면 null) 추출
+            if (message.fields & DECODED_NEXT_PLAYER) {
+                const char *nextPlayer = message.next_player ? message.next_player : "";
+                board_view_update(&board_view, &game_board, &message);   // 로컬 보드 동기화 (전체 또는 델타)
                 printf("[Client] Received move_ok. Board updated:\n");
                 printBoard(&game_board);
                 
@@ -272,20 +334,18 @@ void handle_server_message(char *buffer) {
         }
         
         case MSG_PASS: {
-            char nextPlayer[64];
-            // pass 메시지는 보드 정보가 없을 수 있음 → parseMoveResultMessage() 사용
-            GameBoard updated_board;
-            if (parseMoveResultMessage(json_obj, &updated_board, nextPlayer)) {
-                memcpy(&game_board, &updated_board, sizeof(GameBoard));
+            // pass 메시지는 보드 정보가 없을 수 있음
+            if ((message.fields & DECODED_NEXT_PLAYER) && (message.fields & DECODED_BOARD)) {
+                memcpy(&game_board, &message.board, sizeof(GameBoard));
             }
             printf("[Client] Opponent passed.\n");
             break;
         }
         
         case MSG_GAME_OVER: {
-            char players[2][64];
-            int scores[2];
-            if (parseGameOverMessage(json_obj, players, scores)) {
+            if (message.fields & DECODED_SCORES) {
+                const char *const *players = message.players;
+                const int *scores = message.scores;
                 printf("[Client] Game over. Scores: %s=%d, %s=%d\n",
                        players[0], scores[0], players[1], scores[1]);
                 if (strcmp(players[0], my_username) == 0 && scores[0] > scores[1]) {
@@ -309,7 +369,8 @@ void handle_server_message(char *buffer) {
             break;
     }
     
-    json_free(json_obj);
+    json_use_arena(previous_arena);
+    json_arena_reset(&json_arena);
 }
 
 // 메인 함수 (pthread 제거됨)
@@ -330,8 +391,12 @@ int main(int argc, char *argv[]) {
             strncpy(my_username, argv[i + 1], sizeof(my_username) - 1);
             my_username[sizeof(my_username) - 1] = '\0';
             i++;
+        } else if (strcmp(argv[i], "-binary") == 0) {
+            binary_requested = 1;
+        } else if (strcmp(argv[i], "-delta") == 0) {
+            delta_requested = 1;
         } else {
-            printf("사용법: %s -ip <IP주소> -port <포트> -username <사용자명>\n", argv[0]);
+            printf("사용법: %s -ip <IP주소> -port <포트> -username <사용자명> [-binary] [-delta]\n", argv[0]);
             return 1;
         }
     }
@@ -375,31 +440,53 @@ int main(int argc, char *argv[]) {
     }
     printf("서버에 연결되었습니다: %s:%d\n", ip_address, port);
 
+    // 연결 후에는 비차단으로 (보내기는 송신 버퍼 + POLLOUT, 받기는 POLLIN일 때만)
+    fcntl(client_socket, F_SETFL, fcntl(client_socket, F_GETFL, 0) | O_NONBLOCK);
+    output_buffer_init(&out_buffer);
+    json_arena_init(&json_arena, JSON_ARENA_CHUNK_SIZE);
+    if (framer_init(&in_framer, FRAMER_DEFAULT_MAX_FRAME) != 0) {
+        fprintf(stderr, "[Client] 수신 버퍼 할당 실패\n");
+        cleanup_and_exit(1);
+    }
+
     // 등록 메시지 전송
     send_register_message();
 
-    // 메인 루프 (poll 사용)
-    char buffer[BUFFER_SIZE];
+    // 메인 루프: 소켓 이벤트가 올 때까지 poll에서 잠들고, 오면 바로 처리
     struct pollfd fds[1];
     fds[0].fd = client_socket;
-    fds[0].events = POLLIN;
 
     while (client_state != CLIENT_GAME_OVER) {
-        int poll_result = poll(fds, 1, 100);
-        if (poll_result > 0 && (fds[0].revents & POLLIN)) {
-            int bytes_received = recv(client_socket, buffer, BUFFER_SIZE - 1, 0);
+        fds[0].events = POLLIN | (output_buffer_pending(&out_buffer) > 0 ? POLLOUT : 0);
+        int poll_result = poll(fds, 1, -1);
+        if (poll_result > 0 && (fds[0].revents & POLLOUT)) {
+            flush_output();
+        }
+        if (poll_result > 0 && (fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            size_t space;
+            char *dst = framer_write_space(&in_framer, &space);
+            int bytes_received = recv(client_socket, dst, space, 0);
             if (bytes_received > 0) {
-                buffer[bytes_received] = '\0';
-
-                // '\n' 단위로 분리하여 각 JSON 메시지를 처리
-                char *line = strtok(buffer, "\n");
-                while (line) {
-                    handle_server_message(line);
-                    line = strtok(NULL, "\n");
+                framer_commit(&in_framer, (size_t)bytes_received);
+
+                // 완성된 메시지(JSON 줄 또는 협상 뒤 바이너리 프레임)를 모두 처리 (덜 받은 메시지는 다음 recv에 이어짐)
+                char *line;
+                size_t len;
+                int result;
+                while ((result = framer_next(&in_framer, &line, &len)) != 0) {
+                    if (result < 0) {
+                        fprintf(stderr, "[Client] 너무 긴 메시지를 버렸습니다\n");
+                        // 바이너리 프레임은 길이를 잃으면 다시 맞출 수 없음
+                        if (binary_mode) cleanup_and_exit(1);
+                        continue;
+                    }
+                    if (len > 0) handle_server_message(line, len);
                 }
             } else if (bytes_received == 0) {
                 printf("[Client] 서버 연결이 종료되었습니다.\n");
                 break;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                // 읽을 것이 없음 (비차단)
             } else {
                 perror("[Client] 메시지 수신 오류");
                 break;
@@ -408,7 +495,6 @@ int main(int argc, char *argv[]) {
             perror("[Client] poll 오류");
             break;
         }
-        usleep(100000); // 100ms 대기
     }
 
     printf("[Client] 게임이 종료되었습니다.\n");
@@ -0,0 +1,120 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "fanout.h"
+
+#define FRAME_QUEUE_INITIAL 16
+#define FRAME_QUEUE_IOV 64          // sendmsg 한 번에 묶는 최대 프레임 수
+
+SharedFrame* shared_frame_create(FrameKind kind, int game_id, const char *data, size_t length) {
+    SharedFrame *frame = (SharedFrame*)malloc(sizeof(SharedFrame) + length);
+    if (!frame) return NULL;
+    frame->refcount = 0;
+    frame->kind = kind;
+    frame->game_id = game_id;
+    frame->length = length;
+    frame->next = NULL;
+    memcpy(frame->data, data, length);
+    return frame;
+}
+
+void shared_frame_retain(SharedFrame *frame) {
+    frame->refcount++;
+}
+
+void shared_frame_release(SharedFrame *frame) {
+    if (--frame->refcount <= 0) free(frame);
+}
+
+void frame_queue_init(FrameQueue *queue) {
+    memset(queue, 0, sizeof(FrameQueue));
+}
+
+void frame_queue_destroy(FrameQueue *queue) {
+    for (size_t i = 0; i < queue->count; i++) {
+        shared_frame_release(queue->frames[(queue->head + i) & (queue->capacity - 1)]);
+    }
+    free(queue->frames);
+    memset(queue, 0, sizeof(FrameQueue));
+}
+
+static int grow(FrameQueue *queue) {
+    size_t capacity = queue->capacity ? queue->capacity * 2 : FRAME_QUEUE_INITIAL;
+    SharedFrame **frames = (SharedFrame**)malloc(sizeof(SharedFrame*) * capacity);
+    if (!frames) return -1;
+    for (size_t i = 0; i < queue->count; i++) {
+        frames[i] = queue->frames[(queue->head + i) & (queue->capacity - 1)];
+    }
+    free(queue->frames);
+    queue->frames = frames;
+    queue->capacity = capacity;
+    queue->head = 0;
+    return 0;
+}
+
+int frame_queue_push(FrameQueue *queue, SharedFrame *frame) {
+    if (queue->count == queue->capacity && grow(queue) != 0) return -1;
+    queue->frames[(queue->head + queue->count) & (queue->capacity - 1)] = frame;
+    queue->count++;
+    shared_frame_retain(frame);
+    return 0;
+}
+
+void frame_queue_drop(FrameQueue *queue, FrameKind kind) {
+    size_t mask = queue->capacity - 1;
+    size_t kept = 0;
+    for (size_t i = 0; i < queue->count; i++) {
+        SharedFrame *frame = queue->frames[(queue->head + i) & mask];
+        if (frame->kind == kind && !(i == 0 && queue->offset > 0)) {
+            shared_frame_release(frame);
+            continue;
+        }
+        queue->frames[(queue->head + kept) & mask] = frame;
+        kept++;
+    }
+    queue->count = kept;
+}
+
+int frame_queue_flush(FrameQueue *queue, int fd) {
+    while (queue->count > 0) {
+        struct iovec iov[FRAME_QUEUE_IOV];
+        size_t n = (queue->count < FRAME_QUEUE_IOV) ? queue->count : FRAME_QUEUE_IOV;
+        for (size_t i = 0; i < n; i++) {
+            SharedFrame *frame = queue->frames[(queue->head + i) & (queue->capacity - 1)];
+            size_t skip = (i == 0) ? queue->offset : 0;
+            iov[i].iov_base = frame->data + skip;
+            iov[i].iov_len = frame->length - skip;
+        }
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n;
+
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+            return -1;
+        }
+
+        // 다 보낸 프레임은 참조를 내려놓고, 일부만 보낸 프레임은 offset으로 이어서
+        size_t remaining = (size_t)sent;
+        while (queue->count > 0) {
+            SharedFrame *frame = queue->frames[queue->head];
+            size_t left = frame->length - queue->offset;
+            if (remaining < left) {
+                queue->offset += remaining;
+                break;
+            }
+            remaining -= left;
+            queue->offset = 0;
+            queue->head = (queue->head + 1) & (queue->capacity - 1);
+            queue->count--;
+            shared_frame_release(frame);
+        }
+    }
+    return 0;
+}
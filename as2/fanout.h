@@ -0,0 +1,58 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 관전 스트림 팬아웃.
+// 이벤트 하나를 한 번만 직렬화해 SharedFrame에 담고, 구독자마다 복사 대신 참조만 큐에 넣는다.
+// 큐는 sendmsg 한 번에 여러 프레임을 iovec으로 묶어 보내고, 다 보낸 프레임의 참조를 내려놓는다.
+// 참조 수는 관전 리액터 스레드만 바꾸므로 원자 연산이 필요 없다 (게임 샤드는 만들어서 넘기기만 함).
+
+typedef enum {
+    FRAME_WATCH_START,        // watch_start: 대국 시작
+    FRAME_WATCH_MOVE,         // watch_move: 수 하나 (보드 전체 포함, 그 자체로 최신 상태)
+    FRAME_WATCH_END           // watch_end: 대국 종료
+} FrameKind;
+
+typedef struct SharedFrame {
+    int refcount;
+    FrameKind kind;
+    int game_id;
+    size_t length;
+    struct SharedFrame *next;   // 샤드 → 관전 리액터 메일박스 연결
+    char data[];                // JSON 한 줄 ('\n' 포함)
+} SharedFrame;
+
+// 참조 수 0으로 만듦 (처음 붙잡는 쪽이 shared_frame_retain)
+SharedFrame* shared_frame_create(FrameKind kind, int game_id, const char *data, size_t length);
+void shared_frame_retain(SharedFrame *frame);
+void shared_frame_release(SharedFrame *frame);     // 0이 되면 해제
+
+// 구독자 하나의 송신 대기열 (프레임 참조의 원형 큐)
+typedef struct {
+    SharedFrame **frames;
+    size_t capacity;          // 항상 2의 거듭제곱
+    size_t head;
+    size_t count;
+    size_t offset;            // 맨 앞 프레임에서 이미 보낸 바이트 수
+} FrameQueue;
+
+void frame_queue_init(FrameQueue *queue);
+void frame_queue_destroy(FrameQueue *queue);       // 남은 참조를 모두 내려놓음
+
+// 끝에 참조 추가 (retain 포함). 실패 시 -1
+int frame_queue_push(FrameQueue *queue, SharedFrame *frame);
+
+// kind 프레임을 모두 빼냄 (보내기 시작한 맨 앞 프레임은 남김). 밀린 구독자를 최신 상태로 다시 맞출 때
+// 중간 수만 버리고 시작/종료는 순서대로 남기기 위함
+void frame_queue_drop(FrameQueue *queue, FrameKind kind);
+
+// 소켓이 받아 주는 만큼 보냄. 0: 모두 보냄, 1: 남음(EAGAIN), -1: 연결 오류
+int frame_queue_flush(FrameQueue *queue, int fd);
+
+static inline size_t frame_queue_pending(const FrameQueue *queue) {
+    return queue->count;
+}
+
+#endif /* FANOUT_H */
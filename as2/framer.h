@@ -0,0 +1,56 @@
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <stddef.h>
+
+// 개행('\n')으로 구분된 메시지를 잘라 주는 수신 링 버퍼 (서버/클라이언트 공용).
+// recv는 링의 빈 공간에 바로 받고, 줄 찾기는 memchr로 지난번에 멈춘 곳부터 이어서 한다.
+// 앞으로 당기는 memmove가 없고, 링 끝에서 돌아 나온 줄만 꼬리 여유 공간에 이어 붙여 연속으로 만든다.
+// max_frame보다 긴 줄은 다음 개행까지 버리고 오류로 한 번 알린다.
+// 바이너리 모드(framer_set_binary)에서는 [길이 2바이트, 빅엔디언][본문] 프레임 단위로 자른다.
+// 이때는 다시 맞출 구분자가 없으므로 max_frame을 넘는 길이가 오면 -1을 돌려주고 연결을 끊어야 한다.
+
+#define FRAMER_DEFAULT_MAX_FRAME 2048
+
+typedef struct {
+    char *data;               // capacity + max_frame + 1 (돌아 나온 줄을 이어 붙일 꼬리 공간)
+    size_t capacity;          // 2의 거듭제곱, max_frame의 두 배 이상
+    size_t max_frame;
+    size_t head;              // 아직 꺼내지 않은 첫 바이트
+    size_t length;            // 쌓여 있는 바이트 수
+    size_t scanned;           // head부터 개행이 없다고 확인한 바이트 수
+    size_t reserved;          // 마지막으로 꺼낸 줄 (head 바로 앞). 다음 framer_next 전까지 덮어쓰지 않음
+    int discarding;           // 너무 긴 줄을 버리는 중
+    int binary;               // 길이 접두 프레임 모드
+} LineFramer;
+
+// 실패 시 -1
+int framer_init(LineFramer *framer, size_t max_frame);
+void framer_destroy(LineFramer *framer);
+
+// recv로 바로 채울 수 있는 연속된 빈 공간. 링이 가득 차 있으면 *space는 0
+char* framer_write_space(LineFramer *framer, size_t *space);
+
+// framer_write_space로 받은 바이트 수 반영
+void framer_commit(LineFramer *framer, size_t len);
+
+// 복사해서 넣기 (공간이 모자라면 넣은 만큼 반환)
+size_t framer_append(LineFramer *framer, const char *data, size_t len);
+
+// 남은 입력부터 길이 접두 프레임으로 자름 (JSON 줄로 협상을 마친 직후 호출)
+void framer_set_binary(LineFramer *framer);
+
+// 다음 완성된 줄. 1: *line에 '\0'으로 끝나는 줄(개행 제외), 0: 아직 없음, -1: 너무 긴 줄을 버림.
+// *line은 다음 framer_next 호출 전까지 유효하다 (그 사이 framer_write_space로 받아도 덮어쓰지 않음).
+// 바이너리 모드에서는 *line이 길이 헤더 다음의 본문이고 '\0'으로 끝나지 않는다.
+int framer_next(LineFramer *framer, char **line, size_t *len);
+
+// framer_next가 돌려줄 것이 있는지: 완성된 줄, 또는 -1로 알릴 너무 긴 줄/프레임
+// (꺼내지는 않음, 확인한 곳까지는 다시 찾지 않음)
+int framer_has_frame(LineFramer *framer);
+
+static inline size_t framer_pending(const LineFramer *framer) {
+    return framer->length;
+}
+
+#endif /* FRAMER_H */
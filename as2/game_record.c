@@ -0,0 +1,273 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "game_record.h"
+#include "record_reader.h"
+
+#define BOARD_SQUARES 8
+
+static uint8_t square(int row, int col) {
+    if (row < 1 || row > BOARD_SQUARES || col < 1 || col > BOARD_SQUARES) return RECORD_NO_SQUARE;
+    return (uint8_t)((row - 1) * BOARD_SQUARES + (col - 1));
+}
+
+int record_events_add(RecordEvents *list, RecordEventKind kind, int seat,
+                      int source_row, int source_col, int target_row, int target_col, uint64_t think_ns) {
+    if (list->count >= RECORD_MAX_EVENTS) return -1;
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        RecordEvent *events = (RecordEvent*)realloc(list->events, sizeof(RecordEvent) * capacity);
+        if (!events) return -1;
+        list->events = events;
+        list->capacity = capacity;
+    }
+    RecordEvent *event = &list->events[list->count++];
+    event->kind = (uint8_t)kind;
+    event->seat = (uint8_t)seat;
+    event->from = square(source_row, source_col);
+    event->to = square(target_row, target_col);
+    uint64_t think_us = think_ns / 1000;
+    event->think_us = (think_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)think_us;
+    return 0;
+}
+
+void record_events_free(RecordEvents *list) {
+    free(list->events);
+    memset(list, 0, sizeof(RecordEvents));
+}
+
+static size_t name_length(const char *name) {
+    size_t length = strlen(name);
+    return (length > 255) ? 255 : length;
+}
+
+size_t record_size(const RecordInfo *info, size_t event_count) {
+    return RECORD_FIXED_SIZE + name_length(info->players[0]) + 1 + name_length(info->players[1]) + 1 +
+           event_count * RECORD_EVENT_SIZE + 4;
+}
+
+static unsigned char* put_u16(unsigned char *p, unsigned int value) {
+    p[0] = (unsigned char)(value >> 8);
+    p[1] = (unsigned char)value;
+    return p + 2;
+}
+
+static unsigned char* put_u32(unsigned char *p, uint32_t value) {
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+    return p + 4;
+}
+
+uint32_t record_checksum(const unsigned char *data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void record_encode(unsigned char *out, const RecordInfo *info, const RecordEvents *events) {
+    size_t size = record_size(info, events->count);
+    unsigned char *p = out;
+    p = put_u32(p, (uint32_t)size);
+    p = put_u32(p, info->game_id);
+    p = put_u32(p, (uint32_t)(info->start_ms >> 32));
+    p = put_u32(p, (uint32_t)info->start_ms);
+    p = put_u32(p, info->duration_ms);
+    p = put_u32(p, info->base_ms);
+    p = put_u32(p, info->increment_ms);
+    p = put_u32(p, info->move_limit_ms);
+    p = put_u16(p, (unsigned int)events->count);
+    *p++ = info->result;
+    *p++ = info->scores[0];
+    *p++ = info->scores[1];
+    for (int i = 0; i < 2; i++) *p++ = (unsigned char)name_length(info->players[i]);
+    *p++ = 0;
+    for (int i = 0; i < 2; i++) {
+        size_t length = name_length(info->players[i]);
+        memcpy(p, info->players[i], length);
+        p += length;
+        *p++ = '\0';
+    }
+    for (size_t i = 0; i < events->count; i++) {
+        const RecordEvent *event = &events->events[i];
+        *p++ = (unsigned char)(event->kind | (event->seat << 7));
+        *p++ = event->from;
+        *p++ = event->to;
+        *p++ = 0;
+        p = put_u32(p, event->think_us);
+    }
+    put_u32(p, record_checksum(out, size - 4));
+}
+
+// ---- 쓰기 ----
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static int write_all(int fd, const unsigned char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+// 쓰기 스레드: 버퍼를 통째로 바꿔 들고 나와 락 밖에서 쓴다 (샤드는 그동안 새 버퍼에 쌓음)
+static void *record_log_main(void *arg) {
+    RecordLog *log = (RecordLog*)arg;
+    unsigned char *spare = NULL;
+    size_t spare_capacity = 0;
+    uint64_t last_sync = monotonic_ms();
+    int dirty = 0;          // 쓰고 아직 fsync하지 않은 데이터 있음
+
+    pthread_mutex_lock(&log->lock);
+    while (1) {
+        if (!log->stop && log->length < RECORD_FLUSH_THRESHOLD) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)RECORD_FLUSH_INTERVAL_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&log->wake, &log->lock, &deadline);
+        }
+        int stop = log->stop;
+        unsigned char *data = log->buffer;
+        size_t length = log->length;
+        size_t data_capacity = log->capacity;
+        log->buffer = spare;
+        log->capacity = spare_capacity;
+        log->length = 0;
+        pthread_mutex_unlock(&log->lock);
+
+        if (length > 0) {
+            if (write_all(log->fd, data, length) != 0) perror("[Record] write");
+            dirty = 1;
+        }
+        uint64_t now = monotonic_ms();
+        if (dirty && (stop || now - last_sync >= RECORD_FSYNC_INTERVAL_MS)) {
+            if (fdatasync(log->fd) != 0) perror("[Record] fdatasync");
+            last_sync = now;
+            dirty = 0;
+        }
+        spare = data;
+        spare_capacity = data_capacity;
+
+        pthread_mutex_lock(&log->lock);
+        if (stop && log->length == 0) break;
+    }
+    pthread_mutex_unlock(&log->lock);
+    free(spare);
+    return NULL;
+}
+
+// 기존 파일의 헤더를 확인하고 마지막 온전한 레코드 뒤를 잘라냄. 빈 파일이면 헤더를 씀
+static int prepare_file(int fd, const char *path) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (st.st_size == 0) {
+        unsigned char header[RECORD_FILE_HEADER_SIZE] = { 0 };
+        memcpy(header, RECORD_FILE_MAGIC, 8);
+        put_u16(header + 8, RECORD_FILE_VERSION);
+        put_u16(header + 10, RECORD_FILE_HEADER_SIZE);
+        return write_all(fd, header, sizeof(header));
+    }
+
+    RecordFile file;
+    if (record_file_open(&file, path) != 0) {
+        fprintf(stderr, "[Record] %s is not a game record file\n", path);
+        return -1;
+    }
+    RecordView record;
+    size_t games = 0;
+    while (record_file_next(&file, &record) == 1) games++;
+    size_t valid = file.offset;
+    size_t size = file.size;
+    record_file_close(&file);
+    if (valid < size) {
+        fprintf(stderr, "[Record] %s: dropping %zu bytes of incomplete record after %zu games\n",
+                path, size - valid, games);
+        if (ftruncate(fd, (off_t)valid) != 0) return -1;
+    }
+    return 0;
+}
+
+int record_log_open(RecordLog *log, const char *path) {
+    memset(log, 0, sizeof(RecordLog));
+    log->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (log->fd < 0) {
+        perror("[Record] open");
+        return -1;
+    }
+    if (prepare_file(log->fd, path) != 0) {
+        close(log->fd);
+        log->fd = -1;
+        return -1;
+    }
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->wake, NULL);
+    if (pthread_create(&log->thread, NULL, record_log_main, log) != 0) {
+        close(log->fd);
+        log->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int record_log_append(RecordLog *log, const RecordInfo *info, const RecordEvents *events) {
+    size_t size = record_size(info, events->count);
+    pthread_mutex_lock(&log->lock);
+    log->records++;
+    if (log->length + size > RECORD_MAX_PENDING) {
+        log->dropped++;
+        pthread_mutex_unlock(&log->lock);
+        return -1;
+    }
+    if (log->length + size > log->capacity) {
+        size_t capacity = log->capacity ? log->capacity : 64 * 1024;
+        while (capacity < log->length + size) capacity *= 2;
+        unsigned char *buffer = (unsigned char*)realloc(log->buffer, capacity);
+        if (!buffer) {
+            log->dropped++;
+            pthread_mutex_unlock(&log->lock);
+            return -1;
+        }
+        log->buffer = buffer;
+        log->capacity = capacity;
+    }
+    record_encode(log->buffer + log->length, info, events);
+    log->length += size;
+    // 주기를 기다리지 않고 쓰게 할 때만 깨움 (보통은 쓰기 스레드가 주기마다 알아서 가져감)
+    if (log->length >= RECORD_FLUSH_THRESHOLD) pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    return 0;
+}
+
+void record_log_close(RecordLog *log) {
+    if (log->fd < 0) return;
+    pthread_mutex_lock(&log->lock);
+    log->stop = 1;
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->thread, NULL);
+    close(log->fd);
+    log->fd = -1;
+    free(log->buffer);
+    log->buffer = NULL;
+}
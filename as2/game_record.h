@@ -0,0 +1,122 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// 대국 기록 파일 (추가 전용 바이너리). 서버는 대국이 끝날 때마다 레코드 하나를 붙이고,
+// 읽는 쪽은 record_reader.h로 파일을 mmap해 훑는다. 정수는 msg_binary와 같이 빅 엔디언.
+//
+// 파일 헤더 (16바이트)
+//   "OFRECORD"  u16 version  u16 header_size  u32 reserved
+// 레코드
+//   u32 length            레코드 전체 길이 (이 필드와 끝의 checksum 포함)
+//   u32 game_id
+//   u64 start_ms          대국 시작 시각 (유닉스 밀리초)
+//   u32 duration_ms
+//   u32 base_ms  u32 increment_ms  u32 move_limit_ms    시간 규칙 (game_session.h의 TimeControl)
+//   u16 event_count
+//   u8  result            RECORD_RESULT_*
+//   u8  score[2]          R, B 말 개수
+//   u8  name_length[2]
+//   u8  reserved
+//   char name[2][]        이름 + '\0' (읽는 쪽이 그대로 C 문자열로 씀)
+//   event[event_count]    8바이트씩 (아래)
+//   u32 checksum          length부터 event 끝까지의 FNV-1a (쓰다 끊긴 꼬리를 가려냄)
+// 이벤트
+//   u8 kind | seat << 7   u8 from  u8 to  (칸 번호 = 행*8+열, 0부터. 패스 등은 RECORD_NO_SQUARE)
+//   u8 reserved           u32 think_us (그 턴이 시작된 뒤 걸린 시간)
+
+#define RECORD_FILE_MAGIC "OFRECORD"
+#define RECORD_FILE_VERSION 1
+#define RECORD_FILE_HEADER_SIZE 16
+#define RECORD_FIXED_SIZE 40          // 이름 앞까지
+#define RECORD_EVENT_SIZE 8
+#define RECORD_NO_SQUARE 0xFF
+#define RECORD_MAX_EVENTS 0xFFFF
+
+typedef enum {
+    RECORD_MOVE = 0,      // 합법적인 수 (보드에 적용됨)
+    RECORD_PASS,          // 둘 곳이 없어 패스
+    RECORD_TIMEOUT,       // 시간 초과로 패스 처리
+    RECORD_INVALID,       // 규칙에 맞지 않는 수 (보드는 그대로, 턴은 넘어감)
+    RECORD_LEFT           // 연결 끊김 (그 플레이어 차례였다면 상대에게 넘어감)
+} RecordEventKind;
+
+typedef enum {
+    RECORD_RESULT_GAME_OVER = 0,
+    RECORD_RESULT_ABANDONED       // 두 플레이어 모두 나감
+} RecordResult;
+
+typedef struct {
+    uint8_t kind;                 // RecordEventKind
+    uint8_t seat;                 // 0: R, 1: B
+    uint8_t from;
+    uint8_t to;
+    uint32_t think_us;
+} RecordEvent;
+
+// 대국 하나의 이벤트 목록 (세션이 진행되는 동안 샤드 스레드에서만 쌓음)
+typedef struct {
+    RecordEvent *events;
+    size_t count;
+    size_t capacity;
+} RecordEvents;
+
+// 좌표는 1부터 시작하는 클라이언트 좌표 (범위를 벗어나면 RECORD_NO_SQUARE로 기록)
+int record_events_add(RecordEvents *list, RecordEventKind kind, int seat,
+                      int source_row, int source_col, int target_row, int target_col, uint64_t think_ns);
+void record_events_free(RecordEvents *list);
+
+// 레코드 헤더에 들어가는 대국 정보
+typedef struct {
+    uint32_t game_id;
+    uint64_t start_ms;
+    uint32_t duration_ms;
+    uint32_t base_ms;
+    uint32_t increment_ms;
+    uint32_t move_limit_ms;
+    uint8_t result;
+    uint8_t scores[2];
+    const char *players[2];
+} RecordInfo;
+
+// 레코드 하나의 바이트 수 / 직렬화 (out에 record_size만큼 씀)
+size_t record_size(const RecordInfo *info, size_t event_count);
+void record_encode(unsigned char *out, const RecordInfo *info, const RecordEvents *events);
+
+uint32_t record_checksum(const unsigned char *data, size_t length);
+
+// 기록 파일 쓰기. 샤드는 레코드를 메모리 버퍼에 복사만 하고(락은 그동안만),
+// 쓰기 스레드가 모아서 write하고 fsync는 RECORD_FSYNC_INTERVAL_MS마다 한 번만 한다.
+// 서버가 죽으면 마지막 fsync 이후의 대국은 잃을 수 있다 (끊긴 꼬리는 다음에 열 때 잘라냄).
+#define RECORD_FLUSH_INTERVAL_MS 200
+#define RECORD_FSYNC_INTERVAL_MS 1000
+#define RECORD_FLUSH_THRESHOLD (256 * 1024)      // 이만큼 쌓이면 주기를 기다리지 않고 씀
+#define RECORD_MAX_PENDING (64 * 1024 * 1024)    // 디스크가 못 따라가면 이 이상은 버림 (대국은 막지 않음)
+
+typedef struct {
+    int fd;
+    pthread_t thread;
+    pthread_mutex_t lock;         // 아래 버퍼와 stop만 보호
+    pthread_cond_t wake;
+    unsigned char *buffer;        // 아직 쓰지 않은 레코드
+    size_t length;
+    size_t capacity;
+    int stop;
+    uint64_t records;             // 받은 레코드 수
+    uint64_t dropped;             // RECORD_MAX_PENDING 초과로 버린 레코드 수
+} RecordLog;
+
+// 파일을 열어 쓰기 스레드 시작. 없으면 만들고, 끝이 깨져 있으면 마지막 온전한 레코드까지 잘라낸다.
+// 실패 시 -1 (형식이 다른 파일이면 건드리지 않음)
+int record_log_open(RecordLog *log, const char *path);
+
+// 레코드 하나 추가 (어느 스레드에서나). 버퍼가 넘치면 버리고 -1
+int record_log_append(RecordLog *log, const RecordInfo *info, const RecordEvents *events);
+
+// 남은 레코드를 쓰고 fsync한 뒤 스레드 종료
+void record_log_close(RecordLog *log);
+
+#endif /* GAME_RECORD_H */
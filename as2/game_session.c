@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <string.h>
+#include "game_session.h"
+
+// 여러 샤드가 동시에 세션을 만들 수 있으므로 원자적으로 증가
+static int next_session_id = 1;
+
+GameSession* session_create(Client *red, const char *red_name, Client *blue, const char *blue_name,
+                            const TimeControl *time_control) {
+    GameSession *session = (GameSession*)calloc(1, sizeof(GameSession));
+    if (!session) return NULL;
+
+    session->id = __atomic_fetch_add(&next_session_id, 1, __ATOMIC_RELAXED);
+    session->state = SESSION_IN_PROGRESS;
+    initializeBoard(&session->board);
+    session->players[0] = red;
+    session->players[1] = blue;
+    strncpy(session->usernames[0], red_name, sizeof(session->usernames[0]) - 1);
+    strncpy(session->usernames[1], blue_name, sizeof(session->usernames[1]) - 1);
+    session->current = 0;
+    session->time_control = *time_control;
+    for (int i = 0; i < SESSION_PLAYERS; i++) {
+        session->clock_ns[i] = time_control->base_ns;
+    }
+    timer_init(&session->turn_timer, NULL, session);
+    return session;
+}
+
+void session_table_init(SessionTable *table) {
+    table->head = NULL;
+    table->count = 0;
+}
+
+void session_table_add(SessionTable *table, GameSession *session) {
+    session->prev = NULL;
+    session->next = table->head;
+    if (table->head) table->head->prev = session;
+    table->head = session;
+    table->count++;
+}
+
+void session_destroy(SessionTable *table, GameSession *session) {
+    if (!session) return;
+    if (session->prev) session->prev->next = session->next;
+    else table->head = session->next;
+    if (session->next) session->next->prev = session->prev;
+    table->count--;
+    record_events_free(&session->record);
+    free(session);
+}
+
+uint64_t session_turn_budget(const GameSession *session) {
+    const TimeControl *tc = &session->time_control;
+    if (tc->base_ns == 0) return tc->move_limit_ns;
+    uint64_t remaining = session->clock_ns[session->current];
+    if (tc->move_limit_ns > 0 && tc->move_limit_ns < remaining) return tc->move_limit_ns;
+    return remaining;
+}
+
+uint64_t session_start_clock(GameSession *session, uint64_t now) {
+    session->turn_start_ns = now;
+    return now + session_turn_budget(session);
+}
+
+void session_stop_clock(GameSession *session, uint64_t now, int add_increment) {
+    if (session->turn_start_ns == 0) return;
+    const TimeControl *tc = &session->time_control;
+    uint64_t elapsed = (now > session->turn_start_ns) ? now - session->turn_start_ns : 0;
+    session->turn_start_ns = 0;
+    if (tc->base_ns == 0) return;
+
+    uint64_t *clock = &session->clock_ns[session->current];
+    *clock = (elapsed < *clock) ? *clock - elapsed : 0;
+    if (add_increment) *clock += tc->increment_ns;
+}
+
+char session_color(int seat) {
+    return (seat == 0) ? RED_PLAYER : BLUE_PLAYER;
+}
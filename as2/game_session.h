@@ -0,0 +1,79 @@
+#ifndef GAME_SESSION_H
+#define GAME_SESSION_H
+
+#include <stdint.h>
+#include "octaflip.h"
+#include "timer_queue.h"
+#include "game_record.h"
+
+#define SESSION_PLAYERS 2
+
+// 연결 구조체는 server.c에 정의 (세션은 포인터만 보관)
+typedef struct Client Client;
+
+// 대국 시간 규칙. 세션마다 복사해 두므로 게임별로 달라질 수 있다.
+// base_ns가 0이면 예전처럼 수마다 move_limit_ns만 주어진다.
+// base_ns가 있으면 플레이어별 남은 시간(피셔 방식: 수를 둘 때마다 increment_ns 추가)에서 차감하며,
+// 한 수에 쓸 수 있는 시간은 min(남은 시간, move_limit_ns)이다 (move_limit_ns 0이면 남은 시간 전부).
+typedef struct {
+    uint64_t base_ns;
+    uint64_t increment_ns;
+    uint64_t move_limit_ns;
+} TimeControl;
+
+typedef enum {
+    SESSION_IN_PROGRESS,
+    SESSION_OVER
+} SessionState;
+
+// 게임 한 판의 상태. 서버는 여러 세션을 동시에 진행한다.
+typedef struct GameSession {
+    int id;
+    SessionState state;
+    GameBoard board;
+    uint32_t board_seq;                        // 적용된 수의 개수 (보드 델타의 seq)
+    Move last_move;                            // 마지막으로 적용된 수 (1부터 시작하는 좌표)
+    uint64_t last_flipped;                     // 그 수로 뒤집힌 칸
+    Client *players[SESSION_PLAYERS];          // 0: RED(선공), 1: BLUE. 나가면 NULL
+    char usernames[SESSION_PLAYERS][64];       // 나간 뒤에도 game_over에 쓰기 위해 보관
+    int current;                               // 현재 차례 플레이어 인덱스
+    TimeControl time_control;
+    uint64_t clock_ns[SESSION_PLAYERS];        // 플레이어별 남은 시간 (base_ns가 0이면 사용 안 함)
+    uint64_t turn_start_ns;                    // 현재 턴 시작 시각 (monotonic_ns), 시계가 멈춰 있으면 0
+    Timer turn_timer;                          // 턴 마감 (소유 샤드의 TimerQueue에 등록)
+    uint64_t start_ms;                         // 대국 시작 (유닉스 밀리초, 기록 파일용)
+    uint64_t start_ns;                         // 대국 시작 (monotonic_ns)
+    RecordEvents record;                       // 기록 파일에 남길 수 (기록을 켰을 때만 쌓음)
+    struct GameSession *prev;
+    struct GameSession *next;                  // 세션 목록 또는 샤드 메일박스 연결
+} GameSession;
+
+// 한 샤드(리액터 스레드)가 진행 중인 세션 목록. 소유 스레드만 접근한다.
+typedef struct {
+    GameSession *head;
+    int count;
+} SessionTable;
+
+// 새 세션 생성 (보드 초기화 포함, 아직 어느 목록에도 없음). id는 서버 전체에서 유일
+GameSession* session_create(Client *red, const char *red_name, Client *blue, const char *blue_name,
+                            const TimeControl *time_control);
+
+void session_table_init(SessionTable *table);
+void session_table_add(SessionTable *table, GameSession *session);
+
+// 목록에서 제거 후 해제 (turn_timer는 호출 전에 취소해 둘 것)
+void session_destroy(SessionTable *table, GameSession *session);
+
+// 현재 차례 플레이어의 시계를 now부터 돌리고 이번 턴 마감 시각을 반환
+uint64_t session_start_clock(GameSession *session, uint64_t now);
+
+// 이번 턴에 쓸 수 있는 시간 (나노초). 남은 시간을 다 썼으면 0
+uint64_t session_turn_budget(const GameSession *session);
+
+// 현재 차례 시계를 멈추고 쓴 시간만큼 차감. 수를 뒀으면 증가분 추가. 이미 멈춰 있으면 아무것도 안 함
+void session_stop_clock(GameSession *session, uint64_t now, int add_increment);
+
+// 플레이어 인덱스의 색 (0: R, 1: B)
+char session_color(int seat);
+
+#endif /* GAME_SESSION_H */
@@ -0,0 +1,107 @@
+#include <stdlib.h>
+#include "hash_map.h"
+
+// fd처럼 연속된 정수 키도 고르게 퍼지도록 섞는다 (splitmix64)
+static size_t hash_slot(const HashMap *map, uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return (size_t)key & (map->capacity - 1);
+}
+
+int hash_map_init(HashMap *map, size_t initial_capacity) {
+    size_t capacity = 16;
+    while (capacity < initial_capacity) capacity <<= 1;
+    map->entries = (HashMapEntry*)calloc(capacity, sizeof(HashMapEntry));
+    map->capacity = map->entries ? capacity : 0;
+    map->count = 0;
+    return map->entries ? 0 : -1;
+}
+
+void hash_map_destroy(HashMap *map) {
+    free(map->entries);
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+void* hash_map_get(const HashMap *map, uint64_t key) {
+    if (map->capacity == 0) return NULL;
+    size_t slot = hash_slot(map, key);
+    while (map->entries[slot].value) {
+        if (map->entries[slot].key == key) return map->entries[slot].value;
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+    return NULL;
+}
+
+static int hash_map_grow(HashMap *map) {
+    HashMap bigger;
+    if (hash_map_init(&bigger, map->capacity * 2) != 0) return -1;
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->entries[i].value) {
+            hash_map_put(&bigger, map->entries[i].key, map->entries[i].value);
+        }
+    }
+    free(map->entries);
+    *map = bigger;
+    return 0;
+}
+
+int hash_map_put(HashMap *map, uint64_t key, void *value) {
+    if (!value) return -1;
+    // 적재율 3/4를 넘으면 두 배로
+    if ((map->count + 1) * 4 > map->capacity * 3 && hash_map_grow(map) != 0) return -1;
+
+    size_t slot = hash_slot(map, key);
+    while (map->entries[slot].value) {
+        if (map->entries[slot].key == key) {
+            map->entries[slot].value = value;
+            return 0;
+        }
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+    map->entries[slot].key = key;
+    map->entries[slot].value = value;
+    map->count++;
+    return 0;
+}
+
+void* hash_map_remove(HashMap *map, uint64_t key) {
+    if (map->capacity == 0) return NULL;
+    size_t mask = map->capacity - 1;
+    size_t slot = hash_slot(map, key);
+    while (map->entries[slot].value && map->entries[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+    void *value = map->entries[slot].value;
+    if (!value) return NULL;
+
+    // 삭제 표시 대신 뒤따르는 항목을 당겨 탐사 사슬을 유지 (backward shift)
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (map->entries[next].value) {
+        size_t home = hash_slot(map, map->entries[next].key);
+        // home이 (hole, next] 구간 밖이면 hole로 옮길 수 있다
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->entries[hole] = map->entries[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    map->entries[hole].value = NULL;
+    map->entries[hole].key = 0;
+    map->count--;
+    return value;
+}
+
+uint64_t hash_string(const char *str) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    while (*str) {
+        hash ^= (unsigned char)*str++;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,35 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 64비트 키 → 포인터 해시 맵 (개방 주소법, 선형 탐사).
+// 서버에서 fd → 연결, 사용자 이름 해시 → 연결 조회에 사용한다. value로 NULL은 넣을 수 없다.
+
+typedef struct {
+    uint64_t key;
+    void *value;              // NULL이면 빈 칸
+} HashMapEntry;
+
+typedef struct {
+    HashMapEntry *entries;
+    size_t capacity;          // 항상 2의 거듭제곱
+    size_t count;
+} HashMap;
+
+int hash_map_init(HashMap *map, size_t initial_capacity);
+void hash_map_destroy(HashMap *map);
+
+void* hash_map_get(const HashMap *map, uint64_t key);
+
+// 삽입 또는 교체. 실패 시 -1
+int hash_map_put(HashMap *map, uint64_t key, void *value);
+
+// 제거 후 이전 값 반환 (없으면 NULL)
+void* hash_map_remove(HashMap *map, uint64_t key);
+
+// 문자열 키용 64비트 해시 (FNV-1a)
+uint64_t hash_string(const char *str);
+
+#endif /* HASH_MAP_H */
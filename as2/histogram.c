@@ -0,0 +1,58 @@
+#include <string.h>
+#include "histogram.h"
+
+void histogram_init(Histogram *histogram) {
+    memset(histogram, 0, sizeof(Histogram));
+}
+
+int histogram_bucket(uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) return (int)value;
+    int top = 63 - __builtin_clzll(value);
+    if (top >= HISTOGRAM_MAX_BITS) return HISTOGRAM_BUCKETS - 1;
+    int shift = top - HISTOGRAM_SUB_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + (int)(value >> shift) - HISTOGRAM_SUB_BUCKETS;
+}
+
+uint64_t histogram_bucket_upper(int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) return (uint64_t)index;
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t mantissa = (uint64_t)(index % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void histogram_record(Histogram *histogram, uint64_t value) {
+    __atomic_add_fetch(&histogram->counts[histogram_bucket(value)], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->total, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->sum, value, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&histogram->max, &max, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void histogram_merge(Histogram *into, const Histogram *from) {
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into->counts[i] += __atomic_load_n(&from->counts[i], __ATOMIC_RELAXED);
+    }
+    into->total += __atomic_load_n(&from->total, __ATOMIC_RELAXED);
+    into->sum += __atomic_load_n(&from->sum, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&from->max, __ATOMIC_RELAXED);
+    if (max > into->max) into->max = max;
+}
+
+uint64_t histogram_percentile(const Histogram *histogram, double percentile) {
+    if (histogram->total == 0) return 0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->total) rank = histogram->total;
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            // 칸 상한이 실제 최댓값보다 크면 최댓값으로 (p100이 max와 같게)
+            uint64_t upper = histogram_bucket_upper(i);
+            return (upper > histogram->max) ? histogram->max : upper;
+        }
+    }
+    return histogram->max;
+}
@@ -0,0 +1,39 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// HDR 방식 지연 시간 히스토그램 (값은 나노초 같은 부호 없는 정수).
+// 2의 거듭제곱 구간마다 HISTOGRAM_SUB_BUCKETS칸으로 나누므로 상대 오차가 약 3% 이내이고,
+// 칸 번호는 최상위 비트 위치와 그 아래 몇 비트로 바로 구한다 (탐색 없음).
+// 기록은 칸 카운터에 대한 원자적 덧셈뿐이라 락 없이 여러 스레드가 같은 히스토그램에 쌓을 수 있고,
+// 읽는 쪽은 histogram_merge로 스냅샷을 떠서 백분위를 계산한다.
+
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BITS 40                 // 2^40 이상(나노초로 약 18분)은 마지막 칸에 모음
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t max;
+} Histogram;
+
+void histogram_init(Histogram *histogram);
+
+// 값 하나 기록 (어느 스레드에서나)
+void histogram_record(Histogram *histogram, uint64_t value);
+
+// from의 현재 값을 into에 더함 (from은 기록 중이어도 됨)
+void histogram_merge(Histogram *into, const Histogram *from);
+
+// 백분위 값 (0~100). 그 칸의 상한을 돌려주고, 비어 있으면 0
+uint64_t histogram_percentile(const Histogram *histogram, double percentile);
+
+// 칸 번호 ↔ 값 범위
+int histogram_bucket(uint64_t value);
+uint64_t histogram_bucket_upper(int index);
+
+#endif /* HISTOGRAM_H */
@@ -18,31 +18,61 @@ typedef enum {
 // JSON 값 구조체
 typedef struct JsonValue JsonValue;
 
-// JSON 객체 항목
+// JSON 객체 항목 (삽입 순서대로 연속 배열에 저장)
 typedef struct JsonObjectItem {
     char *key;
     JsonValue *value;
-    struct JsonObjectItem *next;
+    unsigned int hash;
 } JsonObjectItem;
 
-// JSON 배열 항목
-typedef struct JsonArrayItem {
-    JsonValue *value;
-    struct JsonArrayItem *next;
-} JsonArrayItem;
+// JSON 배열: 값 포인터 벡터 (append/get 모두 O(1))
+typedef struct {
+    JsonValue **items;
+    size_t size;
+    size_t capacity;
+} JsonArrayData;
+
+// JSON 객체: 항목 벡터 + 항목이 많아지면 만드는 해시 색인
+typedef struct {
+    JsonObjectItem *items;
+    size_t size;
+    size_t capacity;
+    unsigned int *index;        // 개방 주소법, 슬롯 값은 항목 번호 + 1 (0은 빈 슬롯)
+    size_t index_capacity;      // 0이면 색인 없음 (작은 객체는 선형 검색)
+} JsonObjectData;
 
 // JSON 값
 struct JsonValue {
     JsonType type;
+    int in_arena;   // 아레나에서 할당된 트리 (json_free가 건드리지 않음)
     union {
         int boolean;
         double number;
         char *string;
-        JsonArrayItem *array;
-        JsonObjectItem *object;
+        JsonArrayData array;
+        JsonObjectData object;
     } value;
 };
 
+// JSON 아레나: 메시지 하나를 파싱/생성하는 동안 쓰는 범프 할당기.
+// json_use_arena로 지정해 두면 그 사이 생성되는 값/항목/문자열이 모두 아레나에서 나오고,
+// 메시지 처리가 끝나면 json_arena_reset으로 한 번에 되돌린다 (청크는 재사용).
+#define JSON_ARENA_CHUNK_SIZE 4096
+
+typedef struct JsonArenaChunk JsonArenaChunk;
+
+typedef struct {
+    JsonArenaChunk *first;      // 첫 청크 (리셋하면 여기부터 다시 씀)
+    JsonArenaChunk *current;    // 지금 할당 중인 청크
+    size_t chunk_size;
+} JsonArena;
+
+void json_arena_init(JsonArena *arena, size_t chunk_size);
+void json_arena_reset(JsonArena *arena);
+void json_arena_destroy(JsonArena *arena);
+// 현재 스레드의 할당 대상을 바꾸고 이전 것을 돌려줌 (NULL이면 malloc)
+JsonArena* json_use_arena(JsonArena *arena);
+
 // JSON 값 생성 함수
 JsonValue* json_null();
 JsonValue* json_boolean(int boolean);
@@ -74,8 +104,14 @@ JsonValue* json_object_get(const JsonValue *object, const char *key);
 JsonValue* json_array_get(const JsonValue *array, size_t index);
 size_t json_array_size(const JsonValue *array);
 
+// JSON 객체 순회 (삽입 순서)
+size_t json_object_size(const JsonValue *object);
+const char* json_object_key(const JsonValue *object, size_t index);
+JsonValue* json_object_value(const JsonValue *object, size_t index);
+
 // JSON 문자열 변환
 char* json_stringify(const JsonValue *value);
+// 배열/객체가 64단계보다 깊게 중첩되면 NULL
 JsonValue* json_parse(const char *string);
 
 // JSON 값 메모리 해제
@@ -0,0 +1,116 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+#include <stdint.h>
+
+// JSON 스캔 보조 함수: 공백 건너뛰기, 문자열 끝('"', '\\', '\0') 찾기를 16바이트씩 처리한다.
+// x86-64는 SSE2, AArch64는 NEON을 쓰고 그 외에는 바이트 단위로 돈다.
+// 입력은 '\0'으로 끝나야 한다. 벡터 경로는 16바이트 정렬 블록 단위로 읽으므로
+// 페이지 경계를 넘지 않지만, 버퍼 앞뒤 몇 바이트를 함께 읽어서 ASan 검사는 끈다.
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON 1
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define JSON_SCAN_NO_ASAN __attribute__((no_sanitize_address))
+#else
+#define JSON_SCAN_NO_ASAN
+#endif
+
+static inline int json_scan_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+#if defined(JSON_SCAN_NEON)
+// 바이트마다 0x00/0xFF인 비교 결과 → 바이트당 4비트 마스크 (movemask 대용)
+static inline uint64_t json_scan_neon_mask(uint8x16_t matches) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+#endif
+
+// 공백이 아닌 첫 위치 ('\0' 포함)
+JSON_SCAN_NO_ASAN
+static inline const char* json_scan_whitespace(const char *p) {
+    // 대부분 공백이 없거나 한두 개뿐이므로 앞부분은 그냥 확인
+    if (!json_scan_is_space(*p)) return p;
+    p++;
+    if (!json_scan_is_space(*p)) return p;
+
+#if defined(JSON_SCAN_SSE2)
+    uintptr_t offset = (uintptr_t)p & 15;
+    const char *block = p - offset;
+    uint32_t skip = (0xFFFFu << offset) & 0xFFFFu;
+    while (1) {
+        __m128i bytes = _mm_load_si128((const __m128i*)block);
+        __m128i space = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))));
+        uint32_t other = ~(uint32_t)_mm_movemask_epi8(space) & skip;
+        if (other) return block + __builtin_ctz(other);
+        block += 16;
+        skip = 0xFFFFu;
+    }
+#elif defined(JSON_SCAN_NEON)
+    uintptr_t offset = (uintptr_t)p & 15;
+    const char *block = p - offset;
+    uint64_t skip = ~0ull << (offset * 4);
+    while (1) {
+        uint8x16_t bytes = vld1q_u8((const uint8_t*)block);
+        uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(' ')), vceqq_u8(bytes, vdupq_n_u8('\t'))),
+                                    vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('\r')), vceqq_u8(bytes, vdupq_n_u8('\n'))));
+        uint64_t other = ~json_scan_neon_mask(space) & skip;
+        if (other) return block + (__builtin_ctzll(other) >> 2);
+        block += 16;
+        skip = ~0ull;
+    }
+#else
+    while (json_scan_is_space(*p)) p++;
+    return p;
+#endif
+}
+
+// 문자열 본문에서 처음 나오는 '"', '\\', '\0' 위치
+JSON_SCAN_NO_ASAN
+static inline const char* json_scan_string(const char *p) {
+#if defined(JSON_SCAN_SSE2)
+    uintptr_t offset = (uintptr_t)p & 15;
+    const char *block = p - offset;
+    uint32_t skip = 0xFFFFu << offset;
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+    while (1) {
+        __m128i bytes = _mm_load_si128((const __m128i*)block);
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+                                       _mm_cmpeq_epi8(bytes, zero));
+        uint32_t found = (uint32_t)_mm_movemask_epi8(special) & skip;
+        if (found) return block + __builtin_ctz(found);
+        block += 16;
+        skip = 0xFFFFu;
+    }
+#elif defined(JSON_SCAN_NEON)
+    uintptr_t offset = (uintptr_t)p & 15;
+    const char *block = p - offset;
+    uint64_t skip = ~0ull << (offset * 4);
+    while (1) {
+        uint8x16_t bytes = vld1q_u8((const uint8_t*)block);
+        uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('"')), vceqq_u8(bytes, vdupq_n_u8('\\'))),
+                                      vceqzq_u8(bytes));
+        uint64_t found = json_scan_neon_mask(special) & skip;
+        if (found) return block + (__builtin_ctzll(found) >> 2);
+        block += 16;
+        skip = ~0ull;
+    }
+#else
+    while (*p != '"' && *p != '\\' && *p != '\0') p++;
+    return p;
+#endif
+}
+
+#endif /* JSON_SCAN_H */
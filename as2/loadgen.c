@@ -0,0 +1,1041 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "octaflip.h"
+#include "json.h"
+#include "message_handler.h"
+#include "msg_decoder.h"
+#include "msg_binary.h"
+#include "board_delta.h"
+#include "output_buffer.h"
+#include "framer.h"
+#include "histogram.h"
+#include "timer_queue.h"
+
+// 서버 부하 생성기 / 프로토콜 퍼저.
+// 봇 연결 수천 개를 워커 스레드(각자 epoll 하나)에 나눠 열고, 각 봇은 등록한 뒤 차례가 오는 즉시
+// 무작위 합법 수(또는 -e면 octaflip의 generateMove)를 둔다. 대국이 끝나면 같은 연결로 다시 register해
+// 로비에 들어가고, 전체 대국 수가 목표에 이를 때까지 계속 둔다.
+// 메시지마다 응답까지의 지연을 히스토그램에 쌓아 백분위와 초당 대국 수를 출력한다.
+//
+// -z(퍼즈) 모드에서는
+//   - 봇이 실제 메시지 사이사이에 서버가 무시해야 하는 잘못된 줄/프레임을 끼워 넣고,
+//     보내는 바이트를 몇 바이트씩 잘라 이벤트 루프 틱마다 흘려 보내 framer의 재조립을 시험한다.
+//     그래도 대국은 정상으로 끝나야 하므로 invalid_move가 하나라도 오면 오류로 센다.
+//   - 등록하지 않는 습격 연결이 쓰레기 바이트, 너무 긴 줄, 끝나지 않은 줄을 보내고 끊기를 되풀이한다.
+//   - 바이너리 프레이밍을 협상한 봇은 마지막에 max_frame을 넘는 길이 헤더를 보내 서버가 끊는지 확인한다.
+
+#define DEFAULT_PORT 8888
+#define DEFAULT_CONNECTIONS 1000
+#define DEFAULT_GAMES 5
+#define MAX_THREADS 64
+#define MAX_EVENTS 256
+#define SEND_BUFFER_SIZE 256
+#define FUZZ_MAX_CHUNK 8          // 흘려 보내는 조각 최대 크기 (긴 쓰레기 줄은 더 크게)
+#define FUZZ_LONG_LINE 3000       // 서버 기본 max_frame(2048)보다 긴 줄
+#define FUZZ_RAIDER_RATIO 8       // 봇 이만큼마다 습격 연결 하나
+
+typedef enum {
+    BOT_CONNECTING,
+    BOT_REGISTERING,
+    BOT_LOBBY,                // 등록을 마치고 매칭 대기
+    BOT_PLAYING,
+    BOT_RAIDING,              // 습격 연결: 보낼 것을 흘려 보내는 중
+    BOT_CLOSING,              // 서버가 끊기를 기다림
+    BOT_DONE
+} BotState;
+
+typedef enum {
+    LATENCY_REGISTER = 0,     // register → register_ack
+    LATENCY_MATCH,            // register_ack → game_start
+    LATENCY_MOVE,             // move → move_ok / invalid_move
+    LATENCY_GAME,             // game_start → game_over
+    LATENCY_KINDS
+} LatencyKind;
+
+static const char *latency_names[LATENCY_KINDS] = { "register", "match", "move", "game" };
+
+// 워커별 카운터 (워커만 쓰고, 진행 상황은 메인 스레드가 원자적으로 읽음)
+typedef struct {
+    uint64_t games;           // 빨강(players[0]) 쪽이 센 대국 (한 대국을 한 번만)
+    uint64_t moves;
+    uint64_t passes;
+    uint64_t messages;        // 받은 메시지
+    uint64_t invalid_moves;
+    uint64_t nacks;
+    uint64_t opponent_left;
+    uint64_t delta_games;     // 델타를 협상한 봇이 델타를 받은 대국 (양쪽 봇이 각각 셈)
+    uint64_t delta_lost;      // 델타를 협상했는데 대국 내내 보드 전체만 온 것
+    uint64_t disconnects;     // 기대하지 않은 연결 끊김
+    uint64_t connect_failures;
+    uint64_t junk;            // 퍼즈: 끼워 넣은 잘못된 줄/프레임
+    uint64_t fragments;       // 퍼즈: 나눠 보낸 조각
+    uint64_t raids;           // 퍼즈: 습격 연결
+    uint64_t raids_closed;    // 그중 서버가 정상적으로 닫은 것
+    uint64_t probes;          // 퍼즈: 바이너리 길이 초과 프레임
+    uint64_t probes_closed;   // 그중 서버가 연결을 끊은 것
+} LoadStats;
+
+struct Worker;
+
+typedef struct {
+    struct Worker *worker;
+    int fd;
+    BotState state;
+    int raider;
+    int raids_left;
+    char username[32];
+    char color;
+    GameBoard board;
+    BoardView view;
+    LineFramer in;
+    OutputBuffer out;
+    char *trickle;            // 퍼즈: 조각내 보낼 바이트 (앞에서부터 소비)
+    size_t trickle_length;
+    size_t trickle_capacity;
+    int binary;               // 서버가 바이너리 프레이밍을 받아 줌
+    int delta;                // 서버가 보드 델타를 받아 줌
+    int board_updates;        // 이번 대국에 받은 your_turn / move_ok / invalid_move
+    int delta_updates;        // 그중 델타 (보드 없이 seq만 온 것)
+    int want_write;           // EPOLLOUT 등록 상태
+    int opponent_left;
+    uint64_t sent_ns;         // 응답을 기다리는 메시지를 보낸 시각
+    LatencyKind waiting;      // 그 응답의 종류 (LATENCY_KINDS면 없음)
+    uint64_t match_ns;        // register_ack를 받은 시각
+    uint64_t game_ns;         // 대국 시작 시각
+    uint32_t rng;
+} Bot;
+
+typedef struct Worker {
+    int id;
+    pthread_t thread;
+    int epoll_fd;
+    Bot *bots;
+    int bot_count;
+    int active;               // BOT_DONE이 아닌 봇
+    int trickling;            // 흘려 보낼 바이트가 남은 봇
+    JsonArena json_arena;
+    Histogram latency[LATENCY_KINDS];
+    LoadStats stats;
+} Worker;
+
+// 설정
+static char server_ip[64] = "127.0.0.1";
+static int server_port = DEFAULT_PORT;
+static int connection_count = DEFAULT_CONNECTIONS;
+static int games_per_connection = DEFAULT_GAMES;
+static int thread_count = 0;
+static int use_engine = 0;
+static unsigned int requested_capabilities = 0;
+static int fuzz_mode = 0;
+static double duration_limit = 0.0;
+static struct sockaddr_in server_addr;
+
+static Worker workers[MAX_THREADS];
+static uint64_t game_target;
+static volatile sig_atomic_t stop_requested = 0;
+
+#define STAT_ADD(worker, field, n) __atomic_add_fetch(&(worker)->stats.field, (n), __ATOMIC_RELAXED)
+
+// 모든 워커가 센 대국 수
+static uint64_t total_games(void) {
+    uint64_t games = 0;
+    for (int i = 0; i < thread_count; i++) games += __atomic_load_n(&workers[i].stats.games, __ATOMIC_RELAXED);
+    return games;
+}
+
+static uint32_t next_random(Bot *bot) {
+    // xorshift32 (봇마다 다른 씨앗)
+    uint32_t x = bot->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bot->rng = x;
+    return x;
+}
+
+// ---- 수 고르기 ----
+
+// 합법 수 중 하나를 고르게 무작위로 (저수지 표집, 0부터 시작하는 좌표). 없으면 0,0,0,0
+static Move random_move(Bot *bot) {
+    const GameBoard *board = &bot->board;
+    Move chosen;
+    memset(&chosen, 0, sizeof(chosen));
+    chosen.player = bot->color;
+    uint32_t seen = 0;
+    for (int r = 0; r < BOARD_SIZE; r++) {
+        for (int c = 0; c < BOARD_SIZE; c++) {
+            if (board->cells[r][c] != bot->color) continue;
+            for (int d = 0; d < 8; d++) {
+                for (int s = 1; s <= 2; s++) {
+                    int nr = r + dRow[d] * s;
+                    int nc = c + dCol[d] * s;
+                    if (nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE) continue;
+                    if (board->cells[nr][nc] != EMPTY_CELL) continue;
+                    if (s == 2) {
+                        char middle = board->cells[r + dRow[d]][c + dCol[d]];
+                        if (middle == RED_PLAYER || middle == BLUE_PLAYER) continue;
+                    }
+                    if (next_random(bot) % ++seen == 0) {
+                        chosen.sourceRow = r;
+                        chosen.sourceCol = c;
+                        chosen.targetRow = nr;
+                        chosen.targetCol = nc;
+                    }
+                }
+            }
+        }
+    }
+    return chosen;
+}
+
+static Move choose_move(Bot *bot) {
+    if (!use_engine) return random_move(bot);
+    GameBoard board = bot->board;
+    board.currentPlayer = bot->color;
+    return generateMove(&board);
+}
+
+// ---- 보내기 ----
+
+static void update_events(Bot *bot) {
+    int want = output_buffer_pending(&bot->out) > 0 || bot->state == BOT_CONNECTING;
+    if (want == bot->want_write) return;
+    bot->want_write = want;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | (want ? EPOLLOUT : 0);
+    ev.data.ptr = bot;
+    epoll_ctl(bot->worker->epoll_fd, EPOLL_CTL_MOD, bot->fd, &ev);
+}
+
+static void trickle_append(Bot *bot, const char *data, size_t length) {
+    if (bot->trickle_length + length > bot->trickle_capacity) {
+        size_t capacity = bot->trickle_capacity ? bot->trickle_capacity : 1024;
+        while (capacity < bot->trickle_length + length) capacity *= 2;
+        char *trickle = (char*)realloc(bot->trickle, capacity);
+        if (!trickle) return;
+        bot->trickle = trickle;
+        bot->trickle_capacity = capacity;
+    }
+    if (bot->trickle_length == 0 && length > 0) bot->worker->trickling++;
+    memcpy(bot->trickle + bot->trickle_length, data, length);
+    bot->trickle_length += length;
+}
+
+// 퍼즈: 서버가 무시해야 하는 잘못된 줄 하나 (register/move/spectate처럼 상태를 바꾸는 유형은 만들지 않음)
+static size_t junk_line(Bot *bot, char *out, size_t capacity) {
+    size_t length = 0;
+    switch (next_random(bot) % 9) {
+        case 0: {
+            // 무작위 바이트 (개행만 빼고, NUL 포함)
+            length = 1 + next_random(bot) % 200;
+            for (size_t i = 0; i < length; i++) {
+                char byte = (char)(next_random(bot) & 0xFF);
+                out[i] = (byte == '\n') ? ' ' : byte;
+            }
+            break;
+        }
+        case 1:
+            length = (size_t)snprintf(out, capacity, "{\"type\":\"move\",\"username\":\"%s\",\"sx\":%u,\"sy\":",
+                                      bot->username, next_random(bot) % 9);
+            // 닫히지 않은 객체 (type이 move여도 파싱이 실패해야 함)
+            break;
+        case 2:
+            length = (size_t)snprintf(out, capacity, "{\"type\":\"hello%u\",\"username\":\"%s\"}",
+                                      next_random(bot) % 100, bot->username);
+            break;
+        case 3: {
+            static const char *values[] = { "[1,2,3]", "\"move\"", "42", "null", "{}", "{\"type\":7}",
+                                            "{\"type\":null,\"sx\":1}", "{\"type\":\"\"}", "[{\"type\":\"move\"}]" };
+            length = (size_t)snprintf(out, capacity, "%s", values[next_random(bot) % 9]);
+            break;
+        }
+        case 4: {
+            // 깊은 중첩
+            size_t depth = 50 + next_random(bot) % 450;
+            for (size_t i = 0; i < depth; i++) out[length++] = '[';
+            for (size_t i = 0; i < depth; i++) out[length++] = ']';
+            break;
+        }
+        case 5:
+            // 이스케이프가 든 모르는 유형 (느린 경로)
+            length = (size_t)snprintf(out, capacity, "{\"type\":\"\\u0078y\\\"z\",\"username\":\"a\\\\b\\n\"}");
+            break;
+        case 6:
+            // 빈 줄, 공백만, CR
+            length = (size_t)snprintf(out, capacity, "%s", (next_random(bot) & 1) ? "   \t" : "\r");
+            break;
+        case 7:
+            length = (size_t)snprintf(out, capacity, "{\"type\":\"move\" \"username\":\"%s\" \"sx\":1}}}", bot->username);
+            break;
+        default:
+            // max_frame보다 긴 줄 (서버는 다음 개행까지 버림)
+            length = (size_t)snprintf(out, capacity, "{\"type\":\"move\",\"username\":\"");
+            while (length < FUZZ_LONG_LINE && length < capacity - 2) out[length++] = 'x';
+            out[length++] = '"';
+            out[length++] = '}';
+            break;
+    }
+    out[length++] = '\n';
+    return length;
+}
+
+// 퍼즈: 바이너리 연결용 잘못된 프레임 (길이는 맞게, 유형과 본문은 엉터리. register/move 유형은 피함)
+static size_t junk_frame(Bot *bot, unsigned char *out) {
+    size_t body = 1 + next_random(bot) % 64;
+    unsigned int type;
+    do {
+        type = next_random(bot) & 0xFF;
+    } while (type == BINARY_REGISTER || type == BINARY_MOVE);
+    out[0] = (unsigned char)(body >> 8);
+    out[1] = (unsigned char)body;
+    out[2] = (unsigned char)type;
+    for (size_t i = 1; i < body; i++) out[2 + i] = (unsigned char)(next_random(bot) & 0xFF);
+    return BINARY_HEADER_SIZE + body;
+}
+
+static void send_bytes(Bot *bot, const char *data, size_t length) {
+    if (fuzz_mode) {
+        // 절반쯤은 앞에 잘못된 줄/프레임을 하나 끼움
+        if (next_random(bot) & 1) {
+            char junk[FUZZ_LONG_LINE + 64];
+            size_t junk_length = bot->binary ? junk_frame(bot, (unsigned char*)junk)
+                                             : junk_line(bot, junk, sizeof(junk));
+            trickle_append(bot, junk, junk_length);
+            STAT_ADD(bot->worker, junk, 1);
+        }
+        trickle_append(bot, data, length);
+        return;
+    }
+    if (output_buffer_append(&bot->out, data, length) != 0) return;
+    if (output_buffer_flush(&bot->out, bot->fd) < 0) return;   // 끊김은 읽기 쪽에서 처리
+    update_events(bot);
+}
+
+static void send_register(Bot *bot) {
+    char line[SEND_BUFFER_SIZE];
+    int length;
+    if (requested_capabilities == (CAPABILITY_BINARY | CAPABILITY_DELTA)) {
+        length = snprintf(line, sizeof(line), "{\"type\":\"register\",\"username\":\"%s\",\"capabilities\":[\"binary\",\"delta\"]}\n", bot->username);
+    } else if (requested_capabilities) {
+        length = snprintf(line, sizeof(line), "{\"type\":\"register\",\"username\":\"%s\",\"capabilities\":[\"%s\"]}\n",
+                          bot->username, (requested_capabilities & CAPABILITY_BINARY) ? "binary" : "delta");
+    } else {
+        length = snprintf(line, sizeof(line), "{\"type\":\"register\",\"username\":\"%s\"}\n", bot->username);
+    }
+    bot->state = BOT_REGISTERING;
+    bot->waiting = LATENCY_REGISTER;
+    bot->sent_ns = monotonic_ns();
+    if (bot->binary) {
+        // 대국을 마친 뒤 다시 등록: 이미 협상한 바이너리 프레임으로
+        unsigned char frame[64];
+        BinaryWriter writer;
+        binary_begin(&writer, frame, sizeof(frame), BINARY_REGISTER);
+        binary_put_string(&writer, bot->username);
+        send_bytes(bot, (const char*)frame, binary_end(&writer));
+        return;
+    }
+    send_bytes(bot, line, (size_t)length);
+}
+
+// move는 JsonValue를 거치지 않고 바로 씀 (초당 수만 번 보내므로)
+static void send_move(Bot *bot, const Move *move) {
+    Move converted = *move;
+    int pass = (move->sourceRow == 0 && move->sourceCol == 0 && move->targetRow == 0 && move->targetCol == 0);
+    if (!pass) {
+        converted.sourceRow += 1;
+        converted.sourceCol += 1;
+        converted.targetRow += 1;
+        converted.targetCol += 1;
+    }
+    bot->waiting = LATENCY_MOVE;
+    bot->sent_ns = monotonic_ns();
+    if (bot->binary) {
+        unsigned char frame[16];
+        BinaryWriter writer;
+        binary_begin(&writer, frame, sizeof(frame), BINARY_MOVE);
+        binary_put_move(&writer, &converted);
+        size_t length = binary_end(&writer);
+        send_bytes(bot, (const char*)frame, length);
+    } else {
+        char line[SEND_BUFFER_SIZE];
+        int length = snprintf(line, sizeof(line), "{\"type\":\"move\",\"username\":\"%s\",\"sx\":%d,\"sy\":%d,\"tx\":%d,\"ty\":%d}\n",
+                              bot->username, converted.sourceRow, converted.sourceCol,
+                              converted.targetRow, converted.targetCol);
+        send_bytes(bot, line, (size_t)length);
+    }
+}
+
+// 퍼즈: 흘려 보낼 바이트를 조각 하나만큼 보냄 (틱마다 호출)
+static void trickle_some(Bot *bot) {
+    if (bot->trickle_length == 0 || bot->state == BOT_CONNECTING || bot->state == BOT_DONE) return;
+    size_t limit = (bot->trickle_length > 64) ? 512 : FUZZ_MAX_CHUNK;
+    size_t chunk = 1 + next_random(bot) % limit;
+    if (chunk > bot->trickle_length) chunk = bot->trickle_length;
+    ssize_t sent = send(bot->fd, bot->trickle, chunk, MSG_NOSIGNAL);
+    if (sent <= 0) return;    // EAGAIN이면 다음 틱에, 끊김은 읽기 쪽에서
+    STAT_ADD(bot->worker, fragments, 1);
+    bot->trickle_length -= (size_t)sent;
+    memmove(bot->trickle, bot->trickle + sent, bot->trickle_length);
+    if (bot->trickle_length > 0) return;
+    bot->worker->trickling--;
+    if (bot->state == BOT_RAIDING) {
+        // 다 보냈으면 쓰기 쪽을 닫고 서버가 닫기를 기다림
+        shutdown(bot->fd, SHUT_WR);
+        bot->state = BOT_CLOSING;
+    }
+}
+
+// ---- 연결 ----
+
+static void close_bot(Bot *bot) {
+    if (bot->fd >= 0) {
+        epoll_ctl(bot->worker->epoll_fd, EPOLL_CTL_DEL, bot->fd, NULL);
+        close(bot->fd);
+        bot->fd = -1;
+    }
+    if (bot->trickle_length > 0) bot->worker->trickling--;
+    bot->trickle_length = 0;
+    bot->want_write = 0;
+}
+
+static void finish_bot(Bot *bot) {
+    close_bot(bot);
+    if (bot->state != BOT_DONE) __atomic_sub_fetch(&bot->worker->active, 1, __ATOMIC_RELAXED);
+    bot->state = BOT_DONE;
+}
+
+static int connect_bot(Bot *bot) {
+    bot->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (bot->fd < 0) {
+        perror("[LoadGen] socket");
+        return -1;
+    }
+    int one = 1;
+    setsockopt(bot->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(bot->fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) != 0 && errno != EINPROGRESS) {
+        close(bot->fd);
+        bot->fd = -1;
+        return -1;
+    }
+    bot->state = BOT_CONNECTING;
+    bot->binary = 0;
+    framer_destroy(&bot->in);
+    if (framer_init(&bot->in, FRAMER_DEFAULT_MAX_FRAME) != 0) {
+        close(bot->fd);
+        bot->fd = -1;
+        return -1;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = bot;
+    bot->want_write = 1;
+    if (epoll_ctl(bot->worker->epoll_fd, EPOLL_CTL_ADD, bot->fd, &ev) != 0) {
+        close(bot->fd);
+        bot->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+// 습격 연결이 보낼 것: 잘못된 줄 몇 개 + 끝나지 않은 줄 (개행 없이 끊김)
+static void start_raid(Bot *bot) {
+    char junk[FUZZ_LONG_LINE + 64];
+    int lines = 1 + (int)(next_random(bot) % 4);
+    for (int i = 0; i < lines; i++) {
+        trickle_append(bot, junk, junk_line(bot, junk, sizeof(junk)));
+        STAT_ADD(bot->worker, junk, 1);
+    }
+    switch (next_random(bot) % 3) {
+        case 0:
+            trickle_append(bot, "{\"type\":\"register\",\"username\":\"", 31);
+            break;
+        case 1: {
+            // max_frame을 넘긴 채 끝나는 줄
+            memset(junk, 'y', FUZZ_LONG_LINE);
+            trickle_append(bot, junk, FUZZ_LONG_LINE);
+            break;
+        }
+        default: {
+            size_t length = 1 + next_random(bot) % 64;
+            for (size_t i = 0; i < length; i++) {
+                char byte = (char)(next_random(bot) & 0xFF);
+                junk[i] = (byte == '\n') ? '{' : byte;
+            }
+            trickle_append(bot, junk, length);
+            break;
+        }
+    }
+    bot->state = BOT_RAIDING;
+    bot->raids_left--;
+    STAT_ADD(bot->worker, raids, 1);
+}
+
+static void on_connected(Bot *bot) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(bot->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+        STAT_ADD(bot->worker, connect_failures, 1);
+        finish_bot(bot);
+        return;
+    }
+    if (bot->raider) {
+        start_raid(bot);
+    } else {
+        send_register(bot);
+    }
+    update_events(bot);
+}
+
+// 목표 대국 수를 채웠으면 봇을 닫음. 바이너리 퍼즈 봇은 길이 초과 프레임을 보내고 서버가 끊기를 기다림
+static void retire_bot(Bot *bot) {
+    if (fuzz_mode && bot->binary) {
+        static const char oversized[] = { (char)0xFF, (char)0xFF, 'z', 'z', 'z', 'z' };
+        trickle_append(bot, oversized, sizeof(oversized));
+        bot->state = BOT_CLOSING;
+        STAT_ADD(bot->worker, probes, 1);
+        return;
+    }
+    finish_bot(bot);
+}
+
+// ---- 받기 ----
+
+static void record_latency(Bot *bot, LatencyKind kind, uint64_t since) {
+    histogram_record(&bot->worker->latency[kind], monotonic_ns() - since);
+}
+
+static void count_board_update(Bot *bot, const DecodedMessage *message) {
+    bot->board_updates++;
+    if ((message->fields & DECODED_SEQ) && !(message->fields & DECODED_BOARD)) bot->delta_updates++;
+}
+
+static void handle_message(Bot *bot, DecodedMessage *message) {
+    Worker *worker = bot->worker;
+    STAT_ADD(worker, messages, 1);
+    // 끊기를 기다리는 동안 온 메시지(그 사이 매칭된 game_start 등)는 무시
+    if (bot->state == BOT_CLOSING) return;
+    switch (message->type) {
+        case MSG_REGISTER_ACK:
+            if (bot->waiting == LATENCY_REGISTER) record_latency(bot, LATENCY_REGISTER, bot->sent_ns);
+            bot->waiting = LATENCY_KINDS;
+            if ((requested_capabilities & CAPABILITY_BINARY) && (message->fields & DECODED_CAPABILITIES) &&
+                (message->capabilities & CAPABILITY_BINARY) && !bot->binary) {
+                bot->binary = 1;
+                framer_set_binary(&bot->in);
+            }
+            // 바이너리 register_ack에는 capabilities가 없음: 재등록이면 처음 협상한 값이 그대로 유지됨
+            if (message->fields & DECODED_CAPABILITIES) bot->delta = (message->capabilities & CAPABILITY_DELTA) != 0;
+            bot->state = BOT_LOBBY;
+            bot->match_ns = monotonic_ns();
+            break;
+
+        case MSG_REGISTER_NACK:
+            STAT_ADD(worker, nacks, 1);
+            finish_bot(bot);
+            break;
+
+        case MSG_GAME_START:
+            if ((message->fields & DECODED_PLAYERS) == 0) break;
+            record_latency(bot, LATENCY_MATCH, bot->match_ns);
+            bot->color = (strcmp(message->players[0], bot->username) == 0) ? RED_PLAYER : BLUE_PLAYER;
+            initializeBoard(&bot->board);
+            board_view_reset(&bot->view);
+            bot->opponent_left = 0;
+            bot->board_updates = 0;
+            bot->delta_updates = 0;
+            bot->state = BOT_PLAYING;
+            bot->game_ns = monotonic_ns();
+            break;
+
+        case MSG_YOUR_TURN: {
+            if (bot->state != BOT_PLAYING) break;
+            count_board_update(bot, message);
+            board_view_update(&bot->view, &bot->board, message);
+            Move move = choose_move(bot);
+            if (move.sourceRow == 0 && move.sourceCol == 0 && move.targetRow == 0 && move.targetCol == 0) {
+                STAT_ADD(worker, passes, 1);
+            }
+            STAT_ADD(worker, moves, 1);
+            send_move(bot, &move);
+            break;
+        }
+
+        case MSG_MOVE_OK:
+        case MSG_INVALID_MOVE:
+            if (bot->waiting == LATENCY_MOVE) {
+                record_latency(bot, LATENCY_MOVE, bot->sent_ns);
+                bot->waiting = LATENCY_KINDS;
+                // 합법 수만 두므로 내 수에 대한 invalid_move는 서버(또는 보드 동기화)의 오류
+                if (message->type == MSG_INVALID_MOVE) STAT_ADD(worker, invalid_moves, 1);
+            }
+            count_board_update(bot, message);
+            board_view_update(&bot->view, &bot->board, message);
+            break;
+
+        case MSG_PASS:
+            if ((message->fields & DECODED_NEXT_PLAYER) && (message->fields & DECODED_BOARD)) {
+                memcpy(&bot->board, &message->board, sizeof(GameBoard));
+            }
+            break;
+
+        case MSG_GAME_OVER: {
+            if (bot->state != BOT_PLAYING) break;
+            record_latency(bot, LATENCY_GAME, bot->game_ns);
+            // 한 대국을 한 번만 셈: 빨강 쪽이, 빨강이 나갔으면 남은 쪽이
+            if (bot->color == RED_PLAYER || bot->opponent_left) STAT_ADD(worker, games, 1);
+            // 첫 메시지는 스냅샷이므로 두 번 이상 받았는데 델타가 하나도 없으면 협상이 풀린 것
+            if (bot->delta && bot->board_updates >= 2) {
+                if (bot->delta_updates > 0) STAT_ADD(worker, delta_games, 1);
+                else STAT_ADD(worker, delta_lost, 1);
+            }
+            bot->waiting = LATENCY_KINDS;
+            if (total_games() >= game_target || stop_requested) {
+                retire_bot(bot);
+            } else {
+                send_register(bot);
+            }
+            break;
+        }
+
+        default:
+            // 플레이어에게 오는 그 밖의 메시지는 opponent_left뿐
+            if (bot->state == BOT_PLAYING) {
+                bot->opponent_left = 1;
+                STAT_ADD(worker, opponent_left, 1);
+            }
+            break;
+    }
+}
+
+static void process_frames(Bot *bot) {
+    char *line;
+    size_t len;
+    int result;
+    while (bot->state != BOT_DONE && (result = framer_next(&bot->in, &line, &len)) != 0) {
+        if (result < 0 || len == 0) continue;
+        DecodedMessage message;
+        if (bot->binary) {
+            if (!decodeBinaryMessage(line, len, &message)) continue;
+            handle_message(bot, &message);
+            continue;
+        }
+        if (decodeMessage(line, &message)) {
+            handle_message(bot, &message);
+            continue;
+        }
+        JsonArena *previous_arena = json_use_arena(&bot->worker->json_arena);
+        JsonValue *json = json_parse(line);
+        if (json) {
+            decodeMessageTree(json, &message);
+            handle_message(bot, &message);
+        }
+        json_use_arena(previous_arena);
+        json_arena_reset(&bot->worker->json_arena);
+    }
+}
+
+static void on_closed(Bot *bot) {
+    Worker *worker = bot->worker;
+    if (bot->state == BOT_CLOSING) {
+        if (bot->raider) {
+            STAT_ADD(worker, raids_closed, 1);
+            close_bot(bot);
+            if (bot->raids_left > 0 && !stop_requested && connect_bot(bot) == 0) return;
+        } else {
+            STAT_ADD(worker, probes_closed, 1);
+        }
+    } else {
+        STAT_ADD(worker, disconnects, 1);
+    }
+    finish_bot(bot);
+}
+
+static void read_bot(Bot *bot) {
+    for (;;) {
+        size_t space;
+        char *dst = framer_write_space(&bot->in, &space);
+        if (space == 0) {
+            process_frames(bot);
+            if (bot->state == BOT_DONE) return;
+            continue;
+        }
+        ssize_t received = recv(bot->fd, dst, space, 0);
+        if (received > 0) {
+            framer_commit(&bot->in, (size_t)received);
+            process_frames(bot);
+            if (bot->state == BOT_DONE || bot->fd < 0) return;
+            if ((size_t)received < space) return;
+        } else if (received == 0) {
+            on_closed(bot);
+            return;
+        } else {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) on_closed(bot);
+            return;
+        }
+    }
+}
+
+// ---- 워커 ----
+
+static void *worker_main(void *arg) {
+    Worker *worker = (Worker*)arg;
+    struct epoll_event events[MAX_EVENTS];
+    int retiring = 0;
+
+    for (int i = 0; i < worker->bot_count; i++) {
+        Bot *bot = &worker->bots[i];
+        if (connect_bot(bot) != 0) {
+            STAT_ADD(worker, connect_failures, 1);
+            finish_bot(bot);
+        }
+    }
+
+    while (worker->active > 0) {
+        int timeout = worker->trickling > 0 ? 1 : 100;
+        int n = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, timeout);
+        if (n < 0 && errno != EINTR) {
+            perror("[LoadGen] epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            Bot *bot = (Bot*)events[i].data.ptr;
+            if (bot->state == BOT_DONE || bot->fd < 0) continue;
+            if (bot->state == BOT_CONNECTING) {
+                if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) on_connected(bot);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read_bot(bot);
+            if (bot->state != BOT_DONE && bot->fd >= 0 && (events[i].events & EPOLLOUT)) {
+                if (output_buffer_flush(&bot->out, bot->fd) >= 0) update_events(bot);
+            }
+        }
+        if (worker->trickling > 0) {
+            for (int i = 0; i < worker->bot_count; i++) trickle_some(&worker->bots[i]);
+        }
+        // 목표를 채웠거나 중단 요청이면 로비에서 기다리는 봇을 정리 (대국 중인 봇은 끝날 때)
+        if (!retiring && (stop_requested || total_games() >= game_target)) retiring = 1;
+        if (retiring) {
+            for (int i = 0; i < worker->bot_count; i++) {
+                Bot *bot = &worker->bots[i];
+                if (bot->raider) {
+                    bot->raids_left = 0;
+                } else if (bot->state == BOT_LOBBY || bot->state == BOT_REGISTERING ||
+                           (stop_requested && bot->state == BOT_PLAYING)) {
+                    retire_bot(bot);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// ---- 출력 ----
+
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Options:\n");
+    printf("  -i, --ip <ip>          서버 IP 주소 (기본값: 127.0.0.1)\n");
+    printf("  -p, --port <port>      서버 포트 번호 (기본값: %d)\n", DEFAULT_PORT);
+    printf("  -c, --connections <n>  동시 봇 연결 수 (기본값: %d)\n", DEFAULT_CONNECTIONS);
+    printf("  -g, --games <n>        연결당 대국 수. 전체 목표는 연결 수 × n / 2 (기본값: %d)\n", DEFAULT_GAMES);
+    printf("  -t, --threads <n>      워커 스레드 수 (기본값: CPU 코어 수, 최대 %d)\n", MAX_THREADS);
+    printf("  -d, --duration <초>    이 시간이 지나면 목표와 관계없이 멈춤 (기본값: 없음)\n");
+    printf("  -e, --engine           무작위 수 대신 generateMove(첫 번째 합법 수)로 둠\n");
+    printf("  -b, --binary           바이너리 프레이밍을 요청\n");
+    printf("  -D, --delta            보드 델타를 요청\n");
+    printf("  -z, --fuzz             잘못된 줄/프레임을 섞고 메시지를 조각내 보냄, 습격 연결 추가\n");
+    printf("  -h, --help             이 도움말 표시\n");
+    printf("\n");
+    printf("Examples:\n");
+    printf("  %s -c 2000 -g 10              # 봇 2000개로 대국 10000판\n", program_name);
+    printf("  %s -c 500 -b -D -d 30         # 바이너리 + 델타로 30초 동안\n", program_name);
+    printf("  %s -c 200 -z                  # 퍼즈 모드\n", program_name);
+}
+
+static int parse_arguments(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--ip") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 IP 주소가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            struct in_addr addr;
+            if (inet_pton(AF_INET, argv[i + 1], &addr) != 1) {
+                fprintf(stderr, "Error: 유효하지 않은 IP 주소: %s\n", argv[i + 1]);
+                return -1;
+            }
+            strncpy(server_ip, argv[i + 1], sizeof(server_ip) - 1);
+            server_ip[sizeof(server_ip) - 1] = '\0';
+            i++;
+
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--port") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 포트 번호가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            server_port = atoi(argv[i + 1]);
+            if (server_port <= 0 || server_port > 65535) {
+                fprintf(stderr, "Error: 유효하지 않은 포트 번호: %s (1-65535 범위여야 합니다)\n", argv[i + 1]);
+                return -1;
+            }
+            i++;
+
+        } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--connections") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 연결 수가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            connection_count = atoi(argv[i + 1]);
+            if (connection_count < 2 || connection_count > 1000000) {
+                fprintf(stderr, "Error: 유효하지 않은 연결 수: %s (2 이상이어야 합니다)\n", argv[i + 1]);
+                return -1;
+            }
+            i++;
+
+        } else if (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--games") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 대국 수가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            games_per_connection = atoi(argv[i + 1]);
+            if (games_per_connection < 1) {
+                fprintf(stderr, "Error: 유효하지 않은 대국 수: %s\n", argv[i + 1]);
+                return -1;
+            }
+            i++;
+
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 스레드 수가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            thread_count = atoi(argv[i + 1]);
+            if (thread_count < 1 || thread_count > MAX_THREADS) {
+                fprintf(stderr, "Error: 유효하지 않은 스레드 수: %s (1-%d 범위여야 합니다)\n", argv[i + 1], MAX_THREADS);
+                return -1;
+            }
+            i++;
+
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--duration") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 시간이 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            char *end;
+            duration_limit = strtod(argv[i + 1], &end);
+            if (end == argv[i + 1] || *end != '\0' || duration_limit <= 0.0) {
+                fprintf(stderr, "Error: 유효하지 않은 시간: %s\n", argv[i + 1]);
+                return -1;
+            }
+            i++;
+
+        } else if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine") == 0) {
+            use_engine = 1;
+        } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--binary") == 0) {
+            requested_capabilities |= CAPABILITY_BINARY;
+        } else if (strcmp(argv[i], "-D") == 0 || strcmp(argv[i], "--delta") == 0) {
+            requested_capabilities |= CAPABILITY_DELTA;
+        } else if (strcmp(argv[i], "-z") == 0 || strcmp(argv[i], "--fuzz") == 0) {
+            fuzz_mode = 1;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else {
+            fprintf(stderr, "Error: 알 수 없는 옵션: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void sigint_handler(int sig __attribute__((unused))) {
+    stop_requested = 1;
+}
+
+static void collect_stats(LoadStats *total) {
+    memset(total, 0, sizeof(LoadStats));
+    for (int i = 0; i < thread_count; i++) {
+        const uint64_t *from = (const uint64_t*)&workers[i].stats;
+        uint64_t *into = (uint64_t*)total;
+        for (size_t j = 0; j < sizeof(LoadStats) / sizeof(uint64_t); j++) {
+            into[j] += __atomic_load_n(&from[j], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void print_report(double elapsed) {
+    LoadStats stats;
+    collect_stats(&stats);
+    printf("\n연결 %d개, 워커 %d개, %.2f초\n", connection_count, thread_count, elapsed);
+    printf("대국: %llu (%.1f games/sec), 수: %llu (패스 %llu, %.0f moves/sec), 받은 메시지: %llu (%.0f msg/sec)\n",
+           (unsigned long long)stats.games, stats.games / elapsed,
+           (unsigned long long)stats.moves, (unsigned long long)stats.passes, stats.moves / elapsed,
+           (unsigned long long)stats.messages, stats.messages / elapsed);
+    printf("오류: invalid_move %llu, register_nack %llu, 연결 끊김 %llu, 연결 실패 %llu (opponent_left %llu)\n",
+           (unsigned long long)stats.invalid_moves, (unsigned long long)stats.nacks,
+           (unsigned long long)stats.disconnects, (unsigned long long)stats.connect_failures,
+           (unsigned long long)stats.opponent_left);
+    if (requested_capabilities & CAPABILITY_DELTA) {
+        printf("델타: 델타를 받은 대국 %llu, 보드 전체만 받은 대국 %llu\n",
+               (unsigned long long)stats.delta_games, (unsigned long long)stats.delta_lost);
+    }
+    if (fuzz_mode) {
+        printf("퍼즈: 잘못된 줄/프레임 %llu, 조각 %llu, 습격 %llu (서버가 닫음 %llu), 길이 초과 프레임 %llu (서버가 끊음 %llu)\n",
+               (unsigned long long)stats.junk, (unsigned long long)stats.fragments,
+               (unsigned long long)stats.raids, (unsigned long long)stats.raids_closed,
+               (unsigned long long)stats.probes, (unsigned long long)stats.probes_closed);
+    }
+
+    printf("\n지연 (ms)        count       avg       p50       p90       p99     p99.9       max\n");
+    for (int kind = 0; kind < LATENCY_KINDS; kind++) {
+        Histogram merged;
+        histogram_init(&merged);
+        for (int i = 0; i < thread_count; i++) histogram_merge(&merged, &workers[i].latency[kind]);
+        if (merged.total == 0) continue;
+        printf("  %-10s %10llu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", latency_names[kind],
+               (unsigned long long)merged.total, (double)merged.sum / merged.total / 1e6,
+               histogram_percentile(&merged, 50.0) / 1e6, histogram_percentile(&merged, 90.0) / 1e6,
+               histogram_percentile(&merged, 99.0) / 1e6, histogram_percentile(&merged, 99.9) / 1e6,
+               merged.max / 1e6);
+    }
+}
+
+// 연결 수천 개를 열 수 있게 파일 디스크립터 한도를 최대로
+static void raise_fd_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)connection_count + 64) {
+        fprintf(stderr, "[LoadGen] 경고: 파일 디스크립터 한도(%llu)가 연결 수보다 작습니다\n",
+                (unsigned long long)limit.rlim_cur);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (parse_arguments(argc, argv) != 0) return 1;
+    if (thread_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = (cpus < 1) ? 1 : (cpus > MAX_THREADS ? MAX_THREADS : (int)cpus);
+    }
+    if (thread_count > connection_count) thread_count = connection_count;
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(server_port);
+    inet_pton(AF_INET, server_ip, &server_addr.sin_addr);
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, sigint_handler);
+    raise_fd_limit();
+
+    game_target = (uint64_t)connection_count * games_per_connection / 2;
+    int raider_count = fuzz_mode ? (connection_count + FUZZ_RAIDER_RATIO - 1) / FUZZ_RAIDER_RATIO : 0;
+    int total_bots = connection_count + raider_count;
+    Bot *bots = (Bot*)calloc((size_t)total_bots, sizeof(Bot));
+    if (!bots) {
+        fprintf(stderr, "[LoadGen] 메모리 할당 실패\n");
+        return 1;
+    }
+
+    // 봇을 워커에 고르게 나눔 (습격 연결은 뒤쪽)
+    unsigned int run_id = (unsigned int)getpid() % 100000;
+    for (int i = 0; i < total_bots; i++) {
+        Bot *bot = &bots[i];
+        bot->fd = -1;
+        bot->raider = (i >= connection_count);
+        bot->raids_left = games_per_connection;
+        bot->waiting = LATENCY_KINDS;
+        bot->rng = 2654435761u * (uint32_t)(i + 1) ^ run_id;
+        if (bot->rng == 0) bot->rng = 1;
+        snprintf(bot->username, sizeof(bot->username), "lg%u_%d", run_id, i);
+        output_buffer_init(&bot->out);
+    }
+    int per_worker = total_bots / thread_count;
+    int extra = total_bots % thread_count;
+    int next = 0;
+    for (int i = 0; i < thread_count; i++) {
+        Worker *worker = &workers[i];
+        worker->id = i;
+        worker->bots = &bots[next];
+        worker->bot_count = per_worker + (i < extra ? 1 : 0);
+        worker->active = worker->bot_count;
+        next += worker->bot_count;
+        for (int j = 0; j < worker->bot_count; j++) worker->bots[j].worker = worker;
+        for (int k = 0; k < LATENCY_KINDS; k++) histogram_init(&worker->latency[k]);
+        json_arena_init(&worker->json_arena, JSON_ARENA_CHUNK_SIZE);
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (worker->epoll_fd < 0) {
+            perror("[LoadGen] epoll_create1");
+            return 1;
+        }
+    }
+
+    printf("[LoadGen] %s:%d에 봇 %d개%s, 워커 %d개, 목표 %llu판\n", server_ip, server_port, connection_count,
+           fuzz_mode ? " (+ 습격 연결)" : "", thread_count, (unsigned long long)game_target);
+
+    uint64_t start = monotonic_ns();
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+            perror("[LoadGen] pthread_create");
+            return 1;
+        }
+    }
+
+    // 1초마다 진행 상황
+    int finished = 0;
+    while (!finished) {
+        struct timespec wait = { 1, 0 };
+        nanosleep(&wait, NULL);
+        double elapsed = (monotonic_ns() - start) / 1e9;
+        if (duration_limit > 0.0 && elapsed >= duration_limit) stop_requested = 1;
+        finished = 1;
+        int active = 0;
+        for (int i = 0; i < thread_count; i++) active += __atomic_load_n(&workers[i].active, __ATOMIC_RELAXED);
+        if (active > 0) finished = 0;
+        LoadStats stats;
+        collect_stats(&stats);
+        printf("[LoadGen] %5.1fs  대국 %llu  수 %llu  활성 연결 %d\n", elapsed,
+               (unsigned long long)stats.games, (unsigned long long)stats.moves, active);
+        fflush(stdout);
+    }
+    for (int i = 0; i < thread_count; i++) pthread_join(workers[i].thread, NULL);
+    double elapsed = (monotonic_ns() - start) / 1e9;
+    print_report(elapsed);
+
+    LoadStats stats;
+    collect_stats(&stats);
+    for (int i = 0; i < total_bots; i++) {
+        framer_destroy(&bots[i].in);
+        output_buffer_destroy(&bots[i].out);
+        free(bots[i].trickle);
+    }
+    for (int i = 0; i < thread_count; i++) {
+        close(workers[i].epoll_fd);
+        json_arena_destroy(&workers[i].json_arena);
+    }
+    free(bots);
+
+    int failed = stats.invalid_moves > 0 || stats.nacks > 0 || stats.disconnects > 0 || stats.connect_failures > 0 ||
+                 stats.delta_lost > 0 ||
+                 stats.raids_closed < stats.raids || stats.probes_closed < stats.probes ||
+                 (!stop_requested && stats.games < game_target);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lobby.h"
+
+// 원형 큐. 가득 차면 두 배로 늘린다.
+static Client **queue = NULL;
+static int queue_capacity = 0;
+static int queue_head = 0;
+static int queue_count = 0;
+
+static int lobby_grow(void) {
+    int new_capacity = queue_capacity ? queue_capacity * 2 : 64;
+    Client **new_queue = (Client**)malloc(sizeof(Client*) * new_capacity);
+    if (!new_queue) return -1;
+    for (int i = 0; i < queue_count; i++) {
+        new_queue[i] = queue[(queue_head + i) % queue_capacity];
+    }
+    free(queue);
+    queue = new_queue;
+    queue_capacity = new_capacity;
+    queue_head = 0;
+    return 0;
+}
+
+int lobby_add(Client *client) {
+    if (queue_count == queue_capacity && lobby_grow() != 0) return -1;
+    queue[(queue_head + queue_count) % queue_capacity] = client;
+    queue_count++;
+    return 0;
+}
+
+int lobby_remove(Client *client) {
+    for (int i = 0; i < queue_count; i++) {
+        if (queue[(queue_head + i) % queue_capacity] != client) continue;
+        // 뒤쪽 항목을 한 칸씩 당겨 순서 유지
+        for (int j = i; j < queue_count - 1; j++) {
+            queue[(queue_head + j) % queue_capacity] = queue[(queue_head + j + 1) % queue_capacity];
+        }
+        queue_count--;
+        return 1;
+    }
+    return 0;
+}
+
+int lobby_pop_pair(Client **first, Client **second) {
+    if (queue_count < 2) return 0;
+    *first = queue[queue_head];
+    *second = queue[(queue_head + 1) % queue_capacity];
+    queue_head = (queue_head + 2) % queue_capacity;
+    queue_count -= 2;
+    return 1;
+}
+
+int lobby_size(void) {
+    return queue_count;
+}
@@ -0,0 +1,20 @@
+#ifndef LOBBY_H
+#define LOBBY_H
+
+#include "game_session.h"
+
+// 등록을 마치고 상대를 기다리는 플레이어 대기열 (먼저 온 순서대로 매칭)
+
+// 대기열 끝에 추가. 실패 시 -1
+int lobby_add(Client *client);
+
+// 대기열에서 제거 (대기 중 연결 종료 등). 없으면 0, 제거하면 1
+int lobby_remove(Client *client);
+
+// 대기 중인 두 명을 꺼냄. 먼저 온 쪽이 first(선공). 두 명이 안 되면 0
+int lobby_pop_pair(Client **first, Client **second);
+
+// 대기 인원
+int lobby_size(void);
+
+#endif /* LOBBY_H */
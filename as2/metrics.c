@@ -0,0 +1,288 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "metrics.h"
+
+#define ADMIN_REQUEST_SIZE 2048
+
+int metrics_enabled = 0;
+
+static MetricsShard *shards;
+static int shard_count;
+static int admin_fd = -1;
+
+static const struct {
+    const char *name;
+    const char *help;
+} histogram_info[METRIC_HISTOGRAMS] = {
+    { "octaflip_message_parse_seconds", "Time to decode one client message." },
+    { "octaflip_move_validate_seconds", "Time to validate one move or pass." },
+    { "octaflip_message_handle_seconds", "Time to handle one client message, including building replies." },
+    { "octaflip_turn_think_seconds", "Time a player took for one turn." },
+    { "octaflip_game_duration_seconds", "Length of finished games." },
+};
+
+static const struct {
+    const char *name;
+    const char *help;
+} counter_info[METRIC_COUNTERS] = {
+    { "octaflip_connections_accepted_total", "Accepted client connections." },
+    { "octaflip_message_parse_errors_total", "Client messages that could not be decoded." },
+    { "octaflip_message_oversized_total", "Client messages dropped for exceeding the maximum frame size." },
+    { "octaflip_invalid_moves_total", "Moves answered with invalid_move." },
+    { "octaflip_turn_timeouts_total", "Turns that ran out of time." },
+    { "octaflip_games_started_total", "Games started." },
+    { "octaflip_games_finished_total", "Games finished or abandoned." },
+};
+
+static const struct {
+    const char *name;
+    const char *help;
+} gauge_info[METRIC_GAUGES] = {
+    { "octaflip_connections", "Open client connections." },
+    { "octaflip_games", "Games in progress." },
+    { "octaflip_spectators", "Open spectator connections." },
+};
+
+// Prometheus 히스토그램 경계 (초). HDR 칸을 이 경계로 모아 누적한다
+static const double bucket_bounds[] = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+    1e-3, 2.5e-3, 5e-3, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5,
+    1, 2.5, 5, 10, 30, 60, 300, 1800
+};
+
+// 경계만으로는 꼬리가 뭉개지므로 HDR 정밀도의 백분위도 따로 내보냄
+static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+int metrics_init(int count) {
+    if (posix_memalign((void**)&shards, 64, sizeof(MetricsShard) * (size_t)count) != 0) return -1;
+    memset(shards, 0, sizeof(MetricsShard) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        for (int kind = 0; kind < METRIC_HISTOGRAMS; kind++) histogram_init(&shards[i].histograms[kind]);
+    }
+    shard_count = count;
+    return 0;
+}
+
+MetricsShard* metrics_shard(int id) {
+    return &shards[id];
+}
+
+// ---- 출력 ----
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    int failed;
+} TextBuffer;
+
+static void text_printf(TextBuffer *text, const char *format, ...) {
+    if (text->failed) return;
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        size_t space = text->capacity - text->length;
+        int written = vsnprintf(text->data ? text->data + text->length : NULL, space, format, args);
+        va_end(args);
+        if (written < 0) {
+            text->failed = 1;
+            return;
+        }
+        if ((size_t)written < space) {
+            text->length += (size_t)written;
+            return;
+        }
+        size_t capacity = text->capacity ? text->capacity * 2 : 16 * 1024;
+        while (capacity < text->length + (size_t)written + 1) capacity *= 2;
+        char *data = (char*)realloc(text->data, capacity);
+        if (!data) {
+            text->failed = 1;
+            return;
+        }
+        text->data = data;
+        text->capacity = capacity;
+    }
+}
+
+static void render_histogram(TextBuffer *text, int kind) {
+    Histogram merged;
+    histogram_init(&merged);
+    for (int i = 0; i < shard_count; i++) histogram_merge(&merged, &shards[i].histograms[kind]);
+
+    const char *name = histogram_info[kind].name;
+    text_printf(text, "# HELP %s %s\n# TYPE %s histogram\n", name, histogram_info[kind].help, name);
+    uint64_t cumulative = 0;
+    int index = 0;
+    for (size_t b = 0; b < sizeof(bucket_bounds) / sizeof(bucket_bounds[0]); b++) {
+        uint64_t bound_ns = (uint64_t)(bucket_bounds[b] * 1e9);
+        while (index < HISTOGRAM_BUCKETS && histogram_bucket_upper(index) <= bound_ns) {
+            cumulative += merged.counts[index++];
+        }
+        text_printf(text, "%s_bucket{le=\"%g\"} %llu\n", name, bucket_bounds[b], (unsigned long long)cumulative);
+    }
+    // +Inf와 count는 칸 합계로 (기록 중에 합쳐도 bucket과 어긋나지 않게)
+    while (index < HISTOGRAM_BUCKETS) cumulative += merged.counts[index++];
+    text_printf(text, "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)cumulative);
+    text_printf(text, "%s_sum %.9f\n", name, merged.sum / 1e9);
+    text_printf(text, "%s_count %llu\n", name, (unsigned long long)cumulative);
+
+    text_printf(text, "# HELP %s_quantile %s (HDR percentiles since start)\n# TYPE %s_quantile gauge\n",
+                name, histogram_info[kind].help, name);
+    for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+        text_printf(text, "%s_quantile{quantile=\"%g\"} %.9f\n", name, quantiles[q],
+                    histogram_percentile(&merged, quantiles[q] * 100.0) / 1e9);
+    }
+    text_printf(text, "%s_quantile{quantile=\"1\"} %.9f\n", name, merged.max / 1e9);
+}
+
+char* metrics_render(size_t *length) {
+    TextBuffer text = { NULL, 0, 0, 0 };
+
+    text_printf(&text, "# HELP octaflip_messages_received_total Client messages received, by type.\n");
+    text_printf(&text, "# TYPE octaflip_messages_received_total counter\n");
+    for (int type = 0; type < METRIC_MESSAGE_TYPES; type++) {
+        uint64_t total = 0;
+        for (int i = 0; i < shard_count; i++) total += __atomic_load_n(&shards[i].messages[type], __ATOMIC_RELAXED);
+        // 클라이언트가 보낼 일이 없는 유형은 0이면 생략
+        if (total == 0 && type != MSG_REGISTER && type != MSG_MOVE && type != MSG_SPECTATE) continue;
+        text_printf(&text, "octaflip_messages_received_total{type=\"%s\"} %llu\n",
+                    messageTypeName((MessageType)type), (unsigned long long)total);
+    }
+
+    for (int counter = 0; counter < METRIC_COUNTERS; counter++) {
+        uint64_t total = 0;
+        for (int i = 0; i < shard_count; i++) total += __atomic_load_n(&shards[i].counters[counter], __ATOMIC_RELAXED);
+        text_printf(&text, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", counter_info[counter].name,
+                    counter_info[counter].help, counter_info[counter].name, counter_info[counter].name,
+                    (unsigned long long)total);
+    }
+
+    for (int gauge = 0; gauge < METRIC_GAUGES; gauge++) {
+        int64_t total = 0;
+        for (int i = 0; i < shard_count; i++) total += __atomic_load_n(&shards[i].gauges[gauge], __ATOMIC_RELAXED);
+        text_printf(&text, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n", gauge_info[gauge].name,
+                    gauge_info[gauge].help, gauge_info[gauge].name, gauge_info[gauge].name,
+                    (long long)(total < 0 ? 0 : total));
+    }
+
+    for (int kind = 0; kind < METRIC_HISTOGRAMS; kind++) render_histogram(&text, kind);
+
+    if (text.failed) {
+        free(text.data);
+        return NULL;
+    }
+    *length = text.length;
+    return text.data;
+}
+
+// ---- 관리 소켓 ----
+
+static int send_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return 0;
+}
+
+// HTTP 요청 하나에 응답하고 닫음 (Prometheus 스크레이프는 요청마다 새 연결이어도 충분)
+static void serve_request(int fd) {
+    char request[ADMIN_REQUEST_SIZE];
+    size_t received = 0;
+    while (received < sizeof(request) - 1) {
+        ssize_t n = recv(fd, request + received, sizeof(request) - 1 - received, 0);
+        if (n <= 0) break;
+        received += (size_t)n;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) break;
+    }
+    request[received] = '\0';
+
+    char header[256];
+    if (strncmp(request, "GET /metrics", 12) != 0 && strncmp(request, "GET / ", 6) != 0) {
+        int length = snprintf(header, sizeof(header),
+                              "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\n"
+                              "Connection: close\r\n\r\nnot found\n");
+        send_all(fd, header, (size_t)length);
+        return;
+    }
+
+    size_t body_length = 0;
+    char *body = metrics_render(&body_length);
+    if (!body) {
+        int length = snprintf(header, sizeof(header),
+                              "HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        send_all(fd, header, (size_t)length);
+        return;
+    }
+    int length = snprintf(header, sizeof(header),
+                          "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                          "Content-Length: %zu\r\nConnection: close\r\n\r\n", body_length);
+    if (send_all(fd, header, (size_t)length) == 0) send_all(fd, body, body_length);
+    free(body);
+}
+
+static void *admin_main(void *arg __attribute__((unused))) {
+    for (;;) {
+        int fd = accept(admin_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("[Metrics] accept");
+            return NULL;
+        }
+        // 요청을 끝까지 안 보내는 연결이 관리 스레드를 붙잡지 못하게
+        struct timeval timeout = { 2, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        serve_request(fd);
+        close(fd);
+    }
+}
+
+int metrics_serve(int port) {
+    admin_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (admin_fd < 0) {
+        perror("[Metrics] socket");
+        return -1;
+    }
+    int opt = 1;
+    setsockopt(admin_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    // 관리 소켓은 로컬에서만
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(admin_fd, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(admin_fd, 16) < 0) {
+        perror("[Metrics] bind/listen");
+        close(admin_fd);
+        admin_fd = -1;
+        return -1;
+    }
+
+    metrics_enabled = 1;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, admin_main, NULL) != 0) {
+        metrics_enabled = 0;
+        close(admin_fd);
+        admin_fd = -1;
+        return -1;
+    }
+    pthread_detach(thread);
+    return 0;
+}
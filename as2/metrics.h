@@ -0,0 +1,89 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include "histogram.h"
+#include "message_handler.h"
+#include "timer_queue.h"
+
+// 서버 계측. 리액터마다 MetricsShard 하나를 두고 그 리액터 스레드만 쌓으므로 쓰는 쪽끼리 경합이 없다
+// (값은 원자적 덧셈이라 락도 없음). 관리 소켓(-a)을 켜면 전용 스레드가 요청마다 모든 샤드를 합쳐
+// Prometheus 텍스트 형식으로 내보낸다. 게이지는 샤드마다 증감만 하고 합이 실제 값이다
+// (연결은 로비에서 늘고 게임 샤드에서 줄어들 수 있음).
+// 카운터와 게이지는 항상 세고, 시간 측정(monotonic_ns 호출)은 관리 소켓을 켰을 때만 한다.
+
+typedef enum {
+    METRIC_PARSE = 0,         // 메시지 하나 디코드
+    METRIC_VALIDATE,          // 이동 검증 (isValidMove, 패스면 hasValidMove)
+    METRIC_HANDLE,            // 메시지 하나 처리 전체 (응답 직렬화 포함, 전송 제외)
+    METRIC_THINK,             // 플레이어가 한 턴에 쓴 시간
+    METRIC_GAME,              // 대국 길이
+    METRIC_HISTOGRAMS
+} MetricHistogram;
+
+typedef enum {
+    COUNTER_CONNECTIONS = 0,  // 받은 연결
+    COUNTER_PARSE_ERRORS,     // JSON/바이너리로 읽을 수 없는 메시지
+    COUNTER_OVERSIZED,        // max_frame을 넘어 버린 메시지
+    COUNTER_INVALID_MOVES,
+    COUNTER_TIMEOUTS,
+    COUNTER_GAMES_STARTED,
+    COUNTER_GAMES_FINISHED,
+    METRIC_COUNTERS
+} MetricCounter;
+
+typedef enum {
+    GAUGE_CONNECTIONS = 0,
+    GAUGE_GAMES,
+    GAUGE_SPECTATORS,
+    METRIC_GAUGES
+} MetricGauge;
+
+#define METRIC_MESSAGE_TYPES (MSG_UNKNOWN + 1)
+
+typedef struct {
+    Histogram histograms[METRIC_HISTOGRAMS];
+    uint64_t messages[METRIC_MESSAGE_TYPES];  // 받은 메시지 (유형별)
+    uint64_t counters[METRIC_COUNTERS];
+    int64_t gauges[METRIC_GAUGES];
+} __attribute__((aligned(64))) MetricsShard;
+
+extern int metrics_enabled;   // 관리 소켓이 켜져 있어 시간을 잼
+
+// 샤드 count개 할당 (리액터 번호가 곧 샤드 번호). 실패 시 -1
+int metrics_init(int count);
+MetricsShard* metrics_shard(int id);
+
+// 127.0.0.1:port에서 관리 소켓 스레드 시작 (GET /metrics). 실패 시 -1
+int metrics_serve(int port);
+
+// 모든 샤드를 합친 Prometheus 텍스트 (호출자가 free). 실패 시 NULL
+char* metrics_render(size_t *length);
+
+static inline void metrics_count(MetricsShard *shard, MetricCounter counter) {
+    __atomic_add_fetch(&shard->counters[counter], 1, __ATOMIC_RELAXED);
+}
+
+static inline void metrics_gauge(MetricsShard *shard, MetricGauge gauge, int64_t delta) {
+    __atomic_add_fetch(&shard->gauges[gauge], delta, __ATOMIC_RELAXED);
+}
+
+static inline void metrics_message(MetricsShard *shard, MessageType type) {
+    if ((unsigned int)type >= METRIC_MESSAGE_TYPES) type = MSG_UNKNOWN;
+    __atomic_add_fetch(&shard->messages[type], 1, __ATOMIC_RELAXED);
+}
+
+static inline void metrics_record(MetricsShard *shard, MetricHistogram kind, uint64_t ns) {
+    if (metrics_enabled) histogram_record(&shard->histograms[kind], ns);
+}
+
+// 구간 측정: 꺼져 있으면 시계를 읽지 않고 0
+static inline uint64_t metrics_start(void) {
+    return metrics_enabled ? monotonic_ns() : 0;
+}
+
+static inline void metrics_finish(MetricsShard *shard, MetricHistogram kind, uint64_t start) {
+    if (start) histogram_record(&shard->histograms[kind], monotonic_ns() - start);
+}
+
+#endif /* METRICS_H */
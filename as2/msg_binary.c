@@ -0,0 +1,159 @@
+#include <string.h>
+#include "msg_binary.h"
+
+// 서버 쪽 보드(octaflip.h)에는 막힌 칸이 없지만 형식은 클라이언트 보드와 같이 둔다
+#ifndef BLOCKED_CELL
+#define BLOCKED_CELL '#'
+#endif
+
+// CAPABILITY_* 비트 순서대로
+static const char *capability_names[] = { "binary", "delta" };
+
+static void put_raw(BinaryWriter *writer, const void *bytes, size_t len) {
+    if (writer->overflow || writer->length + len > writer->capacity) {
+        writer->overflow = 1;
+        return;
+    }
+    memcpy(writer->data + writer->length, bytes, len);
+    writer->length += len;
+}
+
+void binary_begin(BinaryWriter *writer, unsigned char *data, size_t capacity, BinaryType type) {
+    writer->data = data;
+    writer->capacity = capacity;
+    writer->length = BINARY_HEADER_SIZE;    // 길이는 binary_end에서
+    writer->overflow = (capacity < BINARY_HEADER_SIZE);
+    binary_put_u8(writer, type);
+}
+
+void binary_put_u8(BinaryWriter *writer, unsigned int value) {
+    unsigned char byte = (unsigned char)value;
+    put_raw(writer, &byte, 1);
+}
+
+void binary_put_u16(BinaryWriter *writer, unsigned int value) {
+    unsigned char bytes[2] = { (unsigned char)(value >> 8), (unsigned char)value };
+    put_raw(writer, bytes, sizeof(bytes));
+}
+
+void binary_put_u32(BinaryWriter *writer, uint32_t value) {
+    unsigned char bytes[4] = { (unsigned char)(value >> 24), (unsigned char)(value >> 16),
+                               (unsigned char)(value >> 8), (unsigned char)value };
+    put_raw(writer, bytes, sizeof(bytes));
+}
+
+void binary_put_u64(BinaryWriter *writer, uint64_t value) {
+    binary_put_u32(writer, (uint32_t)(value >> 32));
+    binary_put_u32(writer, (uint32_t)value);
+}
+
+void binary_put_string(BinaryWriter *writer, const char *string) {
+    if (!string) {
+        binary_put_u8(writer, BINARY_NULL_STRING);
+        return;
+    }
+    size_t length = strlen(string);
+    if (length > BINARY_MAX_STRING) {
+        writer->overflow = 1;
+        return;
+    }
+    binary_put_u8(writer, (unsigned int)length);
+    put_raw(writer, string, length + 1);    // '\0'까지
+}
+
+void binary_put_board(BinaryWriter *writer, const GameBoard *board) {
+    unsigned char packed[BINARY_BOARD_SIZE];
+    binary_pack_board(packed, board);
+    put_raw(writer, packed, sizeof(packed));
+}
+
+void binary_put_move(BinaryWriter *writer, const Move *move) {
+    unsigned char coords[4] = { (unsigned char)move->sourceRow, (unsigned char)move->sourceCol,
+                                (unsigned char)move->targetRow, (unsigned char)move->targetCol };
+    put_raw(writer, coords, sizeof(coords));
+}
+
+void binary_put_board_update(BinaryWriter *writer, const GameBoard *board, const BoardDelta *delta) {
+    BoardUpdateKind kind = delta ? delta->kind : BOARD_UPDATE_FULL;
+    binary_put_u8(writer, kind);
+    switch (kind) {
+        case BOARD_UPDATE_FULL:
+            binary_put_board(writer, board);
+            break;
+        case BOARD_UPDATE_SNAPSHOT:
+            binary_put_board(writer, board);
+            binary_put_u32(writer, delta->seq);
+            binary_put_u64(writer, delta->hash);
+            break;
+        case BOARD_UPDATE_MOVE:
+            binary_put_u32(writer, delta->seq);
+            binary_put_u64(writer, delta->hash);
+            binary_put_move(writer, &delta->move);
+            binary_put_u64(writer, delta->flipped);
+            break;
+        case BOARD_UPDATE_SAME:
+            binary_put_u32(writer, delta->seq);
+            binary_put_u64(writer, delta->hash);
+            break;
+    }
+}
+
+size_t binary_end(BinaryWriter *writer) {
+    size_t body = writer->length - BINARY_HEADER_SIZE;
+    if (writer->overflow || body > 0xFFFF) return 0;
+    writer->data[0] = (unsigned char)(body >> 8);
+    writer->data[1] = (unsigned char)body;
+    return writer->length;
+}
+
+static void put_mask(unsigned char *out, uint64_t mask) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (unsigned char)(mask >> (56 - 8 * i));
+    }
+}
+
+static uint64_t get_mask(const unsigned char *in) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 8; i++) {
+        mask = (mask << 8) | in[i];
+    }
+    return mask;
+}
+
+void binary_pack_board(unsigned char out[BINARY_BOARD_SIZE], const GameBoard *board) {
+    uint64_t red, blue, blocked;
+    board_masks(board, &red, &blue, &blocked);
+    put_mask(out, red);
+    put_mask(out + 8, blue);
+    put_mask(out + 16, blocked);
+}
+
+void binary_unpack_board(const unsigned char in[BINARY_BOARD_SIZE], GameBoard *board) {
+    uint64_t red = get_mask(in);
+    uint64_t blue = get_mask(in + 8);
+    uint64_t blocked = get_mask(in + 16);
+    for (int row = 0; row < BOARD_SIZE; row++) {
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            uint64_t bit = 1ull << (row * BOARD_SIZE + col);
+            char cell = EMPTY_CELL;
+            if (red & bit) cell = RED_PLAYER;
+            else if (blue & bit) cell = BLUE_PLAYER;
+            else if (blocked & bit) cell = BLOCKED_CELL;
+            board->cells[row][col] = cell;
+        }
+        board->cells[row][BOARD_SIZE] = '\0';
+    }
+    countPieces(board);
+}
+
+unsigned int parseCapabilityName(const char *name, size_t length) {
+    for (unsigned int i = 0; i < sizeof(capability_names) / sizeof(capability_names[0]); i++) {
+        if (strlen(capability_names[i]) == length && memcmp(name, capability_names[i], length) == 0) return 1u << i;
+    }
+    return 0;
+}
+
+const char* capabilityName(unsigned int index) {
+    if (index >= sizeof(capability_names) / sizeof(capability_names[0])) return NULL;
+    return capability_names[index];
+}
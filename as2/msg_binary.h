@@ -0,0 +1,72 @@
+#ifndef MSG_BINARY_H
+#define MSG_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "message_handler.h"
+#include "board_delta.h"
+
+// register / register_ack의 capabilities로 협상하는 바이너리 프레이밍 (기본은 JSON 줄).
+// 클라이언트가 register에 "capabilities":["binary"]를 넣고, 서버가 register_ack(JSON)에 같은 값을
+// 돌려주면 그 다음 바이트부터는 양방향 모두 바이너리 프레임만 오간다.
+//
+// 프레임: [길이 2바이트][유형 1바이트][필드...]   길이는 유형 바이트부터 센 바이트 수
+// 정수는 빅엔디언, 보드는 빨강/파랑/막힘 칸 64비트 마스크 3개 (비트 = 행*8+열),
+// 이동은 sx, sy, tx, ty 1바이트씩 (JSON과 같은 1부터 시작하는 좌표, 패스는 0,0,0,0).
+// 문자열은 길이 1바이트 + 바이트 + '\0' (받는 쪽이 복사 없이 C 문자열로 가리킬 수 있게), null은 길이 0xFF.
+// 보드 자리에는 BoardUpdateKind 1바이트가 먼저 오고 (board_delta.h)
+//   FULL: 보드   SNAPSHOT: 보드, seq(4), hash(8)   MOVE: seq, hash, 이동, flipped(8)   SAME: seq, hash
+
+#define CAPABILITY_BINARY       (1u << 0)
+#define CAPABILITY_DELTA        (1u << 1)   // 보드 델타 (board_delta.h)
+
+#define BINARY_HEADER_SIZE      2
+#define BINARY_BOARD_SIZE       24
+#define BINARY_NULL_STRING      0xFF
+#define BINARY_MAX_STRING       254
+
+typedef enum {
+    BINARY_REGISTER = 1,        // username
+    BINARY_MOVE,                // move (username 없음: 연결로 식별)
+    BINARY_REGISTER_ACK,
+    BINARY_REGISTER_NACK,       // reason
+    BINARY_GAME_START,          // players[2], first_player
+    BINARY_YOUR_TURN,           // 보드, timeout(ms, 4바이트)
+    BINARY_MOVE_OK,             // 보드, next_player
+    BINARY_INVALID_MOVE,        // 보드, next_player
+    BINARY_PASS,                // next_player
+    BINARY_GAME_OVER,           // (이름, 점수 2바이트) x 2
+    BINARY_OPPONENT_LEFT        // username
+} BinaryType;
+
+// 고정 버퍼에 프레임 하나를 쓰는 도우미. 넘치면 overflow만 세우고 나머지는 무시
+typedef struct {
+    unsigned char *data;
+    size_t capacity;
+    size_t length;
+    int overflow;
+} BinaryWriter;
+
+void binary_begin(BinaryWriter *writer, unsigned char *data, size_t capacity, BinaryType type);
+void binary_put_u8(BinaryWriter *writer, unsigned int value);
+void binary_put_u16(BinaryWriter *writer, unsigned int value);
+void binary_put_u32(BinaryWriter *writer, uint32_t value);
+void binary_put_u64(BinaryWriter *writer, uint64_t value);
+void binary_put_string(BinaryWriter *writer, const char *string);     // NULL이면 null
+void binary_put_board(BinaryWriter *writer, const GameBoard *board);
+void binary_put_move(BinaryWriter *writer, const Move *move);
+// 보드 자리: 종류 바이트 + 내용 (delta가 NULL이면 FULL)
+void binary_put_board_update(BinaryWriter *writer, const GameBoard *board, const BoardDelta *delta);
+// 길이 헤더를 채우고 프레임 전체 크기를 돌려줌 (넘쳤으면 0)
+size_t binary_end(BinaryWriter *writer);
+
+void binary_pack_board(unsigned char out[BINARY_BOARD_SIZE], const GameBoard *board);
+// cells만 채우고 말 개수를 다시 셈
+void binary_unpack_board(const unsigned char in[BINARY_BOARD_SIZE], GameBoard *board);
+
+// capabilities 문자열 하나 → 비트 (모르는 이름은 0)
+unsigned int parseCapabilityName(const char *name, size_t length);
+// 비트 → 이름 (index번째 비트, 없으면 NULL)
+const char* capabilityName(unsigned int index);
+
+#endif /* MSG_BINARY_H */
@@ -0,0 +1,766 @@
+#include <stdlib.h>
+#include <string.h>
+#include "msg_decoder.h"
+#include "msg_binary.h"
+#include "json_scan.h"
+
+#define DECODER_MAX_STRINGS 16      // 한 메시지에서 '\0'으로 끝낼 문자열 뷰 최대 개수
+#define DECODER_MAX_DEPTH 8         // 모르는 필드를 건너뛸 때 허용하는 중첩 깊이
+
+typedef struct {
+    char *p;
+    char *terminators[DECODER_MAX_STRINGS];    // 성공하면 '\0'을 쓸 닫는 따옴표 위치
+    int terminator_count;
+} Decoder;
+
+static void skip_whitespace(Decoder *d) {
+    d->p = (char*)json_scan_whitespace(d->p);
+}
+
+// 따옴표로 둘러싼 문자열 범위. 이스케이프가 있으면 빠른 경로 포기
+static int scan_string(Decoder *d, char **start, size_t *length) {
+    if (*d->p != '"') return 0;
+    char *begin = d->p + 1;
+    char *end = (char*)json_scan_string(begin);
+    if (*end != '"') return 0;
+    *start = begin;
+    *length = (size_t)(end - begin);
+    d->p = end + 1;
+    return 1;
+}
+
+// 문자열 뷰: 성공 시 닫는 따옴표 자리가 '\0'이 된다
+static int view_string(Decoder *d, const char **out) {
+    char *start;
+    size_t length;
+    if (d->terminator_count == DECODER_MAX_STRINGS || !scan_string(d, &start, &length)) return 0;
+    d->terminators[d->terminator_count++] = start + length;
+    *out = start;
+    return 1;
+}
+
+// 정수는 직접 읽고, 소수/지수가 붙으면 strtod로
+static int scan_number(Decoder *d, double *value) {
+    char *start = d->p;
+    char *c = start;
+    int negative = (*c == '-');
+    if (negative) c++;
+    if (*c < '0' || *c > '9') return 0;
+
+    long long integer = 0;
+    int digits = 0;
+    while (*c >= '0' && *c <= '9') {
+        // 15자리를 넘으면 어차피 strtod로 넘어가므로 더 쌓지 않음 (긴 숫자로 long long이 넘치지 않게)
+        if (digits < 15) integer = integer * 10 + (*c - '0');
+        c++;
+        digits++;
+    }
+    if (*c == '.' || *c == 'e' || *c == 'E' || digits > 15) {
+        char *end;
+        *value = strtod(start, &end);
+        if (end == start) return 0;
+        d->p = end;
+        return 1;
+    }
+    *value = (double)(negative ? -integer : integer);
+    d->p = c;
+    return 1;
+}
+
+static int match_literal(Decoder *d, const char *literal, size_t length) {
+    if (strncmp(d->p, literal, length) != 0) return 0;
+    d->p += length;
+    return 1;
+}
+
+// 관심 없는 값 건너뛰기
+static int skip_value(Decoder *d, int depth) {
+    char *start;
+    size_t length;
+    double number;
+
+    skip_whitespace(d);
+    switch (*d->p) {
+        case '"':
+            return scan_string(d, &start, &length);
+        case 't':
+            return match_literal(d, "true", 4);
+        case 'f':
+            return match_literal(d, "false", 5);
+        case 'n':
+            return match_literal(d, "null", 4);
+        case '[':
+        case '{': {
+            char close = (*d->p == '[') ? ']' : '}';
+            if (depth >= DECODER_MAX_DEPTH) return 0;
+            d->p++;
+            skip_whitespace(d);
+            if (*d->p == close) {
+                d->p++;
+                return 1;
+            }
+            while (1) {
+                if (close == '}') {
+                    skip_whitespace(d);
+                    if (!scan_string(d, &start, &length)) return 0;
+                    skip_whitespace(d);
+                    if (*d->p != ':') return 0;
+                    d->p++;
+                }
+                if (!skip_value(d, depth + 1)) return 0;
+                skip_whitespace(d);
+                if (*d->p == close) {
+                    d->p++;
+                    return 1;
+                }
+                if (*d->p != ',') return 0;
+                d->p++;
+            }
+        }
+        default:
+            return scan_number(d, &number);
+    }
+}
+
+// 배열 순회: 원소마다 callback(index). 원소 앞 공백은 건너뛴 상태로 부른다. 원소 개수를 돌려줌 (-1은 형식 오류)
+typedef int (*ElementDecoder)(Decoder *d, int index, void *user);
+
+static int decode_array(Decoder *d, ElementDecoder element, void *user) {
+    if (*d->p != '[') return -1;
+    d->p++;
+    skip_whitespace(d);
+    if (*d->p == ']') {
+        d->p++;
+        return 0;
+    }
+    int count = 0;
+    while (1) {
+        skip_whitespace(d);
+        if (!element(d, count, user)) return -1;
+        count++;
+        skip_whitespace(d);
+        if (*d->p == ']') {
+            d->p++;
+            return count;
+        }
+        if (*d->p != ',') return -1;
+        d->p++;
+    }
+}
+
+typedef struct {
+    DecodedMessage *message;
+    int all_strings;
+} ArrayState;
+
+// board 행: 앞 8칸만 복사 (짧으면 '\0'으로 채움, strncpy와 같음)
+static int decode_board_row(Decoder *d, int index, void *user) {
+    ArrayState *state = (ArrayState*)user;
+    if (*d->p != '"') {
+        state->all_strings = 0;
+        return skip_value(d, 1);
+    }
+    char *start;
+    size_t length;
+    if (!scan_string(d, &start, &length)) return 0;
+    if (index < BOARD_SIZE) {
+        char *row = state->message->board.cells[index];
+        size_t copy = (length < BOARD_SIZE) ? length : BOARD_SIZE;
+        memcpy(row, start, copy);
+        memset(row + copy, '\0', BOARD_SIZE + 1 - copy);
+    }
+    return 1;
+}
+
+static int decode_player_name(Decoder *d, int index, void *user) {
+    ArrayState *state = (ArrayState*)user;
+    if (*d->p != '"') {
+        state->all_strings = 0;
+        return skip_value(d, 1);
+    }
+    if (index < 2) return view_string(d, &state->message->players[index]);
+    char *start;
+    size_t length;
+    return scan_string(d, &start, &length);
+}
+
+// scores: 앞의 두 항목이 숫자여야 함
+static int decode_scores(Decoder *d, DecodedMessage *message) {
+    if (*d->p != '{') return skip_value(d, 0);
+    d->p++;
+    skip_whitespace(d);
+    int count = 0;
+    int valid = 1;
+    if (*d->p != '}') {
+        while (1) {
+            const char *key = NULL;
+            char *start;
+            size_t length;
+            skip_whitespace(d);
+            if (count < 2) {
+                if (!view_string(d, &key)) return 0;
+            } else if (!scan_string(d, &start, &length)) {
+                return 0;
+            }
+            skip_whitespace(d);
+            if (*d->p != ':') return 0;
+            d->p++;
+            skip_whitespace(d);
+
+            if (count < 2) {
+                double score;
+                if ((*d->p == '-' || (*d->p >= '0' && *d->p <= '9')) && scan_number(d, &score)) {
+                    message->players[count] = key;
+                    message->scores[count] = (int)score;
+                } else {
+                    valid = 0;
+                    if (!skip_value(d, 1)) return 0;
+                }
+            } else if (!skip_value(d, 1)) {
+                return 0;
+            }
+            count++;
+
+            skip_whitespace(d);
+            if (*d->p == '}') break;
+            if (*d->p != ',') return 0;
+            d->p++;
+        }
+    }
+    d->p++;
+    if (valid && count >= 2) message->fields |= DECODED_SCORES;
+    return 1;
+}
+
+static int decode_capability(Decoder *d, int index, void *user) {
+    (void)index;
+    ArrayState *state = (ArrayState*)user;
+    if (*d->p != '"') {
+        state->all_strings = 0;
+        return skip_value(d, 1);
+    }
+    char *start;
+    size_t length;
+    if (!scan_string(d, &start, &length)) return 0;
+    state->message->capabilities |= parseCapabilityName(start, length);
+    return 1;
+}
+
+// spectate의 games: 숫자만 받고, DECODED_MAX_GAMES개를 넘는 번호는 버림
+static int decode_game_id(Decoder *d, int index, void *user) {
+    (void)index;
+    ArrayState *state = (ArrayState*)user;
+    double id;
+    if (!(*d->p == '-' || (*d->p >= '0' && *d->p <= '9'))) {
+        state->all_strings = 0;
+        return skip_value(d, 1);
+    }
+    if (!scan_number(d, &id)) return 0;
+    DecodedMessage *message = state->message;
+    if (message->game_count < DECODED_MAX_GAMES) message->games[message->game_count++] = (int)id;
+    return 1;
+}
+
+// 숫자 필드: 숫자가 아니면 건너뛰고 플래그를 세우지 않음
+static int decode_number_field(Decoder *d, double *value, int *present) {
+    if (*d->p == '-' || (*d->p >= '0' && *d->p <= '9')) {
+        *present = 1;
+        return scan_number(d, value);
+    }
+    *present = 0;
+    return skip_value(d, 0);
+}
+
+static int decode_string_field(Decoder *d, const char **value, unsigned int flag, DecodedMessage *message) {
+    if (*d->p != '"') {
+        message->fields &= ~flag;
+        return skip_value(d, 0);
+    }
+    if (!view_string(d, value)) return 0;
+    message->fields |= flag;
+    return 1;
+}
+
+// 16진 문자열 (1~16자리) → 64비트
+static int parse_hex64(const char *start, size_t length, uint64_t *value) {
+    if (length == 0 || length > 16) return 0;
+    uint64_t result = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = start[i];
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return 0;
+        result = (result << 4) | (uint64_t)digit;
+    }
+    *value = result;
+    return 1;
+}
+
+// 16진 문자열 필드: 형식이 틀리면 건너뛰고 플래그를 세우지 않음
+static int decode_hex_field(Decoder *d, uint64_t *value, unsigned int flag, DecodedMessage *message) {
+    char *start;
+    size_t length;
+    message->fields &= ~flag;
+    if (*d->p != '"') return skip_value(d, 0);
+    if (!scan_string(d, &start, &length)) return 0;
+    if (parse_hex64(start, length, value)) message->fields |= flag;
+    return 1;
+}
+
+#define KEY_IS(start, length, literal) \
+    ((length) == sizeof(literal) - 1 && memcmp((start), (literal), sizeof(literal) - 1) == 0)
+
+int decodeMessage(char *line, DecodedMessage *message) {
+    Decoder d;
+    d.p = line;
+    d.terminator_count = 0;
+    memset(message, 0, sizeof(DecodedMessage));
+    message->type = MSG_UNKNOWN;
+
+    double coords[4];
+    int coord_present[4] = { 0, 0, 0, 0 };
+
+    skip_whitespace(&d);
+    if (*d.p != '{') return 0;
+    d.p++;
+    skip_whitespace(&d);
+
+    if (*d.p != '}') {
+        while (1) {
+            char *key;
+            size_t key_length;
+            skip_whitespace(&d);
+            if (!scan_string(&d, &key, &key_length)) return 0;
+            skip_whitespace(&d);
+            if (*d.p != ':') return 0;
+            d.p++;
+            skip_whitespace(&d);
+
+            int ok;
+            if (KEY_IS(key, key_length, "type")) {
+                char *type;
+                size_t type_length;
+                if (*d.p == '"') {
+                    ok = scan_string(&d, &type, &type_length);
+                    if (!ok) return 0;
+                    message->type = parseMessageTypeName(type, type_length);
+                } else {
+                    ok = skip_value(&d, 0);
+                    message->type = MSG_UNKNOWN;
+                }
+            } else if (KEY_IS(key, key_length, "username")) {
+                ok = decode_string_field(&d, &message->username, DECODED_USERNAME, message);
+            } else if (KEY_IS(key, key_length, "sx")) {
+                ok = decode_number_field(&d, &coords[0], &coord_present[0]);
+            } else if (KEY_IS(key, key_length, "sy")) {
+                ok = decode_number_field(&d, &coords[1], &coord_present[1]);
+            } else if (KEY_IS(key, key_length, "tx")) {
+                ok = decode_number_field(&d, &coords[2], &coord_present[2]);
+            } else if (KEY_IS(key, key_length, "ty")) {
+                ok = decode_number_field(&d, &coords[3], &coord_present[3]);
+            } else if (KEY_IS(key, key_length, "board")) {
+                ArrayState state = { message, 1 };
+                int count = (*d.p == '[') ? decode_array(&d, decode_board_row, &state) : -2;
+                if (count == -2) {
+                    ok = skip_value(&d, 0);
+                    message->fields &= ~DECODED_BOARD;
+                } else {
+                    ok = (count >= 0);
+                    if (count == BOARD_SIZE && state.all_strings) message->fields |= DECODED_BOARD;
+                    else message->fields &= ~DECODED_BOARD;
+                }
+            } else if (KEY_IS(key, key_length, "timeout")) {
+                int present;
+                ok = decode_number_field(&d, &message->timeout, &present);
+                if (present) message->fields |= DECODED_TIMEOUT;
+                else message->fields &= ~DECODED_TIMEOUT;
+            } else if (KEY_IS(key, key_length, "next_player")) {
+                if (*d.p == 'n') {
+                    ok = match_literal(&d, "null", 4);
+                    message->next_player = NULL;
+                    message->fields |= DECODED_NEXT_PLAYER;
+                } else {
+                    ok = decode_string_field(&d, &message->next_player, DECODED_NEXT_PLAYER, message);
+                }
+            } else if (KEY_IS(key, key_length, "reason")) {
+                ok = decode_string_field(&d, &message->reason, DECODED_REASON, message);
+            } else if (KEY_IS(key, key_length, "first_player")) {
+                ok = decode_string_field(&d, &message->first_player, DECODED_FIRST_PLAYER, message);
+            } else if (KEY_IS(key, key_length, "players")) {
+                ArrayState state = { message, 1 };
+                int count = (*d.p == '[') ? decode_array(&d, decode_player_name, &state) : -2;
+                if (count == -2) {
+                    ok = skip_value(&d, 0);
+                    message->fields &= ~DECODED_PLAYERS;
+                } else {
+                    ok = (count >= 0);
+                    if (count == 2 && state.all_strings) message->fields |= DECODED_PLAYERS;
+                    else message->fields &= ~DECODED_PLAYERS;
+                }
+            } else if (KEY_IS(key, key_length, "capabilities")) {
+                ArrayState state = { message, 1 };
+                message->capabilities = 0;
+                int count = (*d.p == '[') ? decode_array(&d, decode_capability, &state) : -2;
+                if (count == -2) {
+                    ok = skip_value(&d, 0);
+                    message->fields &= ~DECODED_CAPABILITIES;
+                } else {
+                    ok = (count >= 0);
+                    if (state.all_strings) message->fields |= DECODED_CAPABILITIES;
+                    else message->fields &= ~DECODED_CAPABILITIES;
+                }
+            } else if (KEY_IS(key, key_length, "games")) {
+                ArrayState state = { message, 1 };     // all_strings: 여기서는 모두 숫자인지
+                message->game_count = 0;
+                int count = (*d.p == '[') ? decode_array(&d, decode_game_id, &state) : -2;
+                if (count == -2) {
+                    ok = skip_value(&d, 0);
+                    message->fields &= ~DECODED_GAMES;
+                } else {
+                    ok = (count >= 0);
+                    if (state.all_strings) {
+                        message->fields |= DECODED_GAMES;
+                    } else {
+                        message->fields &= ~DECODED_GAMES;
+                        message->game_count = 0;
+                    }
+                }
+            } else if (KEY_IS(key, key_length, "seq")) {
+                double seq;
+                int present;
+                ok = decode_number_field(&d, &seq, &present);
+                if (present && seq >= 0) {
+                    message->seq = (uint32_t)seq;
+                    message->fields |= DECODED_SEQ;
+                } else {
+                    message->fields &= ~DECODED_SEQ;
+                }
+            } else if (KEY_IS(key, key_length, "hash")) {
+                ok = decode_hex_field(&d, &message->hash, DECODED_HASH, message);
+            } else if (KEY_IS(key, key_length, "flipped")) {
+                ok = decode_hex_field(&d, &message->flipped, DECODED_FLIPPED, message);
+            } else if (KEY_IS(key, key_length, "scores")) {
+                ok = decode_scores(&d, message);
+            } else {
+                ok = skip_value(&d, 0);
+            }
+            if (!ok) return 0;
+
+            skip_whitespace(&d);
+            if (*d.p == '}') break;
+            if (*d.p != ',') return 0;
+            d.p++;
+        }
+    }
+    d.p++;
+    skip_whitespace(&d);
+    if (*d.p != '\0') return 0;
+
+    // 여기까지 오면 성공: 뷰를 C 문자열로 만듦
+    for (int i = 0; i < d.terminator_count; i++) {
+        *d.terminators[i] = '\0';
+    }
+    if (coord_present[0] && coord_present[1] && coord_present[2] && coord_present[3]) {
+        message->move.sourceRow = (int)coords[0];
+        message->move.sourceCol = (int)coords[1];
+        message->move.targetRow = (int)coords[2];
+        message->move.targetCol = (int)coords[3];
+        message->fields |= DECODED_MOVE;
+    }
+    if (message->fields & DECODED_BOARD) countPieces(&message->board);
+    return 1;
+}
+
+static void tree_string(const JsonValue *json, const char *key, const char **out,
+                        unsigned int flag, DecodedMessage *message) {
+    const char *value = json_string_value(json_object_get(json, key));
+    if (value) {
+        *out = value;
+        message->fields |= flag;
+    }
+}
+
+void decodeMessageTree(const JsonValue *json, DecodedMessage *message) {
+    memset(message, 0, sizeof(DecodedMessage));
+    message->type = parseMessageType((JsonValue*)json);
+    if (!json_is_object(json)) return;
+
+    tree_string(json, "username", &message->username, DECODED_USERNAME, message);
+    tree_string(json, "reason", &message->reason, DECODED_REASON, message);
+    tree_string(json, "first_player", &message->first_player, DECODED_FIRST_PLAYER, message);
+
+    static const char *coord_keys[4] = { "sx", "sy", "tx", "ty" };
+    int coords[4];
+    int coord_count = 0;
+    for (int i = 0; i < 4; i++) {
+        JsonValue *coord = json_object_get(json, coord_keys[i]);
+        if (!json_is_number(coord)) break;
+        coords[i] = (int)json_number_value(coord);
+        coord_count++;
+    }
+    if (coord_count == 4) {
+        message->move.sourceRow = coords[0];
+        message->move.sourceCol = coords[1];
+        message->move.targetRow = coords[2];
+        message->move.targetCol = coords[3];
+        message->fields |= DECODED_MOVE;
+    }
+
+    JsonValue *timeout = json_object_get(json, "timeout");
+    if (json_is_number(timeout)) {
+        message->timeout = json_number_value(timeout);
+        message->fields |= DECODED_TIMEOUT;
+    }
+
+    JsonValue *next = json_object_get(json, "next_player");
+    if (json_is_null(next)) {
+        message->fields |= DECODED_NEXT_PLAYER;
+    } else if (json_is_string(next)) {
+        message->next_player = json_string_value(next);
+        message->fields |= DECODED_NEXT_PLAYER;
+    }
+
+    JsonValue *players = json_object_get(json, "players");
+    if (json_array_size(players) == 2 &&
+        json_is_string(json_array_get(players, 0)) && json_is_string(json_array_get(players, 1))) {
+        message->players[0] = json_string_value(json_array_get(players, 0));
+        message->players[1] = json_string_value(json_array_get(players, 1));
+        message->fields |= DECODED_PLAYERS;
+    }
+
+    JsonValue *board = json_object_get(json, "board");
+    if (json_array_size(board) == BOARD_SIZE) {
+        int rows = 0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            const char *row = json_string_value(json_array_get(board, i));
+            if (!row) break;
+            strncpy(message->board.cells[i], row, BOARD_SIZE);
+            message->board.cells[i][BOARD_SIZE] = '\0';
+            rows++;
+        }
+        if (rows == BOARD_SIZE) {
+            countPieces(&message->board);
+            message->fields |= DECODED_BOARD;
+        }
+    }
+
+    JsonValue *capabilities = json_object_get(json, "capabilities");
+    if (json_is_array(capabilities)) {
+        size_t count = json_array_size(capabilities);
+        size_t strings = 0;
+        for (size_t i = 0; i < count; i++) {
+            const char *name = json_string_value(json_array_get(capabilities, i));
+            if (!name) break;
+            message->capabilities |= parseCapabilityName(name, strlen(name));
+            strings++;
+        }
+        if (strings == count) message->fields |= DECODED_CAPABILITIES;
+        else message->capabilities = 0;
+    }
+
+    JsonValue *games = json_object_get(json, "games");
+    if (json_is_array(games)) {
+        size_t count = json_array_size(games);
+        size_t numbers = 0;
+        for (size_t i = 0; i < count; i++) {
+            JsonValue *id = json_array_get(games, i);
+            if (!json_is_number(id)) break;
+            if (message->game_count < DECODED_MAX_GAMES) message->games[message->game_count++] = (int)json_number_value(id);
+            numbers++;
+        }
+        if (numbers == count) message->fields |= DECODED_GAMES;
+        else message->game_count = 0;
+    }
+
+    JsonValue *seq = json_object_get(json, "seq");
+    if (json_is_number(seq) && json_number_value(seq) >= 0) {
+        message->seq = (uint32_t)json_number_value(seq);
+        message->fields |= DECODED_SEQ;
+    }
+    const char *hash = json_string_value(json_object_get(json, "hash"));
+    if (hash && parse_hex64(hash, strlen(hash), &message->hash)) message->fields |= DECODED_HASH;
+    const char *flipped = json_string_value(json_object_get(json, "flipped"));
+    if (flipped && parse_hex64(flipped, strlen(flipped), &message->flipped)) message->fields |= DECODED_FLIPPED;
+
+    JsonValue *scores = json_object_get(json, "scores");
+    if (json_object_size(scores) >= 2 &&
+        json_is_number(json_object_value(scores, 0)) && json_is_number(json_object_value(scores, 1))) {
+        for (int i = 0; i < 2; i++) {
+            message->players[i] = json_object_key(scores, i);
+            message->scores[i] = (int)json_number_value(json_object_value(scores, i));
+        }
+        message->fields |= DECODED_SCORES;
+    }
+}
+
+// 바이너리 프레임 읽기: 범위를 넘거나 형식이 틀리면 ok가 0이 되고 이후 값은 모두 0
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    int ok;
+} BinaryReader;
+
+static unsigned int read_u8(BinaryReader *r) {
+    if (!r->ok || r->p >= r->end) {
+        r->ok = 0;
+        return 0;
+    }
+    return *r->p++;
+}
+
+static unsigned int read_u16(BinaryReader *r) {
+    unsigned int high = read_u8(r);
+    return (high << 8) | read_u8(r);
+}
+
+static uint32_t read_u32(BinaryReader *r) {
+    uint32_t high = read_u16(r);
+    return (high << 16) | read_u16(r);
+}
+
+// 문자열 뷰 (프레임 안의 '\0'까지 포함된 바이트). null이면 NULL, allow_null이 아니면 오류
+static const char* read_string(BinaryReader *r, int allow_null) {
+    unsigned int length = read_u8(r);
+    if (!r->ok) return NULL;
+    if (length == BINARY_NULL_STRING) {
+        if (!allow_null) r->ok = 0;
+        return NULL;
+    }
+    if ((size_t)(r->end - r->p) < length + 1 || r->p[length] != '\0' ||
+        memchr(r->p, '\0', length) != NULL) {
+        r->ok = 0;
+        return NULL;
+    }
+    const char *string = (const char*)r->p;
+    r->p += length + 1;
+    return string;
+}
+
+static uint64_t read_u64(BinaryReader *r) {
+    uint64_t high = read_u32(r);
+    return (high << 32) | read_u32(r);
+}
+
+static void read_board(BinaryReader *r, GameBoard *board) {
+    if (!r->ok || (size_t)(r->end - r->p) < BINARY_BOARD_SIZE) {
+        r->ok = 0;
+        return;
+    }
+    binary_unpack_board(r->p, board);
+    r->p += BINARY_BOARD_SIZE;
+}
+
+// 보드 자리 (msg_binary.h). 들어 있던 필드 플래그를 돌려줌
+static unsigned int read_board_update(BinaryReader *r, DecodedMessage *message) {
+    unsigned int kind = read_u8(r);
+    switch (kind) {
+        case BOARD_UPDATE_FULL:
+            read_board(r, &message->board);
+            return DECODED_BOARD;
+        case BOARD_UPDATE_SNAPSHOT:
+            read_board(r, &message->board);
+            message->seq = read_u32(r);
+            message->hash = read_u64(r);
+            return DECODED_BOARD | DECODED_SEQ | DECODED_HASH;
+        case BOARD_UPDATE_MOVE:
+            message->seq = read_u32(r);
+            message->hash = read_u64(r);
+            message->move.sourceRow = (int)read_u8(r);
+            message->move.sourceCol = (int)read_u8(r);
+            message->move.targetRow = (int)read_u8(r);
+            message->move.targetCol = (int)read_u8(r);
+            message->flipped = read_u64(r);
+            return DECODED_SEQ | DECODED_HASH | DECODED_MOVE | DECODED_FLIPPED;
+        case BOARD_UPDATE_SAME:
+            message->seq = read_u32(r);
+            message->hash = read_u64(r);
+            return DECODED_SEQ | DECODED_HASH;
+        default:
+            r->ok = 0;
+            return 0;
+    }
+}
+
+int decodeBinaryMessage(const char *frame, size_t length, DecodedMessage *message) {
+    memset(message, 0, sizeof(DecodedMessage));
+    message->type = MSG_UNKNOWN;
+
+    BinaryReader r = { (const unsigned char*)frame, (const unsigned char*)frame + length, 1 };
+    MessageType type = MSG_UNKNOWN;
+    unsigned int fields = 0;
+
+    switch (read_u8(&r)) {
+        case BINARY_REGISTER:
+            type = MSG_REGISTER;
+            message->username = read_string(&r, 0);
+            fields = DECODED_USERNAME;
+            break;
+        case BINARY_MOVE:
+            type = MSG_MOVE;
+            message->move.sourceRow = (int)read_u8(&r);
+            message->move.sourceCol = (int)read_u8(&r);
+            message->move.targetRow = (int)read_u8(&r);
+            message->move.targetCol = (int)read_u8(&r);
+            fields = DECODED_MOVE;
+            break;
+        case BINARY_REGISTER_ACK:
+            type = MSG_REGISTER_ACK;
+            break;
+        case BINARY_REGISTER_NACK:
+            type = MSG_REGISTER_NACK;
+            message->reason = read_string(&r, 0);
+            fields = DECODED_REASON;
+            break;
+        case BINARY_GAME_START:
+            type = MSG_GAME_START;
+            message->players[0] = read_string(&r, 0);
+            message->players[1] = read_string(&r, 0);
+            message->first_player = read_string(&r, 0);
+            fields = DECODED_PLAYERS | DECODED_FIRST_PLAYER;
+            break;
+        case BINARY_YOUR_TURN:
+            type = MSG_YOUR_TURN;
+            fields = read_board_update(&r, message);
+            message->timeout = read_u32(&r) / 1000.0;
+            fields |= DECODED_TIMEOUT;
+            break;
+        case BINARY_MOVE_OK:
+        case BINARY_INVALID_MOVE:
+            type = (frame[0] == BINARY_MOVE_OK) ? MSG_MOVE_OK : MSG_INVALID_MOVE;
+            fields = read_board_update(&r, message);
+            message->next_player = read_string(&r, 1);
+            fields |= DECODED_NEXT_PLAYER;
+            break;
+        case BINARY_PASS:
+            type = MSG_PASS;
+            message->next_player = read_string(&r, 1);
+            fields = DECODED_NEXT_PLAYER;
+            break;
+        case BINARY_GAME_OVER:
+            type = MSG_GAME_OVER;
+            for (int i = 0; i < 2; i++) {
+                message->players[i] = read_string(&r, 0);
+                message->scores[i] = (int)(int16_t)read_u16(&r);
+            }
+            fields = DECODED_SCORES;
+            break;
+        case BINARY_OPPONENT_LEFT:
+            // JSON opponent_left와 같이 따로 처리하지 않는 유형
+            message->username = read_string(&r, 0);
+            fields = DECODED_USERNAME;
+            break;
+        default:
+            return 0;
+    }
+
+    if (!r.ok || r.p != r.end) {
+        memset(message, 0, sizeof(DecodedMessage));
+        message->type = MSG_UNKNOWN;
+        return 0;
+    }
+    message->type = type;
+    message->fields = fields;
+    return 1;
+}
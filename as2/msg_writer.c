@@ -0,0 +1,361 @@
+#include <stdio.h>
+#include <string.h>
+#include "msg_writer.h"
+
+static void put_raw(MessageWriter *writer, const char *str, size_t len) {
+    if (writer->overflow || writer->length + len > sizeof(writer->data)) {
+        writer->overflow = 1;
+        return;
+    }
+    memcpy(writer->data + writer->length, str, len);
+    writer->length += len;
+}
+
+#define PUT_LITERAL(writer, literal) put_raw((writer), (literal), sizeof(literal) - 1)
+
+// json_stringify와 같은 규칙으로 이스케이프한 문자열
+static void put_string(MessageWriter *writer, const char *str) {
+    PUT_LITERAL(writer, "\"");
+    const char *run = str;
+    for (const char *c = str; ; c++) {
+        const char *escape = NULL;
+        switch (*c) {
+            case '\\': escape = "\\\\"; break;
+            case '"': escape = "\\\""; break;
+            case '\b': escape = "\\b"; break;
+            case '\f': escape = "\\f"; break;
+            case '\n': escape = "\\n"; break;
+            case '\r': escape = "\\r"; break;
+            case '\t': escape = "\\t"; break;
+            case '\0': break;
+            default: continue;
+        }
+        put_raw(writer, run, (size_t)(c - run));
+        if (!escape) break;
+        put_raw(writer, escape, 2);
+        run = c + 1;
+    }
+    PUT_LITERAL(writer, "\"");
+}
+
+static void put_number(MessageWriter *writer, double value) {
+    char number[32];
+    int len = snprintf(number, sizeof(number), "%g", value);
+    put_raw(writer, number, (size_t)len);
+}
+
+// 정수 필드 (대국 번호, seq, 좌표, 점수). %g는 유효 숫자 6자리라 큰 번호가 1.23457e+06처럼 깨짐
+static void put_int(MessageWriter *writer, long long value) {
+    char number[24];
+    int len = snprintf(number, sizeof(number), "%lld", value);
+    put_raw(writer, number, (size_t)len);
+}
+
+static void put_board(MessageWriter *writer, const GameBoard *board) {
+    PUT_LITERAL(writer, "\"board\":[");
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        if (i > 0) PUT_LITERAL(writer, ",");
+        PUT_LITERAL(writer, "\"");
+        put_raw(writer, board->cells[i], BOARD_SIZE);
+        PUT_LITERAL(writer, "\"");
+    }
+    PUT_LITERAL(writer, "]");
+}
+
+static void put_hex64(MessageWriter *writer, uint64_t value) {
+    char hex[24];
+    int len = snprintf(hex, sizeof(hex), "\"%llx\"", (unsigned long long)value);
+    put_raw(writer, hex, (size_t)len);
+}
+
+// 보드 자리 (앞의 ',' 포함). delta가 NULL이면 보드 전체만
+static void put_board_update(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta) {
+    PUT_LITERAL(writer, ",");
+    BoardUpdateKind kind = delta ? delta->kind : BOARD_UPDATE_FULL;
+    if (kind == BOARD_UPDATE_FULL || kind == BOARD_UPDATE_SNAPSHOT) {
+        put_board(writer, board);
+        if (kind == BOARD_UPDATE_FULL) return;
+        PUT_LITERAL(writer, ",");
+    }
+    PUT_LITERAL(writer, "\"seq\":");
+    put_int(writer, delta->seq);
+    if (kind == BOARD_UPDATE_MOVE) {
+        PUT_LITERAL(writer, ",\"sx\":");
+        put_int(writer, delta->move.sourceRow);
+        PUT_LITERAL(writer, ",\"sy\":");
+        put_int(writer, delta->move.sourceCol);
+        PUT_LITERAL(writer, ",\"tx\":");
+        put_int(writer, delta->move.targetRow);
+        PUT_LITERAL(writer, ",\"ty\":");
+        put_int(writer, delta->move.targetCol);
+        PUT_LITERAL(writer, ",\"flipped\":");
+        put_hex64(writer, delta->flipped);
+    }
+    PUT_LITERAL(writer, ",\"hash\":");
+    put_hex64(writer, delta->hash);
+}
+
+static void put_next_player(MessageWriter *writer, const char *nextPlayer) {
+    PUT_LITERAL(writer, ",\"next_player\":");
+    if (nextPlayer) put_string(writer, nextPlayer);
+    else PUT_LITERAL(writer, "null");
+}
+
+// 메시지 시작: {"type":"...",
+static void begin(MessageWriter *writer, const char *type) {
+    writer->length = 0;
+    writer->overflow = 0;
+    PUT_LITERAL(writer, "{\"type\":\"");
+    put_raw(writer, type, strlen(type));
+    PUT_LITERAL(writer, "\"");
+}
+
+static void end(MessageWriter *writer) {
+    PUT_LITERAL(writer, "}\n");
+}
+
+static void begin_binary(MessageWriter *writer, BinaryWriter *bin, BinaryType type) {
+    binary_begin(bin, writer->binary, sizeof(writer->binary), type);
+}
+
+static void end_binary(MessageWriter *writer, BinaryWriter *bin) {
+    writer->binary_length = binary_end(bin);
+}
+
+const MessageWriter* writeRegisterAckMessage(MessageWriter *writer, unsigned int capabilities) {
+    begin(writer, "register_ack");
+    if (capabilities) {
+        PUT_LITERAL(writer, ",\"capabilities\":[");
+        int first = 1;
+        for (unsigned int i = 0; capabilityName(i); i++) {
+            if (!(capabilities & (1u << i))) continue;
+            if (!first) PUT_LITERAL(writer, ",");
+            put_string(writer, capabilityName(i));
+            first = 0;
+        }
+        PUT_LITERAL(writer, "]");
+    }
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_REGISTER_ACK);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeRegisterNackMessage(MessageWriter *writer, const char *reason) {
+    begin(writer, "register_nack");
+    PUT_LITERAL(writer, ",\"reason\":");
+    put_string(writer, reason);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_REGISTER_NACK);
+    binary_put_string(&bin, reason);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeGameStartMessage(MessageWriter *writer, const char *players[2], const char *firstPlayer) {
+    begin(writer, "game_start");
+    PUT_LITERAL(writer, ",\"players\":[");
+    put_string(writer, players[0]);
+    PUT_LITERAL(writer, ",");
+    put_string(writer, players[1]);
+    PUT_LITERAL(writer, "],\"first_player\":");
+    put_string(writer, firstPlayer);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_GAME_START);
+    binary_put_string(&bin, players[0]);
+    binary_put_string(&bin, players[1]);
+    binary_put_string(&bin, firstPlayer);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeYourTurnMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                         double timeout) {
+    begin(writer, "your_turn");
+    put_board_update(writer, board, delta);
+    PUT_LITERAL(writer, ",\"timeout\":");
+    put_number(writer, timeout);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_YOUR_TURN);
+    binary_put_board_update(&bin, board, delta);
+    binary_put_u32(&bin, (uint32_t)(timeout * 1000.0 + 0.5));   // 밀리초
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeMoveOkMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                       const char *nextPlayer) {
+    begin(writer, "move_ok");
+    put_board_update(writer, board, delta);
+    put_next_player(writer, nextPlayer);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_MOVE_OK);
+    binary_put_board_update(&bin, board, delta);
+    binary_put_string(&bin, nextPlayer);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeInvalidMoveMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                            const char *nextPlayer) {
+    begin(writer, "invalid_move");
+    put_board_update(writer, board, delta);
+    put_next_player(writer, nextPlayer);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_INVALID_MOVE);
+    binary_put_board_update(&bin, board, delta);
+    binary_put_string(&bin, nextPlayer);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writePassMessage(MessageWriter *writer, const char *nextPlayer) {
+    begin(writer, "pass");
+    put_next_player(writer, nextPlayer);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_PASS);
+    binary_put_string(&bin, nextPlayer);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeGameOverMessage(MessageWriter *writer, const char *players[2], int scores[2]) {
+    begin(writer, "game_over");
+    PUT_LITERAL(writer, ",\"scores\":{");
+    put_string(writer, players[0]);
+    PUT_LITERAL(writer, ":");
+    put_int(writer, scores[0]);
+    PUT_LITERAL(writer, ",");
+    put_string(writer, players[1]);
+    PUT_LITERAL(writer, ":");
+    put_int(writer, scores[1]);
+    PUT_LITERAL(writer, "}");
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_GAME_OVER);
+    for (int i = 0; i < 2; i++) {
+        binary_put_string(&bin, players[i]);
+        binary_put_u16(&bin, (unsigned int)(scores[i] & 0xFFFF));
+    }
+    end_binary(writer, &bin);
+    return writer;
+}
+
+const MessageWriter* writeOpponentLeftMessage(MessageWriter *writer, const char *leftUsername) {
+    begin(writer, "opponent_left");
+    PUT_LITERAL(writer, ",\"username\":");
+    put_string(writer, leftUsername);
+    end(writer);
+
+    BinaryWriter bin;
+    begin_binary(writer, &bin, BINARY_OPPONENT_LEFT);
+    binary_put_string(&bin, leftUsername);
+    end_binary(writer, &bin);
+    return writer;
+}
+
+// 관전 메시지: 대국 번호 (앞의 ',' 포함)
+static void put_game(MessageWriter *writer, int game) {
+    PUT_LITERAL(writer, ",\"game\":");
+    put_int(writer, game);
+}
+
+static void put_players(MessageWriter *writer, const char *players[2]) {
+    PUT_LITERAL(writer, ",\"players\":[");
+    put_string(writer, players[0]);
+    PUT_LITERAL(writer, ",");
+    put_string(writer, players[1]);
+    PUT_LITERAL(writer, "]");
+}
+
+// 관전자는 JSON으로만 받으므로 바이너리 프레임은 만들지 않음
+static void end_json_only(MessageWriter *writer) {
+    end(writer);
+    writer->binary_length = 0;
+}
+
+const MessageWriter* writeSpectateAckMessage(MessageWriter *writer, const int *games, int gameCount) {
+    begin(writer, "spectate_ack");
+    if (gameCount > 0) {
+        PUT_LITERAL(writer, ",\"games\":[");
+        for (int i = 0; i < gameCount; i++) {
+            if (i > 0) PUT_LITERAL(writer, ",");
+            put_int(writer, games[i]);
+        }
+        PUT_LITERAL(writer, "]");
+    }
+    end_json_only(writer);
+    return writer;
+}
+
+const MessageWriter* writeWatchStartMessage(MessageWriter *writer, int game, const char *players[2],
+                                           const char *firstPlayer, const GameBoard *board) {
+    begin(writer, "watch_start");
+    put_game(writer, game);
+    put_players(writer, players);
+    PUT_LITERAL(writer, ",\"first_player\":");
+    put_string(writer, firstPlayer);
+    PUT_LITERAL(writer, ",");
+    put_board(writer, board);
+    end_json_only(writer);
+    return writer;
+}
+
+const MessageWriter* writeWatchMoveMessage(MessageWriter *writer, int game, uint32_t seq, const char *player,
+                                          const Move *move, const GameBoard *board, const char *nextPlayer) {
+    begin(writer, "watch_move");
+    put_game(writer, game);
+    PUT_LITERAL(writer, ",\"seq\":");
+    put_int(writer, seq);
+    PUT_LITERAL(writer, ",\"player\":");
+    put_string(writer, player);
+    PUT_LITERAL(writer, ",\"sx\":");
+    put_int(writer, move->sourceRow);
+    PUT_LITERAL(writer, ",\"sy\":");
+    put_int(writer, move->sourceCol);
+    PUT_LITERAL(writer, ",\"tx\":");
+    put_int(writer, move->targetRow);
+    PUT_LITERAL(writer, ",\"ty\":");
+    put_int(writer, move->targetCol);
+    PUT_LITERAL(writer, ",");
+    put_board(writer, board);
+    put_next_player(writer, nextPlayer);
+    end_json_only(writer);
+    return writer;
+}
+
+const MessageWriter* writeWatchEndMessage(MessageWriter *writer, int game, const char *reason,
+                                         const GameBoard *board, const char *players[2], int scores[2]) {
+    begin(writer, "watch_end");
+    put_game(writer, game);
+    PUT_LITERAL(writer, ",\"reason\":");
+    put_string(writer, reason);
+    PUT_LITERAL(writer, ",");
+    put_board(writer, board);
+    PUT_LITERAL(writer, ",\"scores\":{");
+    put_string(writer, players[0]);
+    PUT_LITERAL(writer, ":");
+    put_int(writer, scores[0]);
+    PUT_LITERAL(writer, ",");
+    put_string(writer, players[1]);
+    PUT_LITERAL(writer, ":");
+    put_int(writer, scores[1]);
+    PUT_LITERAL(writer, "}");
+    end_json_only(writer);
+    return writer;
+}
@@ -0,0 +1,54 @@
+#ifndef MSG_WRITER_H
+#define MSG_WRITER_H
+
+#include <stddef.h>
+#include "octaflip.h"
+#include "msg_binary.h"
+
+// 서버 → 클라이언트 메시지를 JsonValue 트리 없이 바로 한 줄(JSON + '\n')로 직렬화한다.
+// 프로토콜 메시지는 크기가 정해져 있어 고정 버퍼 하나로 충분하고, 할당이 전혀 없다.
+// 결과는 연결의 송신 버퍼에 복사되며 브로드캐스트는 한 번만 직렬화한다.
+// write 함수들은 넘겨받은 writer를 그대로 돌려준다 (send_message(client, writeXxx(...)) 형태로 쓰기 위함).
+// 같은 메시지의 바이너리 프레임(msg_binary.h)도 함께 만들어 두고, 보낼 때 연결이 협상한 형식을 고른다.
+// 보드가 들어가는 메시지는 delta가 NULL이면 보드 전체를, 아니면 그 내용(board_delta.h)을 싣는다.
+
+#define MESSAGE_WRITER_SIZE 1024
+#define MESSAGE_WRITER_BINARY_SIZE 512
+
+typedef struct {
+    char data[MESSAGE_WRITER_SIZE];
+    size_t length;
+    int overflow;             // 버퍼를 넘치면 1 (메시지를 보내지 말 것)
+    unsigned char binary[MESSAGE_WRITER_BINARY_SIZE];
+    size_t binary_length;     // 바이너리 프레임 크기 (0이면 만들지 못함)
+} MessageWriter;
+
+// capabilities: 받아들인 CAPABILITY_* (0이면 필드 생략)
+const MessageWriter* writeRegisterAckMessage(MessageWriter *writer, unsigned int capabilities);
+const MessageWriter* writeRegisterNackMessage(MessageWriter *writer, const char *reason);
+const MessageWriter* writeGameStartMessage(MessageWriter *writer, const char *players[2], const char *firstPlayer);
+const MessageWriter* writeYourTurnMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                         double timeout);
+// nextPlayer가 NULL이면 next_player는 null (게임 종료)
+const MessageWriter* writeMoveOkMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                       const char *nextPlayer);
+const MessageWriter* writeInvalidMoveMessage(MessageWriter *writer, const GameBoard *board, const BoardDelta *delta,
+                                            const char *nextPlayer);
+const MessageWriter* writePassMessage(MessageWriter *writer, const char *nextPlayer);
+const MessageWriter* writeGameOverMessage(MessageWriter *writer, const char *players[2], int scores[2]);
+const MessageWriter* writeOpponentLeftMessage(MessageWriter *writer, const char *leftUsername);
+
+// 관전 스트림 (JSON만, binary_length는 0). 대국마다 watch_start → watch_move... → watch_end 순서이며
+// watch_move/watch_end에는 보드 전체가 들어 있어 중간부터 받아도 그 메시지만으로 상태를 알 수 있다.
+// games가 0개면 모든 대국 관전
+const MessageWriter* writeSpectateAckMessage(MessageWriter *writer, const int *games, int gameCount);
+const MessageWriter* writeWatchStartMessage(MessageWriter *writer, int game, const char *players[2],
+                                           const char *firstPlayer, const GameBoard *board);
+// move가 (0,0,0,0)이면 패스 (시간 초과 포함). nextPlayer가 NULL이면 null
+const MessageWriter* writeWatchMoveMessage(MessageWriter *writer, int game, uint32_t seq, const char *player,
+                                          const Move *move, const GameBoard *board, const char *nextPlayer);
+// reason: "game_over" 또는 "abandoned" (두 플레이어 모두 나감)
+const MessageWriter* writeWatchEndMessage(MessageWriter *writer, int game, const char *reason,
+                                         const GameBoard *board, const char *players[2], int scores[2]);
+
+#endif /* MSG_WRITER_H */
@@ -63,6 +63,99 @@ int absVal(int x) {
     return (x < 0) ? -x : x;
 }
 
+// ---- 비트보드 ----
+// 칸 하나를 비트 하나로 (비트 번호 = 행*8 + 열, board_delta와 같은 배치). 이웃/점프 칸은 미리 계산해 둔 표를
+// 쓰므로 이동 검증은 표 조회 한 번, 뒤집기는 목적지 이웃 마스크와 상대 말 마스크의 AND로 끝난다.
+
+// 칸 s(= 행*8 + 열)에서 한 칸 떨어진 8방향 칸 (복제 이동, 뒤집기 범위)
+static const uint64_t neighbor_masks[64] = {
+    0x0000000000000302ULL, 0x0000000000000705ULL, 0x0000000000000e0aULL, 0x0000000000001c14ULL,
+    0x0000000000003828ULL, 0x0000000000007050ULL, 0x000000000000e0a0ULL, 0x000000000000c040ULL,
+    0x0000000000030203ULL, 0x0000000000070507ULL, 0x00000000000e0a0eULL, 0x00000000001c141cULL,
+    0x0000000000382838ULL, 0x0000000000705070ULL, 0x0000000000e0a0e0ULL, 0x0000000000c040c0ULL,
+    0x0000000003020300ULL, 0x0000000007050700ULL, 0x000000000e0a0e00ULL, 0x000000001c141c00ULL,
+    0x0000000038283800ULL, 0x0000000070507000ULL, 0x00000000e0a0e000ULL, 0x00000000c040c000ULL,
+    0x0000000302030000ULL, 0x0000000705070000ULL, 0x0000000e0a0e0000ULL, 0x0000001c141c0000ULL,
+    0x0000003828380000ULL, 0x0000007050700000ULL, 0x000000e0a0e00000ULL, 0x000000c040c00000ULL,
+    0x0000030203000000ULL, 0x0000070507000000ULL, 0x00000e0a0e000000ULL, 0x00001c141c000000ULL,
+    0x0000382838000000ULL, 0x0000705070000000ULL, 0x0000e0a0e0000000ULL, 0x0000c040c0000000ULL,
+    0x0003020300000000ULL, 0x0007050700000000ULL, 0x000e0a0e00000000ULL, 0x001c141c00000000ULL,
+    0x0038283800000000ULL, 0x0070507000000000ULL, 0x00e0a0e000000000ULL, 0x00c040c000000000ULL,
+    0x0302030000000000ULL, 0x0705070000000000ULL, 0x0e0a0e0000000000ULL, 0x1c141c0000000000ULL,
+    0x3828380000000000ULL, 0x7050700000000000ULL, 0xe0a0e00000000000ULL, 0xc040c00000000000ULL,
+    0x0203000000000000ULL, 0x0507000000000000ULL, 0x0a0e000000000000ULL, 0x141c000000000000ULL,
+    0x2838000000000000ULL, 0x5070000000000000ULL, 0xa0e0000000000000ULL, 0x40c0000000000000ULL,
+};
+
+// 칸 s에서 같은 방향으로 두 칸 떨어진 칸 (점프 이동). 가운데 칸은 (s + t) / 2
+static const uint64_t jump_masks[64] = {
+    0x0000000000050004ULL, 0x00000000000a0008ULL, 0x0000000000150011ULL, 0x00000000002a0022ULL,
+    0x0000000000540044ULL, 0x0000000000a80088ULL, 0x0000000000500010ULL, 0x0000000000a00020ULL,
+    0x0000000005000400ULL, 0x000000000a000800ULL, 0x0000000015001100ULL, 0x000000002a002200ULL,
+    0x0000000054004400ULL, 0x00000000a8008800ULL, 0x0000000050001000ULL, 0x00000000a0002000ULL,
+    0x0000000500040005ULL, 0x0000000a0008000aULL, 0x0000001500110015ULL, 0x0000002a0022002aULL,
+    0x0000005400440054ULL, 0x000000a8008800a8ULL, 0x0000005000100050ULL, 0x000000a0002000a0ULL,
+    0x0000050004000500ULL, 0x00000a0008000a00ULL, 0x0000150011001500ULL, 0x00002a0022002a00ULL,
+    0x0000540044005400ULL, 0x0000a8008800a800ULL, 0x0000500010005000ULL, 0x0000a0002000a000ULL,
+    0x0005000400050000ULL, 0x000a0008000a0000ULL, 0x0015001100150000ULL, 0x002a0022002a0000ULL,
+    0x0054004400540000ULL, 0x00a8008800a80000ULL, 0x0050001000500000ULL, 0x00a0002000a00000ULL,
+    0x0500040005000000ULL, 0x0a0008000a000000ULL, 0x1500110015000000ULL, 0x2a0022002a000000ULL,
+    0x5400440054000000ULL, 0xa8008800a8000000ULL, 0x5000100050000000ULL, 0xa0002000a0000000ULL,
+    0x0004000500000000ULL, 0x0008000a00000000ULL, 0x0011001500000000ULL, 0x0022002a00000000ULL,
+    0x0044005400000000ULL, 0x008800a800000000ULL, 0x0010005000000000ULL, 0x002000a000000000ULL,
+    0x0400050000000000ULL, 0x08000a0000000000ULL, 0x1100150000000000ULL, 0x22002a0000000000ULL,
+    0x4400540000000000ULL, 0x8800a80000000000ULL, 0x1000500000000000ULL, 0x2000a00000000000ULL,
+};
+
+// 방향(dRow/dCol 순서)별 비트 이동량과, 그 방향으로 옮기면 옆 행으로 넘어가는 열을 미리 지우는 마스크
+#define FILE_A_BITS 0x0101010101010101ULL
+#define FILE_H_BITS 0x8080808080808080ULL
+static const int shift_amount[8] = { -9, -8, -7, -1, 1, 7, 8, 9 };
+static const uint64_t shift_guard[8] = {
+    ~FILE_A_BITS, ~0ULL, ~FILE_H_BITS, ~FILE_A_BITS, ~FILE_H_BITS, ~FILE_A_BITS, ~0ULL, ~FILE_H_BITS
+};
+
+static inline uint64_t shift_bits(uint64_t bits, int d) {
+    bits &= shift_guard[d];
+    return (shift_amount[d] > 0) ? bits << shift_amount[d] : bits >> -shift_amount[d];
+}
+
+// 한 행에서 값이 ch인 칸 (열 c가 비트 c). 리틀 엔디언이면 8바이트를 한 번에 비교 (SWAR)
+static inline uint64_t row_bits(const char *row, char ch) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    memcpy(&word, row, sizeof(word));
+    word ^= 0x0101010101010101ULL * (unsigned char)ch;   // 같은 바이트만 0이 됨
+    uint64_t zero = ~(((word & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | word) & 0x8080808080808080ULL;
+    return ((zero >> 7) * 0x0102040810204080ULL) >> 56;
+#else
+    uint64_t bits = 0;
+    for(int c = 0; c < BOARD_SIZE; c++) {
+        if(row[c] == ch) bits |= 1ULL << c;
+    }
+    return bits;
+#endif
+}
+
+static uint64_t cell_bits(const GameBoard *board, char ch) {
+    uint64_t bits = 0;
+    for(int r = 0; r < BOARD_SIZE; r++) bits |= row_bits(board->cells[r], ch) << (r * BOARD_SIZE);
+    return bits;
+}
+
+// 빨강/파랑/빈칸을 한 번에 (행마다 한 번만 읽음)
+static void piece_bits(const GameBoard *board, uint64_t *red, uint64_t *blue, uint64_t *empty) {
+    uint64_t r_bits = 0, b_bits = 0, e_bits = 0;
+    for(int r = 0; r < BOARD_SIZE; r++) {
+        r_bits |= row_bits(board->cells[r], RED_PLAYER) << (r * BOARD_SIZE);
+        b_bits |= row_bits(board->cells[r], BLUE_PLAYER) << (r * BOARD_SIZE);
+        e_bits |= row_bits(board->cells[r], EMPTY_CELL) << (r * BOARD_SIZE);
+    }
+    *red = r_bits;
+    *blue = b_bits;
+    *empty = e_bits;
+}
+
 void initializeBoard(GameBoard *board) {
     for(int i = 0; i < BOARD_SIZE; i++) {
         for(int j = 0; j < BOARD_SIZE; j++) {
@@ -117,42 +210,26 @@ void countPieces(GameBoard *board) {
     board->emptyCount = countEmpty(board);
 
 #else
-    board->redCount = 0;
-    board->blueCount = 0;
-    board->emptyCount = 0;
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            char c = board->cells[i][j];
-            if(c == RED_PLAYER) board->redCount++;
-            else if(c == BLUE_PLAYER) board->blueCount++;
-            else if(c == EMPTY_CELL) board->emptyCount++;
-        }
-    }
+    uint64_t red, blue, empty;
+    piece_bits(board, &red, &blue, &empty);
+    board->redCount = __builtin_popcountll(red);
+    board->blueCount = __builtin_popcountll(blue);
+    board->emptyCount = __builtin_popcountll(empty);
 #endif
 }
 
 int hasValidMove(const GameBoard *board, char player) {
-    for(int r = 0; r < BOARD_SIZE; r++) {
-        for(int c = 0; c < BOARD_SIZE; c++) {
-            if(board->cells[r][c] != player) continue;
-            for(int d = 0; d < 8; d++) {
-                for(int s = 1; s <= 2; s++) {
-                    int nr = r + dRow[d] * s;
-                    int nc = c + dCol[d] * s;
-                    if(nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE)
-                        continue;
-                    if(s == 2) {
-                        int mr = r + dRow[d];
-                        int mc = c + dCol[d];
-                        if(board->cells[mr][mc] == RED_PLAYER ||
-                           board->cells[mr][mc] == BLUE_PLAYER)
-                            continue;
-                    }
-                    if(board->cells[nr][nc] == EMPTY_CELL)
-                        return 1;
-                }
-            }
-        }
+    uint64_t red, blue, empty;
+    piece_bits(board, &red, &blue, &empty);
+    uint64_t mine = (player == RED_PLAYER) ? red : (player == BLUE_PLAYER) ? blue : cell_bits(board, player);
+    // 내 말 전체를 방향마다 한 번에 옮겨 봄 (칸마다 8방향을 도는 대신). 복제 이동부터
+    uint64_t reach = 0;
+    for(int d = 0; d < 8; d++) reach |= shift_bits(mine, d);
+    if(reach & empty) return 1;
+    // 점프: 가운데 칸(말이 없는 칸)을 지나 한 칸 더
+    uint64_t open = ~(red | blue);
+    for(int d = 0; d < 8; d++) {
+        if(shift_bits(shift_bits(mine, d) & open, d) & empty) return 1;
     }
     return 0;
 }
@@ -168,18 +245,14 @@ int isValidMove(const GameBoard *board, Move *move) {
         return 0;
     if(board->cells[r1][c1] != current) return 0;
     if(board->cells[r2][c2] != EMPTY_CELL) return 0;
-    int dr = r2 - r1, dc = c2 - c1;
-    int absDr = absVal(dr), absDc = absVal(dc);
-    int maxD = (absDr > absDc) ? absDr : absDc;
-    if(maxD != 1 && maxD != 2) return 0;
-    if(absDr != 0 && absDc != 0 && absDr != absDc) return 0;
-    if(maxD == 2) {
-        int mr = r1 + dr/2, mc = c1 + dc/2;
-        if(board->cells[mr][mc] == RED_PLAYER ||
-           board->cells[mr][mc] == BLUE_PLAYER)
-            return 0;
-    }
-    return 1;
+    int s = r1 * BOARD_SIZE + c1, t = r2 * BOARD_SIZE + c2;
+    uint64_t target = 1ULL << t;
+    if(neighbor_masks[s] & target) return 1;
+    if(!(jump_masks[s] & target)) return 0;
+    // 점프는 가운데 칸을 넘을 수 있어야 함
+    int m = (s + t) >> 1;
+    char middle = board->cells[m / BOARD_SIZE][m % BOARD_SIZE];
+    return middle != RED_PLAYER && middle != BLUE_PLAYER;
 }
 
 void applyMove(GameBoard *board, Move *move) {
@@ -192,12 +265,12 @@ void applyMove(GameBoard *board, Move *move) {
     int maxD = (absDr > absDc) ? absDr : absDc;
     if(maxD == 2) board->cells[r1][c1] = EMPTY_CELL;
     board->cells[r2][c2] = current;
-    for(int d = 0; d < 8; d++) {
-        int nr = r2 + dRow[d], nc = c2 + dCol[d];
-        if(nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE)
-            continue;
-        if(board->cells[nr][nc] == opponent)
-            board->cells[nr][nc] = current;
+    // 목적지 이웃 중 상대 말인 칸만 골라 그 칸만 씀
+    uint64_t flips = neighbor_masks[r2 * BOARD_SIZE + c2] & cell_bits(board, opponent);
+    while(flips) {
+        int i = __builtin_ctzll(flips);
+        board->cells[i / BOARD_SIZE][i % BOARD_SIZE] = current;
+        flips &= flips - 1;
     }
     countPieces(board);
 }
@@ -0,0 +1,30 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <stddef.h>
+
+// 연결별 송신 링 버퍼.
+// 메시지는 여기에 쌓아 두고 이벤트 루프 끝에 한 번에 보낸다 (같은 루프의 여러 메시지가 한 번의 시스템 콜로 나감).
+// 링이 끝에서 돌아 나오면 두 조각을 iovec 두 개로 묶어 보낸다. 보내지 못한 나머지는 다음 쓰기 가능 알림 때 이어서 보낸다.
+
+typedef struct {
+    char *data;               // 처음 append할 때 할당
+    size_t capacity;          // 항상 2의 거듭제곱
+    size_t head;              // 다음에 보낼 바이트 위치
+    size_t length;            // 쌓여 있는 바이트 수
+} OutputBuffer;
+
+void output_buffer_init(OutputBuffer *buffer);
+void output_buffer_destroy(OutputBuffer *buffer);
+
+// 끝에 추가 (공간이 모자라면 두 배씩 늘림). 실패 시 -1
+int output_buffer_append(OutputBuffer *buffer, const char *data, size_t len);
+
+// 소켓이 받아 주는 만큼 보냄. 0: 모두 보냄, 1: 남음(EAGAIN), -1: 연결 오류
+int output_buffer_flush(OutputBuffer *buffer, int fd);
+
+static inline size_t output_buffer_pending(const OutputBuffer *buffer) {
+    return buffer->length;
+}
+
+#endif /* OUTPUT_BUFFER_H */
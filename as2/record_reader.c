@@ -0,0 +1,101 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "record_reader.h"
+
+static unsigned int get_u16(const unsigned char *p) {
+    return ((unsigned int)p[0] << 8) | p[1];
+}
+
+static uint32_t get_u32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+int record_file_open(RecordFile *file, const char *path) {
+    memset(file, 0, sizeof(RecordFile));
+    file->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(file->fd, &st) != 0) {
+        close(file->fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < RECORD_FILE_HEADER_SIZE) {
+        close(file->fd);
+        errno = EINVAL;
+        return -1;
+    }
+    file->size = (size_t)st.st_size;
+    void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+    if (data == MAP_FAILED) {
+        close(file->fd);
+        return -1;
+    }
+    file->data = (const unsigned char*)data;
+    // 처음부터 끝까지 한 번 훑는 용도이므로 커널이 미리 읽어 두도록
+    madvise(data, file->size, MADV_SEQUENTIAL);
+
+    if (memcmp(file->data, RECORD_FILE_MAGIC, 8) != 0 || get_u16(file->data + 8) != RECORD_FILE_VERSION ||
+        get_u16(file->data + 10) < RECORD_FILE_HEADER_SIZE || get_u16(file->data + 10) > file->size) {
+        record_file_close(file);
+        errno = EINVAL;
+        return -1;
+    }
+    file->offset = get_u16(file->data + 10);
+    return 0;
+}
+
+void record_file_close(RecordFile *file) {
+    if (file->data) munmap((void*)file->data, file->size);
+    if (file->fd >= 0) close(file->fd);
+    file->data = NULL;
+    file->fd = -1;
+}
+
+int record_file_next(RecordFile *file, RecordView *record) {
+    size_t left = file->size - file->offset;
+    if (left == 0) return 0;
+    if (left < RECORD_FIXED_SIZE) return -1;
+
+    const unsigned char *p = file->data + file->offset;
+    uint32_t length = get_u32(p);
+    if (length < RECORD_FIXED_SIZE + 4 + 2 || length > left) return -1;
+    if (get_u32(p + length - 4) != record_checksum(p, length - 4)) return -1;
+
+    unsigned int events = get_u16(p + 32);
+    size_t names = (size_t)p[37] + 1 + (size_t)p[38] + 1;
+    if ((size_t)RECORD_FIXED_SIZE + names + events * RECORD_EVENT_SIZE + 4 != length) return -1;
+    const char *first = (const char*)p + RECORD_FIXED_SIZE;
+    const char *second = first + p[37] + 1;
+    if (first[p[37]] != '\0' || second[p[38]] != '\0') return -1;
+
+    record->offset = file->offset;
+    record->game_id = get_u32(p + 4);
+    record->start_ms = ((uint64_t)get_u32(p + 8) << 32) | get_u32(p + 12);
+    record->duration_ms = get_u32(p + 16);
+    record->base_ms = get_u32(p + 20);
+    record->increment_ms = get_u32(p + 24);
+    record->move_limit_ms = get_u32(p + 28);
+    record->event_count = (uint16_t)events;
+    record->result = p[34];
+    record->scores[0] = p[35];
+    record->scores[1] = p[36];
+    record->players[0] = first;
+    record->players[1] = second;
+    record->events = p + RECORD_FIXED_SIZE + names;
+    file->offset += length;
+    return 1;
+}
+
+void record_view_event(const RecordView *record, size_t index, RecordEvent *event) {
+    const unsigned char *p = record->events + index * RECORD_EVENT_SIZE;
+    event->kind = p[0] & 0x7F;
+    event->seat = p[0] >> 7;
+    event->from = p[1];
+    event->to = p[2];
+    event->think_us = get_u32(p + 4);
+}
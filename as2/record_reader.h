@@ -0,0 +1,42 @@
+#ifndef RECORD_READER_H
+#define RECORD_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_record.h"
+
+// 대국 기록 파일(game_record.h) 읽기. 파일 전체를 읽기 전용으로 mmap하고 레코드를 차례로 훑는다.
+// 레코드의 이름과 이벤트는 매핑 안을 가리키므로 복사가 없고, record_file_close 전까지만 유효하다.
+
+typedef struct {
+    int fd;
+    const unsigned char *data;
+    size_t size;
+    size_t offset;                // 다음 레코드 위치 (끝까지 읽으면 마지막 온전한 레코드의 끝)
+} RecordFile;
+
+typedef struct {
+    size_t offset;                // 파일 안 위치
+    uint32_t game_id;
+    uint64_t start_ms;
+    uint32_t duration_ms;
+    uint32_t base_ms;
+    uint32_t increment_ms;
+    uint32_t move_limit_ms;
+    uint8_t result;               // RecordResult
+    uint8_t scores[2];
+    const char *players[2];
+    uint16_t event_count;
+    const unsigned char *events;  // RECORD_EVENT_SIZE * event_count 바이트 (record_view_event로 꺼냄)
+} RecordView;
+
+// 열고 헤더 확인. 실패 시 -1 (errno: 시스템 오류, EINVAL: 기록 파일이 아님)
+int record_file_open(RecordFile *file, const char *path);
+void record_file_close(RecordFile *file);
+
+// 다음 레코드. 1: 읽음, 0: 파일 끝, -1: 깨진 레코드 (offset은 그 레코드 앞에 그대로)
+int record_file_next(RecordFile *file, RecordView *record);
+
+void record_view_event(const RecordView *record, size_t index, RecordEvent *event);
+
+#endif /* RECORD_READER_H */
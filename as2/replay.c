@@ -0,0 +1,514 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "octaflip.h"
+#include "json.h"
+#include "message_handler.h"
+#include "msg_decoder.h"
+#include "game_record.h"
+#include "record_reader.h"
+
+// 대국 기록 재생/검증 도구.
+// 바이너리 기록 파일(game_record.h)이나 JSONL 대국 스크립트(register 두 줄 + move 줄)를 받아
+// 서버와 같은 규칙(isValidMove/applyMove, 패스/시간 초과/연결 끊김 처리)으로 처음부터 다시 두어 보고,
+// 기록된 차례, 수의 합법성, 종료 시점, 점수가 규칙 엔진과 맞는지 확인한다. 파일 단위로 여러 스레드가 나눠 처리한다.
+
+#define MAX_THREADS 64
+#define MAX_ERRORS_PER_FILE 20      // 파일 하나에서 출력할 불일치 최대 개수
+
+typedef struct {
+    uint64_t games;
+    uint64_t red_wins;
+    uint64_t blue_wins;
+    uint64_t draws;
+    uint64_t abandoned;
+    uint64_t unfinished;            // JSONL 스크립트가 대국 도중 끝남
+    uint64_t events;
+    uint64_t moves;
+    uint64_t passes;
+    uint64_t timeouts;
+    uint64_t invalid;
+    uint64_t left;
+    uint64_t mismatches;            // 기록과 규칙 엔진이 다른 대국 수
+    uint64_t think_count;
+    uint64_t think_us_total;
+    uint64_t think_us_max;
+    uint64_t bytes;
+    uint64_t failed_files;
+} ReplayStats;
+
+// 재생 중인 대국 하나 (서버 GameSession의 규칙 부분만)
+typedef struct {
+    GameBoard board;
+    int current;                    // 차례인 자리 (0: R, 1: B)
+    int gone[2];                    // 연결 끊김
+    int over;
+    int errors;                     // 이 대국에서 찾은 불일치 수
+} Replay;
+
+typedef struct {
+    const char *path;
+    const char *pair_path;          // -i: 같은 대국의 상대 쪽 JSONL (없으면 NULL)
+} ReplayJob;
+
+static ReplayJob *jobs;
+static int job_count;
+static int next_job = 0;            // 워커들이 원자적으로 가져감
+static int quiet = 0;
+static int interleave = 0;
+
+static void replay_start(Replay *game) {
+    memset(game, 0, sizeof(Replay));
+    initializeBoard(&game->board);
+}
+
+static char seat_color(int seat) {
+    return (seat == 0) ? RED_PLAYER : BLUE_PLAYER;
+}
+
+// 서버 advance_turn과 같음: 상대가 나갔으면 차례 유지
+static void replay_advance(Replay *game) {
+    int next = (game->current + 1) % 2;
+    if (!game->gone[next]) game->current = next;
+}
+
+// 패스/시간 초과 뒤 종료 확인 (서버와 같이 연속 패스 2번 또는 hasGameEnded)
+static void replay_pass(Replay *game) {
+    game->board.consecutivePasses++;
+    if (game->board.consecutivePasses >= 2 || hasGameEnded(&game->board)) game->over = 1;
+    else replay_advance(game);
+}
+
+// 0부터 시작하는 좌표의 수 (player는 seat 색)
+static int replay_is_valid(Replay *game, int seat, int sr, int sc, int tr, int tc, Move *move) {
+    move->sourceRow = sr;
+    move->sourceCol = sc;
+    move->targetRow = tr;
+    move->targetCol = tc;
+    move->player = seat_color(seat);
+    if (sr < 0 || sr >= BOARD_SIZE || sc < 0 || sc >= BOARD_SIZE ||
+        tr < 0 || tr >= BOARD_SIZE || tc < 0 || tc >= BOARD_SIZE) {
+        return 0;
+    }
+    return isValidMove(&game->board, move);
+}
+
+static void replay_apply(Replay *game, Move *move) {
+    applyMove(&game->board, move);
+    game->board.consecutivePasses = 0;
+    if (hasGameEnded(&game->board)) game->over = 1;
+    else replay_advance(game);
+}
+
+static void replay_finish(Replay *game, ReplayStats *stats, int abandoned) {
+    countPieces(&game->board);
+    stats->games++;
+    if (abandoned) stats->abandoned++;
+    else if (game->board.redCount > game->board.blueCount) stats->red_wins++;
+    else if (game->board.blueCount > game->board.redCount) stats->blue_wins++;
+    else stats->draws++;
+    if (game->errors > 0) stats->mismatches++;
+}
+
+// 파일마다 MAX_ERRORS_PER_FILE개까지 출력. printf 한 번으로 찍어 스레드끼리 섞이지 않게 함
+static void note(int *file_errors, const char *path, const char *game_label, size_t event, const char *what) {
+    if (quiet || ++*file_errors > MAX_ERRORS_PER_FILE) return;
+    printf("%s: %s, event %zu: %s\n", path, game_label, event, what);
+}
+
+// 기록과 규칙 엔진이 다름 (이 대국을 불일치로 셈)
+static void report(Replay *game, int *file_errors, const char *path, const char *game_label, size_t event,
+                   const char *what) {
+    game->errors++;
+    note(file_errors, path, game_label, event, what);
+}
+
+// ---- 바이너리 기록 ----
+
+static void square_coords(uint8_t square, int *row, int *col) {
+    if (square == RECORD_NO_SQUARE) {
+        *row = -1;
+        *col = -1;
+    } else {
+        *row = square / BOARD_SIZE;
+        *col = square % BOARD_SIZE;
+    }
+}
+
+static void replay_record(const RecordView *record, const char *path, ReplayStats *stats, int *file_errors) {
+    Replay game;
+    replay_start(&game);
+    char label[32];
+    snprintf(label, sizeof(label), "game %u", record->game_id);
+
+    for (size_t i = 0; i < record->event_count; i++) {
+        RecordEvent event;
+        record_view_event(record, i, &event);
+        stats->events++;
+        if (game.over) {
+            report(&game, file_errors, path, label, i, "event after the game ended");
+            break;
+        }
+        if (event.kind != RECORD_LEFT) {
+            if (event.seat != game.current) report(&game, file_errors, path, label, i, "out of turn");
+            game.current = event.seat;
+            stats->think_count++;
+            stats->think_us_total += event.think_us;
+            if (event.think_us > stats->think_us_max) stats->think_us_max = event.think_us;
+        }
+
+        int sr, sc, tr, tc;
+        square_coords(event.from, &sr, &sc);
+        square_coords(event.to, &tr, &tc);
+        Move move;
+        switch (event.kind) {
+            case RECORD_MOVE:
+                stats->moves++;
+                if (!replay_is_valid(&game, event.seat, sr, sc, tr, tc, &move)) {
+                    report(&game, file_errors, path, label, i, "recorded move is illegal");
+                    replay_advance(&game);
+                    break;
+                }
+                replay_apply(&game, &move);
+                break;
+            case RECORD_PASS:
+                stats->passes++;
+                if (hasValidMove(&game.board, seat_color(event.seat))) {
+                    report(&game, file_errors, path, label, i, "pass while legal moves remain");
+                }
+                replay_pass(&game);
+                break;
+            case RECORD_TIMEOUT:
+                stats->timeouts++;
+                replay_pass(&game);
+                break;
+            case RECORD_INVALID:
+                stats->invalid++;
+                if (replay_is_valid(&game, event.seat, sr, sc, tr, tc, &move)) {
+                    report(&game, file_errors, path, label, i, "move rejected by the server is legal");
+                }
+                replay_advance(&game);
+                break;
+            case RECORD_LEFT:
+                stats->left++;
+                if (event.seat > 1) break;
+                game.gone[event.seat] = 1;
+                if (game.current == event.seat) game.current = (event.seat + 1) % 2;
+                break;
+            default:
+                report(&game, file_errors, path, label, i, "unknown event kind");
+                break;
+        }
+    }
+
+    int abandoned = (record->result == RECORD_RESULT_ABANDONED);
+    if (!abandoned && !game.over) {
+        report(&game, file_errors, path, label, record->event_count, "recorded game_over before the game ended");
+    }
+    countPieces(&game.board);
+    if (record->scores[0] != game.board.redCount || record->scores[1] != game.board.blueCount) {
+        char what[96];
+        snprintf(what, sizeof(what), "recorded score %d-%d, replayed %d-%d",
+                 record->scores[0], record->scores[1], game.board.redCount, game.board.blueCount);
+        report(&game, file_errors, path, label, record->event_count, what);
+    }
+    replay_finish(&game, stats, abandoned);
+}
+
+static int replay_binary_file(const char *path, ReplayStats *stats) {
+    RecordFile file;
+    if (record_file_open(&file, path) != 0) {
+        perror(path);
+        return -1;
+    }
+    RecordView record;
+    int file_errors = 0;
+    int result;
+    while ((result = record_file_next(&file, &record)) == 1) {
+        replay_record(&record, path, stats, &file_errors);
+    }
+    if (result < 0) {
+        printf("%s: broken record at offset %zu (%zu bytes not replayed)\n", path, file.offset,
+               file.size - file.offset);
+    }
+    stats->bytes += file.offset;
+    record_file_close(&file);
+    return (result < 0) ? -1 : 0;
+}
+
+// ---- JSONL 스크립트 ----
+// register 두 줄(먼저 온 쪽이 R)로 대국이 시작되고, move 줄을 파일 순서대로 서버처럼 처리한다.
+// 차례가 아닌 플레이어의 수와 둘 곳이 있는데 보낸 패스는 invalid_move만 받고 차례가 그대로다 (서버와 같음).
+// 스크립트에는 비교할 결과가 없으므로 invalid_move는 출력만 하고, 대국에 없는 플레이어의 수만 불일치로 센다.
+
+typedef struct {
+    Replay game;
+    int players;                    // 지금까지 register한 수 (2가 되면 대국 시작)
+    char names[2][64];
+    int index;                      // 대국 번호 (출력용)
+    size_t event;                   // 이 대국의 move 줄 번호
+    int file_errors;
+} ScriptState;
+
+static void script_line(ScriptState *state, char *line, const char *path, ReplayStats *stats) {
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+    if (length == 0) return;
+    stats->bytes += length + 1;
+
+    // 서버와 같이 빠른 경로로 디코드하고, 안 되면 트리로 (트리는 이 줄 처리가 끝나면 해제)
+    DecodedMessage message;
+    JsonValue *json = NULL;
+    if (!decodeMessage(line, &message)) {
+        json = json_parse(line);
+        if (!json) {
+            if (!quiet && ++state->file_errors <= MAX_ERRORS_PER_FILE) printf("%s: invalid JSON line\n", path);
+            return;
+        }
+        decodeMessageTree(json, &message);
+    }
+
+    char label[32];
+    snprintf(label, sizeof(label), "game %d", state->index);
+    if (message.type == MSG_REGISTER && (message.fields & DECODED_USERNAME)) {
+        if (state->players == 2) {
+            // 앞 대국이 끝나지 않은 채 새 대국이 시작됨
+            stats->unfinished++;
+            state->players = 0;
+        }
+        strncpy(state->names[state->players], message.username, sizeof(state->names[0]) - 1);
+        state->names[state->players][sizeof(state->names[0]) - 1] = '\0';
+        if (++state->players == 2) {
+            replay_start(&state->game);
+            state->index++;
+            state->event = 0;
+        }
+    } else if (message.type == MSG_MOVE && state->players == 2 && (message.fields & DECODED_MOVE)) {
+        Replay *game = &state->game;
+        size_t event = state->event++;
+        stats->events++;
+        int seat = -1;
+        for (int i = 0; i < 2; i++) {
+            if ((message.fields & DECODED_USERNAME) && strcmp(message.username, state->names[i]) == 0) seat = i;
+        }
+        // username이 없는 줄은 차례인 쪽의 수로 봄
+        if (!(message.fields & DECODED_USERNAME)) seat = game->current;
+
+        const Move *wire = &message.move;
+        Move move;
+        if (seat < 0) {
+            report(game, &state->file_errors, path, label, event, "move from a player not in this game");
+        } else if (seat != game->current) {
+            stats->invalid++;
+            note(&state->file_errors, path, label, event, "out of turn (invalid_move)");
+        } else if (wire->sourceRow == 0 && wire->sourceCol == 0 && wire->targetRow == 0 && wire->targetCol == 0) {
+            if (hasValidMove(&game->board, seat_color(seat))) {
+                stats->invalid++;
+                note(&state->file_errors, path, label, event, "pass while legal moves remain (invalid_move)");
+            } else {
+                stats->passes++;
+                replay_pass(game);
+            }
+        } else if (replay_is_valid(game, seat, wire->sourceRow - 1, wire->sourceCol - 1,
+                                   wire->targetRow - 1, wire->targetCol - 1, &move)) {
+            stats->moves++;
+            replay_apply(game, &move);
+        } else {
+            stats->invalid++;
+            note(&state->file_errors, path, label, event, "illegal move (invalid_move, turn passes)");
+            replay_advance(game);
+        }
+        if (game->over) {
+            replay_finish(game, stats, 0);
+            state->players = 0;
+        }
+    }
+
+    if (json) json_free(json);
+}
+
+// 한 파일(-i면 두 파일을 한 줄씩 번갈아)을 스크립트로 재생
+static int replay_script(const char *path, const char *pair_path, ReplayStats *stats) {
+    FILE *files[2] = { fopen(path, "r"), pair_path ? fopen(pair_path, "r") : NULL };
+    if (!files[0] || (pair_path && !files[1])) {
+        perror(!files[0] ? path : pair_path);
+        for (int i = 0; i < 2; i++) if (files[i]) fclose(files[i]);
+        return -1;
+    }
+
+    ScriptState state;
+    memset(&state, 0, sizeof(state));
+    char *line = NULL;
+    size_t capacity = 0;
+    int turn = 0;
+    int open_count = pair_path ? 2 : 1;
+    while (open_count > 0) {
+        FILE *file = files[turn];
+        if (file) {
+            if (getline(&line, &capacity, file) < 0) {
+                fclose(file);
+                files[turn] = NULL;
+                open_count--;
+            } else {
+                script_line(&state, line, path, stats);
+            }
+        }
+        if (pair_path) turn = 1 - turn;
+    }
+    free(line);
+    if (state.players == 2) stats->unfinished++;
+    return 0;
+}
+
+// ---- 병렬 처리 ----
+
+static int is_record_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+    char magic[8];
+    int match = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                memcmp(magic, RECORD_FILE_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return match;
+}
+
+static void *replay_worker(void *arg) {
+    ReplayStats *stats = (ReplayStats*)arg;
+    int index;
+    while ((index = __atomic_fetch_add(&next_job, 1, __ATOMIC_RELAXED)) < job_count) {
+        const ReplayJob *job = &jobs[index];
+        int result;
+        if (!job->pair_path && is_record_file(job->path)) result = replay_binary_file(job->path, stats);
+        else result = replay_script(job->path, job->pair_path, stats);
+        if (result != 0) stats->failed_files++;
+    }
+    return NULL;
+}
+
+// 스레드별 통계 합치기 (모든 필드가 uint64_t 카운터, think_us_max만 최댓값)
+static void merge_stats(ReplayStats *total, const ReplayStats *part) {
+    uint64_t max = (part->think_us_max > total->think_us_max) ? part->think_us_max : total->think_us_max;
+    uint64_t *dst = (uint64_t*)total;
+    const uint64_t *src = (const uint64_t*)part;
+    for (size_t i = 0; i < sizeof(ReplayStats) / sizeof(uint64_t); i++) dst[i] += src[i];
+    total->think_us_max = max;
+}
+
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options] <file>...\n", program_name);
+    printf("대국 기록(서버 -r 파일) 또는 JSONL 스크립트를 규칙 엔진으로 다시 두어 검증하고 통계를 출력\n");
+    printf("Options:\n");
+    printf("  -j, --threads <n>    동시에 처리할 파일 수 (기본값: CPU 코어 수, 최대 %d)\n", MAX_THREADS);
+    printf("  -i, --interleave     JSONL 파일을 두 개씩 한 대국의 양쪽으로 보고 한 줄씩 번갈아 읽음\n");
+    printf("  -q, --quiet          대국별 불일치를 출력하지 않음 (통계만)\n");
+    printf("  -h, --help           이 도움말 표시\n");
+    printf("\n");
+    printf("Examples:\n");
+    printf("  %s games.ofr                          # 서버 기록 파일 검증\n", program_name);
+    printf("  %s -j 8 league/*.ofr                  # 파일 여러 개를 8개 스레드로\n", program_name);
+    printf("  %s -i server_check/alice.jsonl server_check/bob.jsonl\n", program_name);
+}
+
+static double monotonic_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int threads = 0;
+    jobs = (ReplayJob*)calloc((size_t)argc, sizeof(ReplayJob));
+    if (!jobs) return EXIT_FAILURE;
+
+    const char *pending = NULL;     // -i: 짝을 기다리는 파일
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 스레드 수가 필요합니다.\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            threads = atoi(argv[i + 1]);
+            if (threads < 1 || threads > MAX_THREADS) {
+                fprintf(stderr, "Error: 유효하지 않은 스레드 수: %s (1-%d 범위여야 합니다)\n", argv[i + 1], MAX_THREADS);
+                return EXIT_FAILURE;
+            }
+            i++; // 다음 인자 건너뛰기
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--interleave") == 0) {
+            interleave = 1;
+        } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: 알 수 없는 옵션: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else if (interleave && !pending) {
+            pending = argv[i];
+        } else {
+            jobs[job_count].path = interleave ? pending : argv[i];
+            jobs[job_count].pair_path = interleave ? argv[i] : NULL;
+            job_count++;
+            pending = NULL;
+        }
+    }
+    if (pending) {
+        fprintf(stderr, "Error: -i에는 JSONL 파일이 두 개씩 필요합니다 (%s의 짝이 없음)\n", pending);
+        return EXIT_FAILURE;
+    }
+    if (job_count == 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus < 1) ? 1 : (cpus > MAX_THREADS ? MAX_THREADS : (int)cpus);
+    }
+    if (threads > job_count) threads = job_count;
+
+    ReplayStats parts[MAX_THREADS];
+    pthread_t workers[MAX_THREADS];
+    memset(parts, 0, sizeof(parts));
+    double start = monotonic_sec();
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[i], NULL, replay_worker, &parts[i]) != 0) {
+            fprintf(stderr, "Error: 스레드 %d 생성 실패\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    replay_worker(&parts[0]);
+    ReplayStats total = parts[0];
+    for (int i = 1; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+        merge_stats(&total, &parts[i]);
+    }
+    double elapsed = monotonic_sec() - start;
+    if (elapsed <= 0) elapsed = 1e-9;
+
+    printf("files: %d (%llu failed), %.1f MB\n", job_count, (unsigned long long)total.failed_files,
+           total.bytes / 1e6);
+    printf("games: %llu (R wins %llu, B wins %llu, draws %llu, abandoned %llu, unfinished %llu)\n",
+           (unsigned long long)total.games, (unsigned long long)total.red_wins,
+           (unsigned long long)total.blue_wins, (unsigned long long)total.draws,
+           (unsigned long long)total.abandoned, (unsigned long long)total.unfinished);
+    printf("events: %llu (moves %llu, passes %llu, timeouts %llu, invalid %llu, left %llu), %.1f per game\n",
+           (unsigned long long)total.events, (unsigned long long)total.moves,
+           (unsigned long long)total.passes, (unsigned long long)total.timeouts,
+           (unsigned long long)total.invalid, (unsigned long long)total.left,
+           total.games ? (double)total.events / total.games : 0.0);
+    if (total.think_count > 0) {
+        printf("think time: avg %.1f ms, max %.1f ms\n",
+               total.think_us_total / 1e3 / total.think_count, total.think_us_max / 1e3);
+    }
+    printf("mismatched games: %llu\n", (unsigned long long)total.mismatches);
+    printf("replayed in %.3f sec with %d threads: %.0f games/sec, %.0f events/sec\n",
+           elapsed, threads, total.games / elapsed, total.events / elapsed);
+
+    free(jobs);
+    return (total.mismatches > 0 || total.failed_files > 0) ? EXIT_FAILURE : 0;
+}
@@ -10,67 +10,182 @@
 #include <sys/time.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <pthread.h>
 #include "octaflip.h"
 #include "json.h"
 #include "message_handler.h"
+#include "game_session.h"
+#include "lobby.h"
+#include "hash_map.h"
+#include "timer_queue.h"
+#include "output_buffer.h"
+#include "msg_writer.h"
+#include "msg_decoder.h"
+#include "board_delta.h"
+#include "framer.h"
+#include "fanout.h"
+#include "game_record.h"
+#include "metrics.h"
 #include <stdbool.h>
 #define DEFAULT_PORT 8888
-#define MAX_CLIENTS 2
-#define BUFFER_SIZE 1024
-#define TIMEOUT_SEC 5.0
-Move move;
-// 클라이언트 구조체
-typedef struct {
+#define MAX_EVENTS 256        // epoll_wait 한 번에 받을 이벤트 수
+#define MAX_SHARDS 64         // 게임 리액터 스레드 최대 수
+// 송신 버퍼 한계: HIGH_WATER를 넘으면 그 연결의 요청을 더 읽지 않고, LOW_WATER 밑으로 내려가면 다시 읽는다.
+// HARD_LIMIT를 넘거나 SLOW_CLIENT_SEC 동안 버퍼를 비우지 못하면 느린 연결로 보고 끊는다.
+#define OUTPUT_HIGH_WATER (64 * 1024)
+#define OUTPUT_LOW_WATER (16 * 1024)
+#define OUTPUT_HARD_LIMIT (1024 * 1024)
+#define SLOW_CLIENT_SEC 30.0
+#define DEFAULT_MOVE_TIME_SEC 5.0  // 한 수 제한 시간 기본값
+// 관전자 송신 대기열이 이만큼 밀리면 중간 수(watch_move)를 버리고 대국마다 최신 수만 다시 보낸다
+#define SPECTATOR_MAX_LAG 1024
+
+typedef struct Reactor Reactor;
+
+// 클라이언트(연결) 구조체
+struct Client {
     int socket;
     char username[64];
-    char color;  // 'R' 또는 'B'
-} Client;
-
-// 서버 상태 관리
-typedef enum {
-    SERVER_WAITING_PLAYERS,
-    SERVER_GAME_IN_PROGRESS,
-    SERVER_GAME_OVER
-} ServerState;
-typedef struct {
-    char buffer[BUFFER_SIZE * 2];  // 더 큰 버퍼
-    size_t length;
-} ClientBuffer;
+    char color;             // 'R' 또는 'B' (게임 중일 때)
+    int registered;
+    GameSession *session;   // 진행 중인 게임 (로비 대기 중이면 NULL)
+    int seat;               // session->players 인덱스
+    int in_lobby;           // 로비 대기열에 있음
+    LineFramer in;          // 받은 데이터 (개행 단위로 잘라 처리)
+    int binary;             // 바이너리 프레이밍 협상됨 (register_ack 이후 양방향)
+    int delta;              // 보드 델타 협상됨 (board_delta.h)
+    int board_synced;       // 이번 대국 보드를 보낸 적 있음 (아래 board_seq가 유효)
+    uint32_t board_seq;     // 마지막으로 보낸 보드의 seq
+    int deltas_since_snapshot;
+    OutputBuffer out;       // 보낼 메시지 (루프 끝 또는 쓰기 가능 알림 때 전송)
+    int dirty;              // 이번 루프에 보낼 메시지가 생겨 dirty 목록에 있음
+    int want_write;         // 다 못 보내 EPOLLOUT을 기다리는 중
+    int read_paused;        // 송신 버퍼가 HIGH_WATER를 넘어 읽기를 멈춤
+    int evict;              // 송신 버퍼 한계 초과: 루프 끝에 연결 종료
+    Timer write_timer;      // EPOLLOUT 대기가 너무 길어지면 연결 종료
+    Client *next_dirty;
+    Reactor *owner;         // 이 연결을 처리하는 리액터 (로비 또는 게임 샤드)
+    int handoff;            // 다른 리액터로 넘어가는 중: 이번 루프에서는 더 읽지 않음
+    Client *next_closed;    // 이번 이벤트 루프가 끝나면 해제할 연결 목록
+    Client *next_handoff;   // 리액터 간 인계 목록
+    int spectator;          // 관전 연결 (spectate 이후 관전 리액터 소속, 보내는 메시지는 무시)
+    int watch_games[DECODED_MAX_GAMES];   // 관전할 대국 번호 (watch_count가 0이면 모든 대국)
+    int watch_count;
+    FrameQueue feed;        // 관전 스트림 (out을 다 보낸 뒤 이어서 보냄)
+};
+
+// 리액터: 스레드 하나가 epoll 하나로 자기 연결/세션/타이머를 전담한다.
+// 로비 리액터(메인 스레드)는 accept, 등록, 매칭만 하고 매칭된 세션을 게임 샤드에 넘긴다.
+// 게임 중 이동 처리는 샤드 안에서 끝나므로 락을 잡지 않는다.
+struct Reactor {
+    int id;                         // 0: 로비, 1..N: 게임 샤드, N+1: 관전
+    pthread_t thread;
+    int epoll_fd;
+    int timer_fd;
+    int wake_fd;                    // eventfd: 메일박스 도착 알림
+    int listen_fd;                  // 로비만 사용, 샤드는 -1
+    HashMap clients_by_fd;          // fd → Client
+    TimerQueue timers;              // 세션별 턴 마감, 느린 연결 제거
+    uint64_t armed_deadline;        // timerfd에 설정된 마감
+    SessionTable sessions;
+    int client_count;
+    Client *closed_clients;
+    Client *dirty_clients;          // 루프 끝에 송신 버퍼를 비울 연결 목록
+    MessageWriter writer;           // 메시지 직렬화용 (리액터 스레드 전용)
+    JsonArena json_arena;           // 받은 메시지 파싱용 (메시지마다 리셋)
+    GameSession *outgoing_sessions; // 로비: 루프 끝에 샤드로 보낼 새 세션
+    Client *outgoing_clients;       // 샤드: 루프 끝에 로비로 돌려보낼 연결
+    pthread_mutex_t mailbox_lock;   // 아래 두 목록만 보호 (인계할 때만 잡음)
+    GameSession *inbox_sessions;
+    Client *inbox_clients;
+    SharedFrame *outgoing_frames;   // 샤드: 루프 끝에 관전 리액터로 보낼 관전 프레임 (순서대로)
+    SharedFrame *outgoing_frames_tail;
+    SharedFrame *inbox_frames;      // 관전 리액터: 샤드들이 보낸 프레임 (mailbox_lock으로 보호)
+    SharedFrame *inbox_frames_tail;
+    MetricsShard *metrics;          // 이 리액터 스레드만 쌓는 계측 (metrics.h)
+    int stop;                       // 종료 요청: 이번 루프를 마치고 reactor_main에서 나옴
+};
 
-// 전역 변수에 추가
-ClientBuffer client_buffers[MAX_CLIENTS];
 // 전역 변수
-ServerState server_state = SERVER_WAITING_PLAYERS;
-Client clients[MAX_CLIENTS];
-int client_count = 0;
-GameBoard game_board;
-int current_player_idx = 0;
-struct timeval turn_start_time;
+Reactor lobby_reactor;
+Reactor shards[MAX_SHARDS];
+Reactor spectator_hub;              // 관전 연결 전담 (샤드는 프레임만 넘기고 관전자 수와 무관하게 진행)
+int shard_count = 0;
+int next_shard = 0;                 // 로비 스레드만 사용 (라운드 로빈)
+static __thread Reactor *reactor;   // 현재 스레드의 리액터
+int signal_fd = -1;                 // SIGINT/SIGTERM (로비 리액터의 epoll에서 받음)
+
+// 사용자 이름 중복 검사는 모든 스레드가 공유하므로 락으로 보호 (등록/종료 때만 사용)
+HashMap clients_by_name;            // hash_string(username) → Client (등록된 연결만)
+pthread_mutex_t name_lock = PTHREAD_MUTEX_INITIALIZER;
 char server_ip[INET_ADDRSTRLEN] = "127.0.0.1";  // 기본값: 모든 인터페이스
 int server_port = DEFAULT_PORT;
+// 새 대국에 복사되는 시간 규칙 (기본: 대국 시계 없이 수마다 5초)
+size_t max_frame = FRAMER_DEFAULT_MAX_FRAME;   // 클라이언트 메시지 한 줄 최대 길이
+unsigned int server_capabilities = CAPABILITY_BINARY | CAPABILITY_DELTA;  // register에서 받아 줄 수 있는 capabilities
+TimeControl time_control = { 0, 0, (uint64_t)(DEFAULT_MOVE_TIME_SEC * 1e9) };
+// 대국 기록 파일 (-r로 켬, 없으면 NULL)
+const char *record_path = NULL;
+RecordLog record_log;
+// spectate를 받은 연결 수 (0이면 샤드는 관전 프레임을 만들지 않음)
+int spectator_count = 0;
+// 관리 소켓 포트 (-a로 켬, 0이면 계측을 내보내지 않음)
+int admin_port = 0;
+
+// 관전 리액터 스레드 전용: 진행 중인 대국의 관전 상태
+typedef struct {
+    Client **items;
+    size_t count;
+    size_t capacity;
+} WatcherList;
+
+typedef struct GameFeed {
+    int game_id;
+    SharedFrame *start;             // watch_start (관전 중에 시작한 대국만)
+    SharedFrame *latest;            // 마지막 프레임 (늦게 온 관전자와 밀린 관전자에게 다시 보냄)
+    WatcherList watchers;           // 이 대국만 골라 관전하는 연결
+    struct GameFeed *prev;
+    struct GameFeed *next;
+} GameFeed;
+
+static HashMap game_feeds;          // 대국 번호 → GameFeed
+static GameFeed *feed_list;         // 모든 대국 관전자에게 다시 보낼 때 순회
+static WatcherList all_watchers;    // 모든 대국을 관전하는 연결
 // 함수 선언
-void handle_client_message(int client_idx, char *buffer);
-void handle_register_message(int client_idx, JsonValue *json_obj);
-void handle_move_message(int client_idx, JsonValue *json_obj);
-void handle_client_disconnect(int socket_fd);
-void broadcast_game_start();
-void send_your_turn(int client_idx);
-void check_timeout();
-void broadcast_game_over();
-void log_game_state(const char *action, int player_idx, Move *move);
+void handle_client_message(Client *client, char *buffer, size_t len);
+void handle_register_message(Client *client, const DecodedMessage *message);
+void handle_move_message(Client *client, const DecodedMessage *message);
+void handle_spectate_message(Client *client, const DecodedMessage *message);
+void handle_client_disconnect(Client *client);
+void match_lobby_players();
+void broadcast_game_start(GameSession *session);
+void send_your_turn(GameSession *session);
+void on_turn_timeout(void *arg);
+void on_write_timeout(void *arg);
+static void read_client(Client *client);
+static void unwatch_games(Client *client);
+static void clear_feeds();
+void return_to_lobby(Client *client);
+void broadcast_game_over(GameSession *session);
+void log_game_state(GameSession *session, const char *action, int seat, Move *move);
 int set_socket_nonblocking(int socket_fd);
-void cleanup_and_exit(int signal);
-void init_client_buffers() {
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        memset(&client_buffers[i], 0, sizeof(ClientBuffer));
-    }
-}
 void print_usage(const char *program_name) {
     printf("Usage: %s [options]\n", program_name);
     printf("Options:\n");
     printf("  -p, --port <port>    서버 포트 번호 (기본값: %d)\n", DEFAULT_PORT);
     printf("  -i, --ip <ip>        서버 IP 주소 (기본값: 0.0.0.0 - 모든 인터페이스)\n");
+    printf("  -t, --threads <n>    게임 리액터 스레드 수 (기본값: CPU 코어 수, 최대 %d)\n", MAX_SHARDS);
+    printf("  -c, --clock <초>[+<초>]  대국 시계: 플레이어당 기본 시간과 수마다 더해지는 시간 (기본값: 없음)\n");
+    printf("  -m, --move-time <초> 한 수 제한 시간, 0이면 대국 시계만 사용 (기본값: %.1f)\n", DEFAULT_MOVE_TIME_SEC);
+    printf("  -f, --max-frame <바이트>  클라이언트 메시지 한 줄 최대 길이 (기본값: %d)\n", FRAMER_DEFAULT_MAX_FRAME);
+    printf("  -j, --json-only      바이너리 프레이밍 협상을 거절하고 JSON만 사용\n");
+    printf("  -F, --full-board     보드 델타 협상을 거절하고 매번 보드 전체를 보냄\n");
+    printf("  -r, --record <파일>  끝난 대국을 바이너리 기록 파일에 덧붙임 (기본값: 기록 안 함)\n");
+    printf("  -a, --admin <port>   127.0.0.1:<port>에서 계측을 Prometheus 형식으로 제공 (GET /metrics, 기본값: 끔)\n");
     printf("  -h, --help           이 도움말 표시\n");
     printf("\n");
     printf("Examples:\n");
@@ -78,6 +193,10 @@ void print_usage(const char *program_name) {
     printf("  %s -p 9999                   # 포트 9999로 실행\n", program_name);
     printf("  %s -i 127.0.0.1 -p 8080      # 127.0.0.1:8080으로 실행\n", program_name);
     printf("  %s --ip 192.168.1.100 --port 7777  # 192.168.1.100:7777로 실행\n", program_name);
+    printf("  %s -t 4                      # 게임 스레드 4개로 실행\n", program_name);
+    printf("  %s -c 60+2 -m 0              # 1분 + 수마다 2초, 한 수 제한 없음\n", program_name);
+    printf("  %s -r games.ofr              # 대국 기록을 games.ofr에 남김\n", program_name);
+    printf("  %s -a 9100                   # http://127.0.0.1:9100/metrics 에서 계측 확인\n", program_name);
 }
 int parse_arguments(int argc, char *argv[]) {
     for (int i = 1; i < argc; i++) {
@@ -86,20 +205,20 @@ int parse_arguments(int argc, char *argv[]) {
                 fprintf(stderr, "Error: %s 옵션에 포트 번호가 필요합니다.\n", argv[i]);
                 return -1;
             }
-            
+
             server_port = atoi(argv[i + 1]);
             if (server_port <= 0 || server_port > 65535) {
                 fprintf(stderr, "Error: 유효하지 않은 포트 번호: %s (1-65535 범위여야 합니다)\n", argv[i + 1]);
                 return -1;
             }
             i++; // 다음 인자 건너뛰기
-            
+
         } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--ip") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "Error: %s 옵션에 IP 주소가 필요합니다.\n", argv[i]);
                 return -1;
             }
-            
+
             // IP 주소 유효성 검사
             struct sockaddr_in sa;
             int result = inet_pton(AF_INET, argv[i + 1], &(sa.sin_addr));
@@ -107,36 +226,151 @@ int parse_arguments(int argc, char *argv[]) {
                 fprintf(stderr, "Error: 유효하지 않은 IP 주소: %s\n", argv[i + 1]);
                 return -1;
             }
-            
+
             strncpy(server_ip, argv[i + 1], sizeof(server_ip) - 1);
             server_ip[sizeof(server_ip) - 1] = '\0';
             i++; // 다음 인자 건너뛰기
-            
+
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 스레드 수가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+
+            shard_count = atoi(argv[i + 1]);
+            if (shard_count < 1 || shard_count > MAX_SHARDS) {
+                fprintf(stderr, "Error: 유효하지 않은 스레드 수: %s (1-%d 범위여야 합니다)\n", argv[i + 1], MAX_SHARDS);
+                return -1;
+            }
+            i++; // 다음 인자 건너뛰기
+
+        } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--clock") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 시간이 필요합니다.\n", argv[i]);
+                return -1;
+            }
+
+            // "기본[+증가]" 형식 (초 단위, 소수 허용)
+            char *end;
+            double base = strtod(argv[i + 1], &end);
+            double increment = 0.0;
+            if (*end == '+') increment = strtod(end + 1, &end);
+            if (end == argv[i + 1] || *end != '\0' || base <= 0.0 || increment < 0.0) {
+                fprintf(stderr, "Error: 유효하지 않은 대국 시계: %s (예: 60+2)\n", argv[i + 1]);
+                return -1;
+            }
+            time_control.base_ns = (uint64_t)(base * 1e9);
+            time_control.increment_ns = (uint64_t)(increment * 1e9);
+            i++; // 다음 인자 건너뛰기
+
+        } else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--move-time") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 시간이 필요합니다.\n", argv[i]);
+                return -1;
+            }
+
+            char *end;
+            double move_time = strtod(argv[i + 1], &end);
+            if (end == argv[i + 1] || *end != '\0' || move_time < 0.0) {
+                fprintf(stderr, "Error: 유효하지 않은 한 수 제한 시간: %s\n", argv[i + 1]);
+                return -1;
+            }
+            time_control.move_limit_ns = (uint64_t)(move_time * 1e9);
+            i++; // 다음 인자 건너뛰기
+
+        } else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--max-frame") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 바이트 수가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+
+            long value = atol(argv[i + 1]);
+            if (value < 64 || value > 1024 * 1024) {
+                fprintf(stderr, "Error: 유효하지 않은 최대 메시지 길이: %s (64-1048576 범위여야 합니다)\n", argv[i + 1]);
+                return -1;
+            }
+            max_frame = (size_t)value;
+            i++; // 다음 인자 건너뛰기
+
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json-only") == 0) {
+            server_capabilities &= ~CAPABILITY_BINARY;
+
+        } else if (strcmp(argv[i], "-F") == 0 || strcmp(argv[i], "--full-board") == 0) {
+            server_capabilities &= ~CAPABILITY_DELTA;
+
+        } else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--record") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 파일 경로가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+            record_path = argv[i + 1];
+            i++; // 다음 인자 건너뛰기
+
+        } else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--admin") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s 옵션에 포트 번호가 필요합니다.\n", argv[i]);
+                return -1;
+            }
+
+            admin_port = atoi(argv[i + 1]);
+            if (admin_port <= 0 || admin_port > 65535) {
+                fprintf(stderr, "Error: 유효하지 않은 관리 포트 번호: %s (1-65535 범위여야 합니다)\n", argv[i + 1]);
+                return -1;
+            }
+            i++; // 다음 인자 건너뛰기
+
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             exit(0);
-            
+
         } else {
             fprintf(stderr, "Error: 알 수 없는 옵션: %s\n", argv[i]);
             print_usage(argv[0]);
             return -1;
         }
     }
-    
+
+    if (admin_port != 0 && admin_port == server_port) {
+        fprintf(stderr, "Error: 관리 포트는 서버 포트와 달라야 합니다.\n");
+        return -1;
+    }
+
+    if (time_control.base_ns == 0 && time_control.move_limit_ns == 0) {
+        fprintf(stderr, "Error: 대국 시계(-c) 없이 한 수 제한 시간을 0으로 둘 수 없습니다.\n");
+        return -1;
+    }
+
     return 0;
 }
-// 시그널 핸들러
-void cleanup_and_exit(int signal __attribute__((unused))) {
+// 서버 종료: 로비 루프가 종료 시그널을 받아 끝난 뒤 메인 스레드에서 호출.
+// 시그널 핸들러가 아니라 보통 스레드 문맥이므로 락/조인을 써도 되고, 샤드를 먼저 멈춘 뒤라 기록을 쓰는 쪽도 없다
+static void shutdown_server(void) {
     printf("\n서버 종료 중...\n");
-    
-    // 클라이언트 소켓 닫기
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket != -1) {
-            close(clients[i].socket);
+
+    // 게임 샤드를 먼저 멈추고 (관전 프레임을 보내는 쪽) 관전 리액터를 멈춤
+    for (int r = 1; r <= shard_count + 1; r++) {
+        Reactor *target = (r > shard_count) ? &spectator_hub : &shards[r - 1];
+        __atomic_store_n(&target->stop, 1, __ATOMIC_RELEASE);
+        uint64_t one = 1;
+        if (write(target->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            perror("eventfd write");
+        }
+        pthread_join(target->thread, NULL);
+    }
+
+    // 클라이언트 소켓 닫기 (모든 리액터가 멈춘 뒤라 경합 없음)
+    for (int r = 0; r <= shard_count + 1; r++) {
+        Reactor *target = (r == 0) ? &lobby_reactor : (r > shard_count) ? &spectator_hub : &shards[r - 1];
+        for (size_t i = 0; i < target->clients_by_fd.capacity; i++) {
+            Client *client = (Client*)target->clients_by_fd.entries[i].value;
+            if (client && client->socket != -1) {
+                close(client->socket);
+            }
         }
     }
-    
-    exit(0);
+
+    // 아직 쓰지 않은 대국 기록을 쓰고 fsync
+    if (record_path) record_log_close(&record_log);
 }
 
 // 비차단 소켓 설정
@@ -146,350 +380,908 @@ int set_socket_nonblocking(int socket_fd) {
         perror("fcntl F_GETFL");
         return -1;
     }
-    
+
     if (fcntl(socket_fd, F_SETFL, flags | O_NONBLOCK) == -1) {
         perror("fcntl F_SETFL O_NONBLOCK");
         return -1;
     }
-    
+
     return 0;
 }
-void process_client_data(int client_idx, char *new_data, size_t data_len) {
-    ClientBuffer *cb = &client_buffers[client_idx];
-    
-    // 새 데이터를 버퍼에 추가
-    if (cb->length + data_len >= sizeof(cb->buffer) - 1) {
-        printf("[Server] Buffer overflow for client %d, resetting\n", client_idx);
-        cb->length = 0;  // 버퍼 리셋
-    }
-    
-    memcpy(cb->buffer + cb->length, new_data, data_len);
-    cb->length += data_len;
-    cb->buffer[cb->length] = '\0';
-    
-    // 개행문자('\n')로 구분된 완전한 메시지들 처리
-    char *start = cb->buffer;
-    char *newline_pos;
-    
-    while ((newline_pos = strchr(start, '\n')) != NULL) {
-        *newline_pos = '\0';  // 개행문자를 null terminator로 변경
-        
+
+// 이번 루프 끝에 송신 버퍼를 비울 목록에 올림
+static void mark_dirty(Client *client) {
+    if (!client->dirty) {
+        client->dirty = 1;
+        client->next_dirty = reactor->dirty_clients;
+        reactor->dirty_clients = client;
+    }
+}
+
+// 송신 버퍼에 메시지를 쌓고 이번 루프 끝에 보낼 목록에 올림.
+// 같은 루프에서 같은 연결로 가는 메시지들은 한 번의 sendmsg로 나간다.
+static void send_message(Client *client, const MessageWriter *msg) {
+    if (!client || client->socket == -1) return;
+    if (msg->overflow) {
+        fprintf(stderr, "[Server] Message too large for %s, dropped\n", client->username);
+        return;
+    }
+    if (client->evict) return;
+    // 연결이 협상한 형식을 고름 (두 형식 모두 writer가 미리 만들어 둠)
+    const void *data = msg->data;
+    size_t length = msg->length;
+    if (client->binary) {
+        if (msg->binary_length == 0) {
+            fprintf(stderr, "[Server] Binary frame too large for %s, dropped\n", client->username);
+            return;
+        }
+        data = msg->binary;
+        length = msg->binary_length;
+    }
+    if (output_buffer_pending(&client->out) + length > OUTPUT_HARD_LIMIT ||
+        output_buffer_append(&client->out, data, length) != 0) {
+        // 여기서 바로 끊으면 메시지를 만들던 쪽(세션 처리)이 꼬이므로 루프 끝에서 정리
+        fprintf(stderr, "[Server] Output buffer limit reached for %s (%zu bytes pending), evicting\n",
+                client->username, output_buffer_pending(&client->out));
+        client->evict = 1;
+    }
+    mark_dirty(client);
+}
+
+// 세션의 두 플레이어에게 같은 메시지 전송 (직렬화는 한 번)
+static void broadcast_message(GameSession *session, const MessageWriter *msg) {
+    for (int i = 0; i < SESSION_PLAYERS; i++) {
+        send_message(session->players[i], msg);
+    }
+}
+
+// 받아 둔 데이터에서 완성된 메시지(줄)를 모두 처리
+void process_client_frames(Client *client) {
+    char *line;
+    size_t len;
+    int result;
+    // 다른 리액터로 넘어가는 연결의 남은 메시지는 새 리액터가 처리
+    while (!client->handoff && (result = framer_next(&client->in, &line, &len)) != 0) {
+        if (result < 0) {
+            printf("[Server] Message from %s exceeds %zu bytes, dropped\n",
+                   client->username, client->in.max_frame);
+            metrics_count(reactor->metrics, COUNTER_OVERSIZED);
+            // 바이너리 프레임은 길이를 믿을 수 없게 된 뒤로는 다시 맞출 방법이 없으므로 연결을 끊음
+            if (client->binary) {
+                handle_client_disconnect(client);
+                return;
+            }
+            continue;
+        }
         // 빈 메시지가 아닌 경우에만 처리
-        if (strlen(start) > 0) {
-            printf("[Server] Processing complete JSON: %s\n", start);
-            handle_client_message(client_idx, start);
-        }
-        
-        start = newline_pos + 1;  // 다음 메시지로 이동
-    }
-    
-    // 처리되지 않은 부분적 메시지를 버퍼 앞으로 이동
-    size_t remaining = strlen(start);
-    if (remaining > 0) {
-        memmove(cb->buffer, start, remaining + 1);  // null terminator 포함
-        cb->length = remaining;
+        if (len == 0) continue;
+
+        if (client->binary) {
+            printf("[Server] Processing binary frame from %s (%zu bytes)\n", client->username, len);
+        } else {
+            printf("[Server] Processing complete JSON: %s\n", line);
+        }
+        handle_client_message(client, line, len);
+        // 처리 중 연결이 끊겼으면(register_nack 등) 남은 데이터는 버림
+        if (client->socket == -1) return;
+    }
+}
+
+// 등록된 이름 해제 (다른 연결이 같은 해시로 등록돼 있으면 건드리지 않음)
+static void unregister_name(Client *client) {
+    if (!client->registered) return;
+    uint64_t key = hash_string(client->username);
+    pthread_mutex_lock(&name_lock);
+    if (hash_map_get(&clients_by_name, key) == client) {
+        hash_map_remove(&clients_by_name, key);
+    }
+    pthread_mutex_unlock(&name_lock);
+    client->registered = 0;
+}
+
+// 연결 정리. 소켓을 닫고(epoll에서도 자동 제거) 메모리는 이벤트 루프 끝에서 해제한다.
+// 같은 루프 안에서 아직 이 포인터를 쥐고 있는 코드가 있을 수 있기 때문.
+static void release_client(Client *client) {
+    if (client->socket == -1) return;
+    hash_map_remove(&reactor->clients_by_fd, (uint64_t)client->socket);
+    timer_cancel(&reactor->timers, &client->write_timer);
+    // 닫기 전에 남은 메시지(register_nack 등)를 한 번 더 보내 봄
+    output_buffer_flush(&client->out, client->socket);
+    close(client->socket);
+    client->socket = -1;
+    unregister_name(client);
+    if (client->spectator) {
+        if (reactor == &spectator_hub) unwatch_games(client);
+        // 마지막 관전자가 나가면 샤드는 프레임을 그만 만들고, 쌓아 둔 대국 상태도 버림
+        metrics_gauge(reactor->metrics, GAUGE_SPECTATORS, -1);
+        if (__atomic_sub_fetch(&spectator_count, 1, __ATOMIC_RELAXED) == 0 && reactor == &spectator_hub) {
+            clear_feeds();
+        }
+        client->spectator = 0;
+    }
+    client->in_lobby = 0;
+    client->session = NULL;
+    metrics_gauge(reactor->metrics, GAUGE_CONNECTIONS, -1);
+    client->next_closed = reactor->closed_clients;
+    reactor->closed_clients = client;
+    reactor->client_count--;
+}
+
+static void free_closed_clients() {
+    while (reactor->closed_clients) {
+        Client *next = reactor->closed_clients->next_closed;
+        framer_destroy(&reactor->closed_clients->in);
+        output_buffer_destroy(&reactor->closed_clients->out);
+        frame_queue_destroy(&reactor->closed_clients->feed);
+        free(reactor->closed_clients);
+        reactor->closed_clients = next;
+    }
+}
+
+// 세션 종료: 턴 타이머 취소 후 해제
+static void end_session(GameSession *session) {
+    timer_cancel(&reactor->timers, &session->turn_timer);
+    metrics_count(reactor->metrics, COUNTER_GAMES_FINISHED);
+    metrics_gauge(reactor->metrics, GAUGE_GAMES, -1);
+    if (session->start_ns) metrics_record(reactor->metrics, METRIC_GAME, monotonic_ns() - session->start_ns);
+    session_destroy(&reactor->sessions, session);
+}
+
+// 현재 리액터에서 연결을 떼어냄 (소켓은 열어 둔 채 epoll/fd 맵에서만 제거)
+static void detach_client(Client *client) {
+    timer_cancel(&reactor->timers, &client->write_timer);
+    epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, client->socket, NULL);
+    hash_map_remove(&reactor->clients_by_fd, (uint64_t)client->socket);
+    reactor->client_count--;
+}
+
+// 현재 리액터에 연결을 붙임. 실패하면 연결을 닫는다.
+static int attach_client(Client *client) {
+    client->owner = reactor;
+    client->handoff = 0;
+    if (hash_map_put(&reactor->clients_by_fd, (uint64_t)client->socket, client) != 0) {
+        close(client->socket);
+        client->socket = -1;
+        metrics_gauge(reactor->metrics, GAUGE_CONNECTIONS, -1);
+        unregister_name(client);
+        framer_destroy(&client->in);
+        output_buffer_destroy(&client->out);
+        frame_queue_destroy(&client->feed);
+        free(client);
+        return -1;
+    }
+    reactor->client_count++;
+
+    // edge-triggered ADD는 이미 도착해 있는 데이터/종료도 바로 알려 준다
+    // 이전 리액터에서 다 못 보낸 메시지가 있으면 쓰기 가능 알림도 받는다
+    client->want_write = output_buffer_pending(&client->out) > 0;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (client->want_write ? EPOLLOUT : 0);
+    ev.data.fd = client->socket;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, client->socket, &ev) < 0) {
+        perror("epoll_ctl ADD");
+        release_client(client);
+        return -1;
+    }
+    if (client->want_write) {
+        timer_schedule(&reactor->timers, &client->write_timer,
+                       monotonic_ns() + (uint64_t)(SLOW_CLIENT_SEC * 1e9));
+    }
+    return 0;
+}
+
+// EPOLLOUT 관심 등록/해제 (보낼 것이 남아 있을 때만 쓰기 가능 알림을 받음)
+// 기다리기 시작하면 느린 연결 타이머를 걸고, 다 보내면 해제
+static void set_want_write(Client *client, int want_write) {
+    if (client->want_write == want_write) return;
+    client->want_write = want_write;
+    if (want_write) {
+        timer_schedule(&reactor->timers, &client->write_timer,
+                       monotonic_ns() + (uint64_t)(SLOW_CLIENT_SEC * 1e9));
+    } else {
+        timer_cancel(&reactor->timers, &client->write_timer);
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (want_write ? EPOLLOUT : 0);
+    ev.data.fd = client->socket;
+    epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, client->socket, &ev);
+}
+
+// 송신 버퍼를 소켓이 받아 주는 만큼 보냄. 남으면 EPOLLOUT 때 이어서 보낸다
+static void flush_client(Client *client) {
+    if (client->socket == -1) return;
+    int result = output_buffer_flush(&client->out, client->socket);
+    // 관전 스트림은 앞선 메시지(spectate_ack)를 다 보낸 뒤에
+    if (result == 0 && frame_queue_pending(&client->feed) > 0) {
+        result = frame_queue_flush(&client->feed, client->socket);
+    }
+    if (result < 0) {
+        // 인계 중인 연결은 새 리액터가 읽기 쪽에서 끊김을 처리한다
+        if (!client->handoff) handle_client_disconnect(client);
+        return;
+    }
+    set_want_write(client, result > 0);
+
+    // 충분히 비었으면 멈췄던 읽기 재개 (edge-triggered라 새 알림이 오지 않으므로 직접 읽음)
+    if (client->read_paused && output_buffer_pending(&client->out) <= OUTPUT_LOW_WATER) {
+        client->read_paused = 0;
+        read_client(client);
+    }
+}
+
+// 느린 연결 제거 타이머 콜백
+void on_write_timeout(void *arg) {
+    Client *client = (Client*)arg;
+    if (client->socket == -1) return;
+    printf("[Server] Evicting slow client %s (%zu bytes, %zu frames unsent for %.0f sec)\n",
+           client->username, output_buffer_pending(&client->out), frame_queue_pending(&client->feed),
+           SLOW_CLIENT_SEC);
+    handle_client_disconnect(client);
+}
+
+// 루프 끝: 이번 루프에 메시지가 쌓인 연결들을 비움 (처리 중 새로 쌓인 연결도 포함)
+static void flush_dirty_clients() {
+    while (reactor->dirty_clients) {
+        Client *client = reactor->dirty_clients;
+        reactor->dirty_clients = client->next_dirty;
+        client->dirty = 0;
+        if (client->evict && !client->handoff) {
+            if (client->socket != -1) handle_client_disconnect(client);
+            continue;
+        }
+        flush_client(client);
+    }
+}
+
+// 다른 리액터의 메일박스에 세션 또는 연결을 넣고 깨움
+static void post_to_reactor(Reactor *target, GameSession *session, Client *client) {
+    pthread_mutex_lock(&target->mailbox_lock);
+    if (session) {
+        session->next = target->inbox_sessions;
+        target->inbox_sessions = session;
+    }
+    if (client) {
+        client->next_handoff = target->inbox_clients;
+        target->inbox_clients = client;
+    }
+    pthread_mutex_unlock(&target->mailbox_lock);
+
+    uint64_t one = 1;
+    if (write(target->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("eventfd write");
+    }
+}
+
+// 게임이 끝난 연결은 로비로 돌려보냄 (다시 register하면 새 대국)
+void return_to_lobby(Client *client) {
+    client->handoff = 1;
+    client->next_handoff = reactor->outgoing_clients;
+    reactor->outgoing_clients = client;
+}
+
+// 관전 신청한 연결은 관전 리액터로 넘김
+static void hand_off_spectator(Client *client) {
+    client->handoff = 1;
+    client->next_handoff = reactor->outgoing_clients;
+    reactor->outgoing_clients = client;
+}
+
+// 이번 루프에 만든 관전 프레임을 순서 그대로 관전 리액터 메일박스 끝에 붙임
+static void post_frames() {
+    if (!reactor->outgoing_frames) return;
+    pthread_mutex_lock(&spectator_hub.mailbox_lock);
+    if (spectator_hub.inbox_frames_tail) spectator_hub.inbox_frames_tail->next = reactor->outgoing_frames;
+    else spectator_hub.inbox_frames = reactor->outgoing_frames;
+    spectator_hub.inbox_frames_tail = reactor->outgoing_frames_tail;
+    pthread_mutex_unlock(&spectator_hub.mailbox_lock);
+    reactor->outgoing_frames = NULL;
+    reactor->outgoing_frames_tail = NULL;
+
+    uint64_t one = 1;
+    if (write(spectator_hub.wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("eventfd write");
+    }
+}
+
+// 루프 끝에서 인계 목록 처리: 이 시점 이후로 이 리액터는 해당 연결을 건드리지 않는다
+static void flush_handoffs() {
+    while (reactor->outgoing_sessions) {
+        GameSession *session = reactor->outgoing_sessions;
+        reactor->outgoing_sessions = session->next;
+        Reactor *shard = &shards[next_shard];
+        next_shard = (next_shard + 1) % shard_count;
+        for (int i = 0; i < SESSION_PLAYERS; i++) {
+            detach_client(session->players[i]);
+        }
+        post_to_reactor(shard, session, NULL);
+    }
+    while (reactor->outgoing_clients) {
+        Client *client = reactor->outgoing_clients;
+        reactor->outgoing_clients = client->next_handoff;
+        detach_client(client);
+        post_to_reactor(client->spectator ? &spectator_hub : &lobby_reactor, NULL, client);
+    }
+    post_frames();
+}
+
+// ---- 관전 스트림 ----
+// 샤드는 관전자가 있을 때만 이벤트마다 JSON을 한 번 만들어 SharedFrame으로 넘기고 (관전자 수와 무관),
+// 관전 리액터가 구독자마다 참조만 대기열에 넣어 보낸다. 밀린 관전자는 중간 수를 건너뛰고 최신 보드로 맞춘다.
+
+static int spectators_watching() {
+    return __atomic_load_n(&spectator_count, __ATOMIC_RELAXED) > 0;
+}
+
+// 샤드: 직렬화한 메시지를 프레임으로 만들어 이번 루프 끝에 관전 리액터로 보낼 목록에 붙임
+static void publish_frame(GameSession *session, FrameKind kind, const MessageWriter *msg) {
+    if (msg->overflow) return;
+    SharedFrame *frame = shared_frame_create(kind, session->id, msg->data, msg->length);
+    if (!frame) return;
+    if (reactor->outgoing_frames_tail) reactor->outgoing_frames_tail->next = frame;
+    else reactor->outgoing_frames = frame;
+    reactor->outgoing_frames_tail = frame;
+}
+
+static void publish_watch_start(GameSession *session) {
+    if (!spectators_watching()) return;
+    const char *players[SESSION_PLAYERS] = { session->usernames[0], session->usernames[1] };
+    publish_frame(session, FRAME_WATCH_START,
+                  writeWatchStartMessage(&reactor->writer, session->id, players, session->usernames[0],
+                                         &session->board));
+}
+
+// move는 클라이언트 좌표(1부터), 패스는 (0,0,0,0)
+static void publish_watch_move(GameSession *session, int seat, const Move *move, const char *next_player) {
+    if (!spectators_watching()) return;
+    publish_frame(session, FRAME_WATCH_MOVE,
+                  writeWatchMoveMessage(&reactor->writer, session->id, session->board_seq,
+                                        session->usernames[seat], move, &session->board, next_player));
+}
+
+static void publish_watch_end(GameSession *session, const char *reason, int scores[SESSION_PLAYERS]) {
+    if (!spectators_watching()) return;
+    const char *players[SESSION_PLAYERS] = { session->usernames[0], session->usernames[1] };
+    publish_frame(session, FRAME_WATCH_END,
+                  writeWatchEndMessage(&reactor->writer, session->id, reason, &session->board, players, scores));
+}
+
+static int watcher_list_add(WatcherList *list, Client *client) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 8;
+        Client **items = (Client**)realloc(list->items, sizeof(Client*) * capacity);
+        if (!items) return -1;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = client;
+    return 0;
+}
+
+static void watcher_list_remove(WatcherList *list, Client *client) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (list->items[i] == client) {
+            list->items[i] = list->items[--list->count];
+            return;
+        }
+    }
+}
+
+// 프레임 참조 교체 (새 프레임을 먼저 붙잡음)
+static void set_frame(SharedFrame **slot, SharedFrame *frame) {
+    if (frame) shared_frame_retain(frame);
+    if (*slot) shared_frame_release(*slot);
+    *slot = frame;
+}
+
+static GameFeed* feed_get(int game_id, int create) {
+    GameFeed *feed = (GameFeed*)hash_map_get(&game_feeds, (uint64_t)game_id);
+    if (feed || !create) return feed;
+    feed = (GameFeed*)calloc(1, sizeof(GameFeed));
+    if (!feed) return NULL;
+    feed->game_id = game_id;
+    if (hash_map_put(&game_feeds, (uint64_t)game_id, feed) != 0) {
+        free(feed);
+        return NULL;
+    }
+    feed->next = feed_list;
+    if (feed_list) feed_list->prev = feed;
+    feed_list = feed;
+    return feed;
+}
+
+static void feed_remove(GameFeed *feed) {
+    hash_map_remove(&game_feeds, (uint64_t)feed->game_id);
+    if (feed->prev) feed->prev->next = feed->next;
+    else feed_list = feed->next;
+    if (feed->next) feed->next->prev = feed->prev;
+    set_frame(&feed->start, NULL);
+    set_frame(&feed->latest, NULL);
+    free(feed->watchers.items);
+    free(feed);
+}
+
+static void clear_feeds() {
+    while (feed_list) feed_remove(feed_list);
+}
+
+static void queue_frame(Client *client, SharedFrame *frame) {
+    if (frame_queue_push(&client->feed, frame) != 0) client->evict = 1;
+}
+
+// 대국 하나의 지금 상태 (시작 + 최신 프레임)
+static void queue_feed_state(Client *client, GameFeed *feed) {
+    if (feed->start) queue_frame(client, feed->start);
+    if (feed->latest && feed->latest != feed->start) queue_frame(client, feed->latest);
+}
+
+// 밀린 관전자: 대기열의 중간 수를 버리고 관전 중인 대국마다 최신 수만 다시 넣음 (시작/종료는 그대로)
+static void resync_spectator(Client *client, SharedFrame *incoming) {
+    printf("[Server] %s is %zu frames behind, skipping to latest boards\n",
+           client->username, frame_queue_pending(&client->feed));
+    frame_queue_drop(&client->feed, FRAME_WATCH_MOVE);
+    for (GameFeed *feed = feed_list; feed; feed = feed->next) {
+        if (client->watch_count > 0) {
+            int watching = 0;
+            for (int i = 0; i < client->watch_count; i++) watching |= (client->watch_games[i] == feed->game_id);
+            if (!watching) continue;
+        }
+        if (feed->latest && feed->latest->kind == FRAME_WATCH_MOVE && feed->latest != incoming) {
+            queue_frame(client, feed->latest);
+        }
+    }
+}
+
+static void deliver_frame(Client *client, SharedFrame *frame) {
+    if (client->socket == -1 || client->evict) return;
+    if (frame_queue_pending(&client->feed) >= SPECTATOR_MAX_LAG) resync_spectator(client, frame);
+    queue_frame(client, frame);
+    mark_dirty(client);
+}
+
+// 관전 리액터: 샤드에서 온 프레임 하나를 그 대국 관전자와 모든 대국 관전자에게 보냄
+static void receive_frame(SharedFrame *frame) {
+    shared_frame_retain(frame);
+    if (!spectators_watching()) {
+        clear_feeds();
+        shared_frame_release(frame);
+        return;
+    }
+    GameFeed *feed = feed_get(frame->game_id, 1);
+    if (feed) {
+        if (frame->kind == FRAME_WATCH_START) set_frame(&feed->start, frame);
+        set_frame(&feed->latest, frame);
+        for (size_t i = 0; i < feed->watchers.count; i++) deliver_frame(feed->watchers.items[i], frame);
+    }
+    for (size_t i = 0; i < all_watchers.count; i++) deliver_frame(all_watchers.items[i], frame);
+    // 끝난 대국은 더 보낼 것이 없음 (골라 관전하던 연결은 다른 대국 관전을 계속)
+    if (feed && frame->kind == FRAME_WATCH_END) feed_remove(feed);
+    shared_frame_release(frame);
+}
+
+// 관전 리액터에 붙은 관전자 구독: 이미 진행 중인 대국은 지금 상태부터 보냄
+static void watch_games(Client *client) {
+    if (client->watch_count == 0) {
+        if (watcher_list_add(&all_watchers, client) != 0) client->evict = 1;
+        for (GameFeed *feed = feed_list; feed; feed = feed->next) queue_feed_state(client, feed);
     } else {
-        cb->length = 0;
-        cb->buffer[0] = '\0';
+        for (int i = 0; i < client->watch_count; i++) {
+            GameFeed *feed = feed_get(client->watch_games[i], 1);
+            if (!feed || watcher_list_add(&feed->watchers, client) != 0) {
+                client->evict = 1;
+                break;
+            }
+            queue_feed_state(client, feed);
+        }
     }
+    printf("[Server] %s watching %s (spectators: %d)\n", client->username,
+           client->watch_count ? "selected games" : "all games", reactor->client_count);
+    mark_dirty(client);
 }
-// process_client_data 함수 다음에 추가
 
-void handle_client_disconnect(int socket_fd) {
+static void unwatch_games(Client *client) {
+    if (client->watch_count == 0) {
+        watcher_list_remove(&all_watchers, client);
+        return;
+    }
+    for (int i = 0; i < client->watch_count; i++) {
+        GameFeed *feed = feed_get(client->watch_games[i], 0);
+        if (!feed) continue;
+        watcher_list_remove(&feed->watchers, client);
+        // 아직 시작하지 않은 대국을 기다리던 구독이면 같이 정리
+        if (feed->watchers.count == 0 && !feed->latest) feed_remove(feed);
+    }
+}
+
+// ---- 대국 기록 (game_record.h) ----
+// 진행 중에는 세션에 이벤트만 쌓고, 끝날 때 레코드 하나로 만들어 기록 파일 버퍼에 넘긴다
+
+// move는 클라이언트 좌표 (패스, 시간 초과, 연결 끊김은 NULL). 생각한 시간은 이번 턴 시작부터
+static void record_event(GameSession *session, RecordEventKind kind, int seat, const Move *move) {
+    if (!record_path && !metrics_enabled) return;
+    uint64_t think_ns = session->turn_start_ns ? monotonic_ns() - session->turn_start_ns : 0;
+    // 생각 시간은 실제로 끝난 턴만 (연결 끊김 제외)
+    if (kind != RECORD_LEFT && session->turn_start_ns) metrics_record(reactor->metrics, METRIC_THINK, think_ns);
+    if (!record_path) return;
+    if (move) {
+        record_events_add(&session->record, kind, seat, move->sourceRow, move->sourceCol,
+                          move->targetRow, move->targetCol, think_ns);
+    } else {
+        record_events_add(&session->record, kind, seat, 0, 0, 0, 0, think_ns);
+    }
+}
+
+static void record_game(GameSession *session, RecordResult result, int scores[SESSION_PLAYERS]) {
+    if (!record_path) return;
+    RecordInfo info = {
+        .game_id = (uint32_t)session->id,
+        .start_ms = session->start_ms,
+        .duration_ms = (uint32_t)((monotonic_ns() - session->start_ns) / 1000000),
+        .base_ms = (uint32_t)(session->time_control.base_ns / 1000000),
+        .increment_ms = (uint32_t)(session->time_control.increment_ns / 1000000),
+        .move_limit_ms = (uint32_t)(session->time_control.move_limit_ns / 1000000),
+        .result = (uint8_t)result,
+        .scores = { (uint8_t)scores[0], (uint8_t)scores[1] },
+        .players = { session->usernames[0], session->usernames[1] }
+    };
+    if (record_log_append(&record_log, &info, &session->record) != 0) {
+        fprintf(stderr, "[Server] [Game %d] Record buffer full, game not recorded\n", session->id);
+    }
+}
+
+void handle_client_disconnect(Client *client) {
     struct sockaddr_in address;
     socklen_t addrlen = sizeof(address);
-    
+
     // 연결 정보 출력
-    if (getpeername(socket_fd, (struct sockaddr*)&address, &addrlen) == 0) {
+    if (getpeername(client->socket, (struct sockaddr*)&address, &addrlen) == 0) {
         printf("연결 종료, IP: %s, 포트: %d\n",
                inet_ntoa(address.sin_addr), ntohs(address.sin_port));
     }
-    
-    // 클라이언트 찾기
-    int disconnected_idx = -1;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket == socket_fd) {
-            disconnected_idx = i;
-            break;
-        }
+
+    if (client->registered) {
+        printf("플레이어 %s 연결 끊김\n", client->username);
     }
-    
-    if (disconnected_idx == -1) return;
-    
-    printf("플레이어 %s 연결 끊김\n", clients[disconnected_idx].username);
-    
-    // ✅ 클라이언트 정리 (공통 처리)
-    close(socket_fd);
-    clients[disconnected_idx].socket = -1;
-    memset(clients[disconnected_idx].username, 0, sizeof(clients[disconnected_idx].username));
-    client_count--;
-    
-    // ✅ 게임 중인 경우 처리
-    if (server_state == SERVER_GAME_IN_PROGRESS) {
-        int other_idx = (disconnected_idx + 1) % MAX_CLIENTS;
-        
-        // ✅ 상대방이 아직 연결되어 있는 경우 (첫 번째 disconnect)
-        if (clients[other_idx].socket != -1) {
-            printf("[Server] Player %s disconnected, continuing game with remaining player\n", 
-                   clients[disconnected_idx].username);
-            
-            // ✅ 상대방에게 opponent_left 메시지만 전송 (게임 종료 아님)
-            JsonValue *opponent_left_msg = createOpponentLeftMessage(clients[disconnected_idx].username);
-            char *left_str = json_stringify(opponent_left_msg);
-            send(clients[other_idx].socket, left_str, strlen(left_str), 0);
-            send(clients[other_idx].socket, "\n", 1, 0);
-            free(left_str);
-            json_free(opponent_left_msg);
-            
-            // ✅ 현재 턴이 연결 끊긴 플레이어였다면 상대방으로 턴 변경
-            if (current_player_idx == disconnected_idx) {
-                printf("[Server] Disconnected player's turn, switching to remaining player\n");
-                current_player_idx = other_idx;
-                send_your_turn(current_player_idx);
-            } else {
-                printf("[Server] Remaining player's turn continues\n");
-            }
-            
-            // ✅ 게임은 계속 진행 (게임 종료 메시지 전송하지 않음)
-            
-        } else {
-            // ✅ 두 번째 disconnect (상대방도 이미 끊김) → 서버 종료
-            printf("[Server] Second player disconnected - both players gone\n");
-            printf("[Server] All players disconnected. Shutting down server...\n");
-            cleanup_and_exit(0);
-        }
-        
-    } else if (server_state == SERVER_WAITING_PLAYERS) {
-        // ✅ 대기 중 disconnect
+
+    GameSession *session = client->session;
+    int seat = client->seat;
+    char left_name[64];
+    strncpy(left_name, client->username, sizeof(left_name));
+
+    // ✅ 로비 대기 중이었다면 대기열에서 제거
+    if (client->in_lobby && lobby_remove(client)) {
         printf("[Server] Player disconnected while waiting for game to start\n");
     }
-    
-    // ✅ 남은 연결된 클라이언트가 있는지 확인
-    int remaining_clients = 0;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket != -1) {
-            remaining_clients++;
-        }
-    }
-    
-    printf("[Server] Remaining connected clients: %d\n", remaining_clients);
-    
-    // ✅ 모든 클라이언트가 disconnect된 경우 → 서버 종료
-    if (remaining_clients == 0) {
-        printf("[Server] All players disconnected. Shutting down server...\n");
-        cleanup_and_exit(0);
-    }
-}
-
-void check_timeout() {
-    if (server_state != SERVER_GAME_IN_PROGRESS) return;
-
-    // ✅ 현재 플레이어가 연결되어 있는지 확인
-    if (clients[current_player_idx].socket == -1) {
-        printf("[Server] Current player is disconnected, switching turn\n");
-        
-        // 다음 플레이어로 변경
-        int next_idx = (current_player_idx + 1) % MAX_CLIENTS;
-        
-        // 다음 플레이어도 연결되어 있는지 확인
-        if (clients[next_idx].socket != -1) {
-            current_player_idx = next_idx;
-            send_your_turn(current_player_idx);
+
+    // ✅ 클라이언트 정리 (공통 처리)
+    release_client(client);
+
+    if (!session) {
+        if (reactor == &spectator_hub) {
+            printf("[Server] Remaining spectators: %d\n", reactor->client_count);
         } else {
-            // 두 플레이어 모두 연결 끊김
-            printf("[Server] All players disconnected during timeout check\n");
-            cleanup_and_exit(0);
+            printf("[Server] Remaining clients in lobby thread: %d (waiting: %d)\n",
+                   reactor->client_count, lobby_size());
         }
         return;
     }
 
-    struct timeval current_time;
-    gettimeofday(&current_time, NULL);
-
-    double elapsed = (current_time.tv_sec - turn_start_time.tv_sec) +
-                     (current_time.tv_usec - turn_start_time.tv_usec) / 1000000.0;
+    // ✅ 게임 중인 경우 처리
+    session->players[seat] = NULL;
+    record_event(session, RECORD_LEFT, seat, NULL);
+    int other = (seat + 1) % SESSION_PLAYERS;
+    Client *other_client = session->players[other];
 
-    if (elapsed > TIMEOUT_SEC) {
-        const char *tname = clients[current_player_idx].username;
-        printf("[Server] %s timed out (%.2f sec). Forcing turn change.\n", tname, elapsed);
-        game_board.consecutivePasses++;
-        
-        // ✅ 연결된 클라이언트들에게만 패스 메시지 전송
-        JsonValue *pass_msg = createPassMessage(clients[current_player_idx].username);
-        char *pass_str = json_stringify(pass_msg);
-        if (clients[current_player_idx].socket != -1) {
-            send(clients[current_player_idx].socket, pass_str, strlen(pass_str), 0);
-            send(clients[current_player_idx].socket, "\n", 1, 0);
-        }
-        free(pass_str); 
-        json_free(pass_msg);
+    if (other_client) {
+        // ✅ 상대방이 아직 연결되어 있는 경우 (첫 번째 disconnect)
+        printf("[Server] [Game %d] Player %s disconnected, continuing game with remaining player\n",
+               session->id, left_name);
 
-        // 게임 종료 확인
-        if (game_board.consecutivePasses >= 2 || hasGameEnded(&game_board)) {
-            broadcast_game_over();
-            return;
-        }
+        // ✅ 상대방에게 opponent_left 메시지만 전송 (게임 종료 아님)
+        send_message(other_client, writeOpponentLeftMessage(&reactor->writer, left_name));
 
-        // ✅ 다음 플레이어로 턴 변경
-        int next_idx = (current_player_idx + 1) % MAX_CLIENTS;
-        
-        // 다음 플레이어가 연결되어 있는지 확인
-        if (clients[next_idx].socket != -1) {
-            current_player_idx = next_idx;
-            send_your_turn(current_player_idx);
+        // ✅ 현재 턴이 연결 끊긴 플레이어였다면 상대방으로 턴 변경
+        if (session->current == seat) {
+            printf("[Server] [Game %d] Disconnected player's turn, switching to remaining player\n",
+                   session->id);
+            session->current = other;
+            send_your_turn(session);
         } else {
-            // 다음 플레이어도 연결 끊김 - 현재 플레이어 턴 유지
-            printf("[Server] Next player also disconnected, keeping current turn\n");
+            printf("[Server] [Game %d] Remaining player's turn continues\n", session->id);
         }
+    } else {
+        // ✅ 두 번째 disconnect (상대방도 이미 끊김) → 세션만 정리, 서버는 계속
+        printf("[Server] [Game %d] Second player disconnected - both players gone. Closing game.\n",
+               session->id);
+        countPieces(&session->board);
+        int scores[SESSION_PLAYERS] = { session->board.redCount, session->board.blueCount };
+        publish_watch_end(session, "abandoned", scores);
+        record_game(session, RECORD_RESULT_ABANDONED, scores);
+        end_session(session);
     }
+
+    printf("[Server] [Shard %d] Remaining clients: %d (games: %d)\n",
+           reactor->id, reactor->client_count, reactor->sessions.count);
+}
+
+// 턴을 다음 플레이어로 넘김. 상대가 나갔으면 남은 플레이어 턴 유지
+static void advance_turn(GameSession *session) {
+    // 수를 두고 넘어가는 경우 (시간 초과는 콜백에서 먼저 멈춤)
+    session_stop_clock(session, monotonic_ns(), 1);
+    int next = (session->current + 1) % SESSION_PLAYERS;
+    if (session->players[next]) {
+        session->current = next;
+    } else {
+        printf("[Server] [Game %d] Next player disconnected, keeping current turn\n", session->id);
+    }
+    send_your_turn(session);
+}
+
+// 턴 마감 타이머 콜백: 시간 초과한 플레이어는 패스 처리
+void on_turn_timeout(void *arg) {
+    GameSession *session = (GameSession*)arg;
+    if (session->state != SESSION_IN_PROGRESS) return;
+    uint64_t now = monotonic_ns();
+    double elapsed = (now - session->turn_start_ns) / 1e9;
+    record_event(session, RECORD_TIMEOUT, session->current, NULL);
+    metrics_count(reactor->metrics, COUNTER_TIMEOUTS);
+    // 시간 초과한 턴에는 증가분을 주지 않음. 남은 시간을 다 쓴 플레이어는 이후 턴이 바로 패스된다
+    session_stop_clock(session, now, 0);
+
+    Client *current = session->players[session->current];
+    const char *tname = session->usernames[session->current];
+    if (session->time_control.base_ns > 0) {
+        printf("[Server] [Game %d] %s timed out (%.2f sec, clock %.2f sec left). Forcing turn change.\n",
+               session->id, tname, elapsed, session->clock_ns[session->current] / 1e9);
+    } else {
+        printf("[Server] [Game %d] %s timed out (%.2f sec). Forcing turn change.\n",
+               session->id, tname, elapsed);
+    }
+    session->board.consecutivePasses++;
+
+    // ✅ 시간 초과한 클라이언트에게 패스 메시지 전송
+    send_message(current, writePassMessage(&reactor->writer, tname));
+    Move pass = { 0 };
+    publish_watch_move(session, session->current, &pass,
+                       session->usernames[(session->current + 1) % SESSION_PLAYERS]);
+
+    // 게임 종료 확인
+    if (session->board.consecutivePasses >= 2 || hasGameEnded(&session->board)) {
+        broadcast_game_over(session);
+        return;
+    }
+
+    // ✅ 다음 플레이어로 턴 변경
+    advance_turn(session);
 }
 // 게임 상태 로그
-void log_game_state(const char *action, int player_idx, Move *move) {
-    printf("[게임 로그] %s - 플레이어: %s", action, 
-           (player_idx >= 0) ? clients[player_idx].username : "시스템");
-    
-    if (move && (move->sourceRow != 0 || move->sourceCol != 0 || 
+void log_game_state(GameSession *session, const char *action, int seat, Move *move) {
+    printf("[게임 로그] [Game %d] %s - 플레이어: %s", session->id, action,
+           (seat >= 0) ? session->usernames[seat] : "시스템");
+
+    if (move && (move->sourceRow != 0 || move->sourceCol != 0 ||
                  move->targetRow != 0 || move->targetCol != 0)) {
-        printf(", 이동: (%d,%d)->(%d,%d)", 
-               move->sourceRow, move->sourceCol, 
+        printf(", 이동: (%d,%d)->(%d,%d)",
+               move->sourceRow, move->sourceCol,
                move->targetRow, move->targetCol);
     }
-    
-    printf(", 보드상태: R=%d B=%d Empty=%d\n", 
-           game_board.redCount, game_board.blueCount, game_board.emptyCount);
+
+    printf(", 보드상태: R=%d B=%d Empty=%d\n",
+           session->board.redCount, session->board.blueCount, session->board.emptyCount);
 }
 
-void handle_register_message(int client_idx, JsonValue *json_obj) {
-    JsonValue *username_json = json_object_get(json_obj, "username");
-    if (!username_json || username_json->type != JSON_STRING) {
+void handle_register_message(Client *client, const DecodedMessage *message) {
+    if (!(message->fields & DECODED_USERNAME)) {
         fprintf(stderr, "유효하지 않은 등록 메시지\n");
         return;
     }
-    const char *username = json_string_value(username_json);
+    const char *username = message->username;
+
+    // 게임 중이거나 이미 로비에 있으면 무시 (게임이 끝난 뒤 다시 register하면 새 대국 대기)
+    if (client->session || client->in_lobby) {
+        printf("[Server] %s is already registered, ignoring register\n", client->username);
+        return;
+    }
 
     // --- ① 중복 등록 체크 ---
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (i != client_idx && clients[i].socket != -1) {
-            if (strcmp(clients[i].username, username) == 0) {
-                // 중복일 때 register_nack 전송 후 연결 종료
-                JsonValue *nack = createRegisterNackMessage("duplicate username");
-                char *nack_str = json_stringify(nack);
-                send(clients[client_idx].socket, nack_str, strlen(nack_str), 0);
-                send(clients[client_idx].socket, "\n", 1, 0);
-                free(nack_str);
-                json_free(nack);
-                close(clients[client_idx].socket);
-                clients[client_idx].socket = -1;
-                client_count--;   // 연결 카운트도 하나 줄여줌
-                printf("[Server] register_nack sent to %s (duplicate)\n", username);
-                return;
-            }
-        }
+    // 이름 맵의 Client는 다른 스레드 소유일 수 있어 username 비교도 락 안에서 한다
+    unregister_name(client);
+    uint64_t name_key = hash_string(username);
+    pthread_mutex_lock(&name_lock);
+    Client *owner = (Client*)hash_map_get(&clients_by_name, name_key);
+    int duplicate = owner && strcmp(owner->username, username) == 0;
+    if (!duplicate) {
+        // --- ② 정상 등록 처리 (게임을 마친 연결이 이름을 바꿔 다시 등록할 수도 있음) ---
+        strncpy(client->username, username, sizeof(client->username) - 1);
+        client->username[sizeof(client->username) - 1] = '\0';
+        client->registered = 1;
+        // 해시 충돌로 다른 이름이 자리를 차지하고 있으면 이름 맵에는 넣지 않는다 (중복 검사만 약해짐)
+        if (!owner) hash_map_put(&clients_by_name, name_key, client);
     }
+    pthread_mutex_unlock(&name_lock);
 
-    // --- ② 정상 등록 처리 ---
-    strncpy(clients[client_idx].username, username, sizeof(clients[client_idx].username) - 1);
-    clients[client_idx].username[sizeof(clients[client_idx].username) - 1] = '\0';
-    printf("[DEBUG] Registered client_idx=%d, username=%s, assigned_color=%c\n",
-       client_idx, clients[client_idx].username, clients[client_idx].color);
+    if (duplicate) {
+        // 중복일 때 register_nack 전송 후 연결 종료
+        send_message(client, writeRegisterNackMessage(&reactor->writer, "duplicate username"));
+        release_client(client);
+        printf("[Server] register_nack sent to %s (duplicate)\n", username);
+        return;
+    }
 
-    // 색상 할당 (0번 클라이언트: RED, 1번 클라이언트: BLUE)
-clients[client_idx].color = (client_idx == 0) ? RED_PLAYER : BLUE_PLAYER;
-printf("[Server] Player registered: %s (color: %c)\n", username, clients[client_idx].color);
+    printf("[Server] Player registered: %s (lobby)\n", username);
 
-    // ACK 메시지 전송
-    JsonValue *ack_msg = createRegisterAckMessage();
-    char *ack_str = json_stringify(ack_msg);
-    send(clients[client_idx].socket, ack_str, strlen(ack_str), 0);
-    send(clients[client_idx].socket, "\n", 1, 0);
-    free(ack_str);
-    json_free(ack_msg);
+    // ACK 메시지 전송 (JSON으로). 둘 다 바이너리를 원하면 그 다음부터 바이너리 프레임.
+    // capabilities가 없는 register(바이너리 register 포함)는 대국 뒤 재등록이므로 협상해 둔 값을 그대로 유지
+    unsigned int accepted;
+    if (message->fields & DECODED_CAPABILITIES) {
+        accepted = message->capabilities & server_capabilities;
+    } else {
+        accepted = (client->binary ? CAPABILITY_BINARY : 0) | (client->delta ? CAPABILITY_DELTA : 0);
+    }
+    send_message(client, writeRegisterAckMessage(&reactor->writer, accepted));
+    client->delta = (accepted & CAPABILITY_DELTA) != 0;
+    if ((accepted & CAPABILITY_BINARY) && !client->binary) {
+        client->binary = 1;
+        framer_set_binary(&client->in);
+        printf("[Server] %s switched to binary framing\n", username);
+    }
 
-    // --- ③ 두 플레이어가 모두 등록되면 게임 시작 ---
-    if (client_count == MAX_CLIENTS &&
-        strlen(clients[0].username) > 0 && strlen(clients[1].username) > 0) {
-        broadcast_game_start();
+    // --- ③ 로비 대기열에 넣고 두 명씩 매칭 ---
+    if (lobby_add(client) != 0) {
+        fprintf(stderr, "[Server] Lobby full, dropping %s\n", username);
+        release_client(client);
+        return;
     }
+    client->in_lobby = 1;
+    match_lobby_players();
 }
-void handle_move_message(int client_idx, JsonValue *json_obj) {
-    if (server_state != SERVER_GAME_IN_PROGRESS) {
-        printf("[Server] Received move but game not in progress.\n");
+
+// 관전 신청: 등록하지 않은 연결만 받음. spectate_ack 후 관전 리액터로 넘어가고, 이후 보내는 메시지는 무시
+void handle_spectate_message(Client *client, const DecodedMessage *message) {
+    if (client->registered || client->session || client->in_lobby || client->spectator) {
+        printf("[Server] %s is a player, ignoring spectate\n", client->username);
         return;
     }
-    // ✅ 연결이 끊긴 클라이언트인지 확인
-    if (clients[client_idx].socket == -1) {
-        printf("[Server] Received move from disconnected client, ignoring.\n");
+
+    client->watch_count = 0;
+    if (message->fields & DECODED_GAMES) {
+        for (int i = 0; i < message->game_count; i++) {
+            int duplicate = 0;
+            for (int j = 0; j < client->watch_count; j++) duplicate |= (client->watch_games[j] == message->games[i]);
+            if (!duplicate) client->watch_games[client->watch_count++] = message->games[i];
+        }
+    }
+    client->spectator = 1;
+    snprintf(client->username, sizeof(client->username), "spectator#%d", client->socket);
+    // 관전 리액터에 붙기 전부터 샤드가 프레임을 만들도록 여기서 셈
+    __atomic_add_fetch(&spectator_count, 1, __ATOMIC_RELAXED);
+    metrics_gauge(reactor->metrics, GAUGE_SPECTATORS, 1);
+
+    send_message(client, writeSpectateAckMessage(&reactor->writer, client->watch_games, client->watch_count));
+    hand_off_spectator(client);
+    printf("[Server] %s joined (%d games selected)\n", client->username, client->watch_count);
+}
+
+// 로비에서 먼저 온 순서대로 두 명씩 꺼내 새 세션을 만들고, 루프 끝에 게임 샤드로 넘김
+void match_lobby_players() {
+    Client *first, *second;
+    while (lobby_pop_pair(&first, &second)) {
+        first->in_lobby = 0;
+        second->in_lobby = 0;
+        GameSession *session = session_create(first, first->username, second, second->username,
+                                              &time_control);
+        if (!session) {
+            fprintf(stderr, "[Server] Failed to create game session\n");
+            release_client(first);
+            release_client(second);
+            return;
+        }
+        for (int i = 0; i < SESSION_PLAYERS; i++) {
+            Client *player = session->players[i];
+            player->session = session;
+            player->seat = i;
+            player->color = session_color(i);
+            player->board_synced = 0;
+            player->handoff = 1;
+        }
+        metrics_count(reactor->metrics, COUNTER_GAMES_STARTED);
+        metrics_gauge(reactor->metrics, GAUGE_GAMES, 1);
+        session->next = reactor->outgoing_sessions;
+        reactor->outgoing_sessions = session;
+    }
+}
+
+// 델타 모드 연결에 이번 메시지로 보낼 보드 정보 (델타 모드가 아니면 NULL: 보드 전체).
+// 연결마다 마지막으로 보낸 seq를 기억해 직전 수 하나만 모자라면 그 수만, 같으면 seq/hash만 보낸다
+static const BoardDelta* board_delta_for(Client *client, GameSession *session, BoardDelta *delta, int snapshot) {
+    if (!client->delta) return NULL;
+    delta->seq = session->board_seq;
+    delta->hash = board_hash(&session->board);
+    if (snapshot || !client->board_synced || client->deltas_since_snapshot >= DELTA_SNAPSHOT_INTERVAL ||
+        (client->board_seq != session->board_seq && client->board_seq + 1 != session->board_seq)) {
+        delta->kind = BOARD_UPDATE_SNAPSHOT;
+        client->deltas_since_snapshot = 0;
+    } else if (client->board_seq == session->board_seq) {
+        delta->kind = BOARD_UPDATE_SAME;
+    } else {
+        delta->kind = BOARD_UPDATE_MOVE;
+        delta->move = session->last_move;
+        delta->flipped = session->last_flipped;
+        client->deltas_since_snapshot++;
+    }
+    client->board_synced = 1;
+    client->board_seq = session->board_seq;
+    return delta;
+}
+
+// invalid_move 응답 (턴은 바꾸지 않음). 보드가 어긋났을 수 있으므로 델타 모드여도 스냅샷
+static void reply_invalid_move(GameSession *session, Client *client, const char *next_player) {
+    BoardDelta delta;
+    metrics_count(reactor->metrics, COUNTER_INVALID_MOVES);
+    send_message(client, writeInvalidMoveMessage(&reactor->writer, &session->board,
+                                                 board_delta_for(client, session, &delta, 1), next_player));
+}
+
+void handle_move_message(Client *client, const DecodedMessage *message) {
+    GameSession *session = client->session;
+    if (!session || session->state != SESSION_IN_PROGRESS) {
+        printf("[Server] Received move but game not in progress.\n");
         return;
     }
     // 현재 차례 아닌 플레이어가 보냈으면 invalid_move
-    if (client_idx != current_player_idx) {
-        printf("[Server] %s tried to move out of turn.\n", clients[client_idx].username);
-        JsonValue *inv = createInvalidMoveMessage(&game_board, clients[current_player_idx].username);
-        char *inv_str = json_stringify(inv);
-        send(clients[client_idx].socket, inv_str, strlen(inv_str), 0);
-        send(clients[client_idx].socket, "\n", 1, 0);
-        free(inv_str); json_free(inv);
+    if (client->seat != session->current) {
+        printf("[Server] [Game %d] %s tried to move out of turn.\n", session->id, client->username);
+        reply_invalid_move(session, client, session->usernames[session->current]);
         return;
     }
 
-    char *username = NULL;
-   
-    if (!parseMoveMessage(json_obj, &username, &move)) {
-        printf("[Server] Failed to parse move JSON from %s.\n", clients[client_idx].username);
-        JsonValue *inv = createInvalidMoveMessage(&game_board, clients[current_player_idx].username);
-        char *inv_str = json_stringify(inv);
-        send(clients[client_idx].socket, inv_str, strlen(inv_str), 0);
-        send(clients[client_idx].socket, "\n", 1, 0);
-        free(inv_str); json_free(inv);
+    // 바이너리 move에는 username이 없다 (연결로 식별)
+    unsigned int required = client->binary ? DECODED_MOVE : (DECODED_USERNAME | DECODED_MOVE);
+    if ((message->fields & required) != required) {
+        printf("[Server] [Game %d] Failed to parse move JSON from %s.\n", session->id, client->username);
+        reply_invalid_move(session, client, session->usernames[session->current]);
         return;
     }
+    Move move = message->move;
+    move.player = client->color;
 
     // ✅ 원본 좌표 보존 (로깅용)
     Move original_move = move;
-    
-    printf("[Server] Move received from %s: (%d,%d)->(%d,%d)\n",
-           clients[client_idx].username,
+
+    printf("[Server] [Game %d] Move received from %s: (%d,%d)->(%d,%d)\n",
+           session->id, client->username,
            original_move.sourceRow, original_move.sourceCol,
            original_move.targetRow, original_move.targetCol);
 
     // --- 패스(0,0,0,0) 검사 ---
     if (move.sourceRow == 0 && move.sourceCol == 0 &&
         move.targetRow == 0 && move.targetCol == 0) {
-        
-        if (hasValidMove(&game_board, move.player)) {
-            printf("[Server] %s sent pass but valid moves remain → invalid_move\n",
-                   clients[client_idx].username);
-            JsonValue *inv = createInvalidMoveMessage(&game_board, clients[current_player_idx].username);
-            char *inv_str = json_stringify(inv);
-            send(clients[client_idx].socket, inv_str, strlen(inv_str), 0);
-            send(clients[client_idx].socket, "\n", 1, 0);
-            free(inv_str); json_free(inv);
-            free(username);
+
+        uint64_t validate_start = metrics_start();
+        int can_move = hasValidMove(&session->board, move.player);
+        metrics_finish(reactor->metrics, METRIC_VALIDATE, validate_start);
+        if (can_move) {
+            printf("[Server] [Game %d] %s sent pass but valid moves remain → invalid_move\n",
+                   session->id, client->username);
+            reply_invalid_move(session, client, session->usernames[session->current]);
             return;
         }
-        
+
         // ✅ 진짜 패스 처리
-        printf("[Server] %s passes (no moves left).\n", clients[client_idx].username);
-        game_board.consecutivePasses++;
-
-        JsonValue *pass_msg = createPassMessage(clients[current_player_idx].username);
-        char *pass_str = json_stringify(pass_msg);
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            if (clients[i].socket != -1) {
-                send(clients[i].socket, pass_str, strlen(pass_str), 0);
-                send(clients[i].socket, "\n", 1, 0);
-            }
-        }
-        free(pass_str); json_free(pass_msg);
+        printf("[Server] [Game %d] %s passes (no moves left).\n", session->id, client->username);
+        session->board.consecutivePasses++;
+        log_game_state(session, "패스", client->seat, NULL);
+        record_event(session, RECORD_PASS, client->seat, NULL);
+
+        broadcast_message(session, writePassMessage(&reactor->writer, client->username));
+        publish_watch_move(session, client->seat, &original_move,
+                           session->usernames[(client->seat + 1) % SESSION_PLAYERS]);
 
-        if (game_board.consecutivePasses >= 2 || hasGameEnded(&game_board)) {
-            broadcast_game_over();
+        if (session->board.consecutivePasses >= 2 || hasGameEnded(&session->board)) {
+            broadcast_game_over(session);
         } else {
-            current_player_idx = (current_player_idx + 1) % MAX_CLIENTS;
-            send_your_turn(current_player_idx);
+            advance_turn(session);
         }
 
-        free(username);
         return;
     }
 
@@ -502,291 +1294,500 @@ void handle_move_message(int client_idx, JsonValue *json_obj) {
         .targetCol = move.targetCol - 1
     };
 
-      if (!isValidMove(&game_board, &adjusted_move)) {
-        printf("[Server] Invalid move by %s: (%d,%d)->(%d,%d) [internal: (%d,%d)->(%d,%d)]\n",
-               clients[client_idx].username,
+    uint64_t validate_start = metrics_start();
+    int valid = isValidMove(&session->board, &adjusted_move);
+    metrics_finish(reactor->metrics, METRIC_VALIDATE, validate_start);
+    if (!valid) {
+        printf("[Server] [Game %d] Invalid move by %s: (%d,%d)->(%d,%d) [internal: (%d,%d)->(%d,%d)]\n",
+               session->id, client->username,
                original_move.sourceRow, original_move.sourceCol,
                original_move.targetRow, original_move.targetCol,
                adjusted_move.sourceRow, adjusted_move.sourceCol,
                adjusted_move.targetRow, adjusted_move.targetCol);
 
         // ✅ 수정: invalid_move 후 턴을 다음 플레이어로 넘김
-        int next_idx = (current_player_idx + 1) % MAX_CLIENTS;
-        
-        JsonValue *inv = createInvalidMoveMessage(&game_board, clients[next_idx].username);
-        char *inv_str = json_stringify(inv);
-        send(clients[client_idx].socket, inv_str, strlen(inv_str), 0);
-        send(clients[client_idx].socket, "\n", 1, 0);
-        free(inv_str); json_free(inv);
-
-        // ✅ 실제로 턴을 다음 플레이어로 변경
-        current_player_idx = next_idx;
-        send_your_turn(current_player_idx);
-
-        free(username);
+        record_event(session, RECORD_INVALID, client->seat, &original_move);
+        int next = (session->current + 1) % SESSION_PLAYERS;
+        reply_invalid_move(session, client, session->usernames[next]);
+        advance_turn(session);
+
         return;
     }
 
-    // --- ✅ 합법적 이동 처리 --- 
-    printf("[Server] Valid move by %s: (%d,%d)->(%d,%d). Applying...\n",
-           clients[client_idx].username,
+    // --- ✅ 합법적 이동 처리 ---
+    printf("[Server] [Game %d] Valid move by %s: (%d,%d)->(%d,%d). Applying...\n",
+           session->id, client->username,
            original_move.sourceRow, original_move.sourceCol,
            original_move.targetRow, original_move.targetCol);
 
-    // 보드에 이동 적용
-    applyMove(&game_board, &adjusted_move);
-    game_board.consecutivePasses = 0;  // 패스 카운트 리셋
-    
-    printf("[Server] Move applied successfully. New board state:\n");
-    printBoard(&game_board);
-    printf("[Server] Score: R=%d, B=%d, Empty=%d\n", 
-           game_board.redCount, game_board.blueCount, game_board.emptyCount);
+    // 보드에 이동 적용 (델타 모드 연결에 보낼 수와 뒤집힌 칸도 기록)
+    GameBoard before = session->board;
+    applyMove(&session->board, &adjusted_move);
+    session->board_seq++;
+    session->last_move = original_move;
+    session->last_flipped = board_flipped(&before, &session->board, adjusted_move.player);
+    session->board.consecutivePasses = 0;  // 패스 카운트 리셋
+    log_game_state(session, "이동", client->seat, &original_move);
+    record_event(session, RECORD_MOVE, client->seat, &original_move);
 
     // ✅ 다음 플레이어 결정
-    int next_idx = (current_player_idx + 1) % MAX_CLIENTS;
-    
+    int next = (session->current + 1) % SESSION_PLAYERS;
+
     // ✅ 게임 종료 확인
-    bool game_ended = hasGameEnded(&game_board);
-    
+    bool game_ended = hasGameEnded(&session->board);
+    publish_watch_move(session, client->seat, &original_move, game_ended ? NULL : session->usernames[next]);
+
     if (game_ended) {
-        printf("[Server] Game ended after move. Broadcasting game_over...\n");
-        
+        printf("[Server] [Game %d] Game ended after move. Broadcasting game_over...\n", session->id);
+
         // ✅ 게임 종료 시에는 next_player를 null로 설정한 move_ok 전송
-        JsonValue *ok = createMoveOkMessage(&game_board, NULL);  // next_player = null
-        char *ok_str = json_stringify(ok);
-        if (clients[current_player_idx].socket != -1) {
-            send(clients[current_player_idx].socket, ok_str, strlen(ok_str), 0);
-            send(clients[current_player_idx].socket, "\n", 1, 0);
-        }
-        free(ok_str); json_free(ok);
-        
-        printf("[Server] move_ok sent (game ended). Broadcasting game_over...\n");
-        broadcast_game_over();
+        BoardDelta delta;
+        send_message(client, writeMoveOkMessage(&reactor->writer, &session->board,
+                                                board_delta_for(client, session, &delta, 0), NULL));  // next_player = null
+        broadcast_game_over(session);
     } else {
         // ✅ 게임 계속: move_ok의 next_player와 실제 턴 변경이 일치하도록 수정
-        JsonValue *ok = createMoveOkMessage(&game_board, clients[next_idx].username);
-        char *ok_str = json_stringify(ok);
-        if (clients[current_player_idx].socket != -1) {
-            send(clients[current_player_idx].socket, ok_str, strlen(ok_str), 0);
-            send(clients[current_player_idx].socket, "\n", 1, 0);
-        }
-        free(ok_str); json_free(ok);
-
-        printf("[Server] move_ok sent with next_player: %s\n", clients[next_idx].username);
-
-        // ✅ 실제 턴을 다음 플레이어로 변경
-        current_player_idx = next_idx;
-        send_your_turn(current_player_idx);
-        
-        printf("[Server] Turn switched to: %s (index: %d)\n", 
-               clients[current_player_idx].username, current_player_idx);
+        BoardDelta delta;
+        send_message(client, writeMoveOkMessage(&reactor->writer, &session->board,
+                                                board_delta_for(client, session, &delta, 0), session->usernames[next]));
+        advance_turn(session);
     }
 
-    free(username);
 }
-void broadcast_game_start() {
-    server_state = SERVER_GAME_IN_PROGRESS;
-
-    // --- 보드 초기화 (한 번만) ---
-    initializeBoard(&game_board);
-
-    // 클라이언트 이름을 배열로 추출
-    const char *usernames[MAX_CLIENTS];
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        usernames[i] = clients[i].username;
-    }
-
+void broadcast_game_start(GameSession *session) {
     // game_start 메시지 생성
-    JsonValue *start_msg = createGameStartMessage(usernames, clients[0].username);
-    char *start_str = json_stringify(start_msg);
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket != -1) {
-            send(clients[i].socket, start_str, strlen(start_str), 0);
-            send(clients[i].socket, "\n", 1, 0);
-        }
-    }
-    free(start_str);
-    json_free(start_msg);
-
-    printf("[Server] game_start sent: players=[%s,%s], first_player=%s\n",
-           clients[0].username, clients[1].username, clients[0].username);
+    const char *usernames[SESSION_PLAYERS] = { session->usernames[0], session->usernames[1] };
+    broadcast_message(session, writeGameStartMessage(&reactor->writer, usernames, session->usernames[0]));
+    publish_watch_start(session);
 
-    // 첫 번째 플레이어 턴 설정
-    current_player_idx = 0;
+    printf("[Server] [Game %d] game_start sent: players=[%s,%s], first_player=%s (shard %d, games: %d)\n",
+           session->id, session->usernames[0], session->usernames[1], session->usernames[0],
+           reactor->id, reactor->sessions.count);
 
-    // ==========================
-    // ★ 신규 추가 부분: 게임 시작 시,
-    //   글로벌 move.player 에 첫 번째 플레이어 색상(R 또는 B) 할당
-    move.player = clients[current_player_idx].color;
-    // (선택) 초기 좌표를 0으로 리셋해 두고 싶으면 아래처럼 해도 됩니다.
-    move.sourceRow = move.sourceCol = 0;
-    move.targetRow = move.targetCol = 0;
-    // ==========================
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    session->start_ms = (uint64_t)wall.tv_sec * 1000 + (uint64_t)wall.tv_nsec / 1000000;
+    session->start_ns = monotonic_ns();
 
     // 첫 번째 플레이어에게 턴 알림
-    send_your_turn(current_player_idx);
+    session->current = 0;
+    send_your_turn(session);
 }
 
 // 턴 시작 메시지 전송
-void send_your_turn(int client_idx) {
-    if (client_idx < 0 || client_idx >= MAX_CLIENTS || clients[client_idx].socket == -1) {
-        return;
-    }
+void send_your_turn(GameSession *session) {
+    Client *client = session->players[session->current];
 
-    // ==========================
-    // ★ 신규 추가 부분: 매 턴마다 현재 턴 플레이어 색상을 move.player 에 다시 할당
-    move.player = clients[client_idx].color;
-    // (필요하다면) 이전 move 좌표를 초기화하거나, 직전에 적용된 색상의 좌표를 남길 수도 있습니다.
-    // ==========================
+    // 턴 타이머 시작 (나간 플레이어 차례여도 타임아웃으로 넘어가도록)
+    uint64_t deadline = session_start_clock(session, monotonic_ns());
+    timer_schedule(&reactor->timers, &session->turn_timer, deadline);
+    if (!client) return;
 
-    // 'your_turn' 메시지 생성 시 현재 보드 상태와 타임아웃을 함께 보내줌
-    JsonValue *turn_msg = createYourTurnMessage(&game_board, TIMEOUT_SEC);
-    char *turn_str = json_stringify(turn_msg);
-    send(clients[client_idx].socket, turn_str, strlen(turn_str), 0);
-    send(clients[client_idx].socket, "\n", 1, 0);
-    free(turn_str);
-    json_free(turn_msg);
-
-    // 턴 타이머 시작
-    gettimeofday(&turn_start_time, NULL);
-    printf("[Server] your_turn sent to %s (timeout=%.1f)\n",
-           clients[client_idx].username, TIMEOUT_SEC);
+    // 'your_turn' 메시지 생성 시 현재 보드 상태와 이번 턴에 쓸 수 있는 시간을 함께 보내줌
+    BoardDelta delta;
+    send_message(client, writeYourTurnMessage(&reactor->writer, &session->board,
+                                              board_delta_for(client, session, &delta, 0),
+                                              session_turn_budget(session) / 1e9));
 }
-void broadcast_game_over() {
-    server_state = SERVER_GAME_OVER;
+void broadcast_game_over(GameSession *session) {
+    session->state = SESSION_OVER;
+
+    countPieces(&session->board);
 
-    countPieces(&game_board);
-    
     // ✅ 수정: 직접 계산으로 검증
     int manual_red = 0, manual_blue = 0, manual_empty = 0;
     for (int i = 0; i < BOARD_SIZE; i++) {
         for (int j = 0; j < BOARD_SIZE; j++) {
-            char cell = game_board.cells[i][j];
+            char cell = session->board.cells[i][j];
             if (cell == RED_PLAYER) manual_red++;
             else if (cell == BLUE_PLAYER) manual_blue++;
             else if (cell == EMPTY_CELL) manual_empty++;
         }
     }
-    
-    printf("[DEBUG] countPieces result: R=%d, B=%d, Empty=%d\n", 
-           game_board.redCount, game_board.blueCount, game_board.emptyCount);
-    printf("[DEBUG] Manual count: R=%d, B=%d, Empty=%d, Total=%d\n", 
-           manual_red, manual_blue, manual_empty, manual_red + manual_blue + manual_empty);
 
-    const char *players[2] = {clients[0].username, clients[1].username};
-    int scores[2];
-    
+    const char *players[SESSION_PLAYERS] = { session->usernames[0], session->usernames[1] };
+    int scores[SESSION_PLAYERS];
+
     // 검증 후 올바른 값 사용
     if (manual_red + manual_blue + manual_empty == 64) {
         scores[0] = manual_red;
         scores[1] = manual_blue;
-        printf("[Server] Using manual count (Total=64 ✓)\n");
     } else {
-        scores[0] = game_board.redCount;
-        scores[1] = game_board.blueCount;
-        printf("[Server] Using countPieces result (Manual total=%d)\n", 
-               manual_red + manual_blue + manual_empty);
+        scores[0] = session->board.redCount;
+        scores[1] = session->board.blueCount;
+        printf("[Server] [Game %d] Using countPieces result (Manual total=%d)\n",
+               session->id, manual_red + manual_blue + manual_empty);
     }
 
-    JsonValue *game_over_msg = createGameOverMessage(players, scores);
-    char *json_str = json_stringify(game_over_msg);
-    
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket != -1) {
-            send(clients[i].socket, json_str, strlen(json_str), 0);
-            send(clients[i].socket, "\n", 1, 0);
-        }
-    }
-    free(json_str); 
-    json_free(game_over_msg);
+    broadcast_message(session, writeGameOverMessage(&reactor->writer, players, scores));
+    publish_watch_end(session, "game_over", scores);
+    record_game(session, RECORD_RESULT_GAME_OVER, scores);
 
     if (scores[0] > scores[1]) {
-        printf("[Server] Game over: %s wins! (R=%d, B=%d)\n",
-               clients[0].username, scores[0], scores[1]);
+        printf("[Server] [Game %d] Game over: %s wins! (R=%d, B=%d)\n",
+               session->id, players[0], scores[0], scores[1]);
     } else if (scores[1] > scores[0]) {
-        printf("[Server] Game over: %s wins! (R=%d, B=%d)\n",
-               clients[1].username, scores[0], scores[1]);
+        printf("[Server] [Game %d] Game over: %s wins! (R=%d, B=%d)\n",
+               session->id, players[1], scores[0], scores[1]);
     } else {
-        printf("[Server] Game over: Draw! (R=%d, B=%d)\n",
-               scores[0], scores[1]);
+        printf("[Server] [Game %d] Game over: Draw! (R=%d, B=%d)\n",
+               session->id, scores[0], scores[1]);
+    }
+
+    // ✅ 연결은 유지하고 세션만 정리. 남은 연결은 로비로 돌아가 다시 register를 기다림
+    for (int i = 0; i < SESSION_PLAYERS; i++) {
+        Client *player = session->players[i];
+        if (!player) continue;
+        player->session = NULL;
+        return_to_lobby(player);
     }
-    
-    printf("[Server] Game ended normally. Waiting for final messages...\n");
-    sleep(2);  // 클라이언트가 메시지를 받을 시간
-    
-    // ✅ 게임 종료 후 서버도 종료하도록 복원
-    printf("[Server] Game completed. Shutting down server...\n");
-    cleanup_and_exit(0);
+    end_session(session);
+    printf("[Server] [Shard %d] Active games: %d\n", reactor->id, reactor->sessions.count);
 }
 // 클라이언트 메시지 처리
-void handle_client_message(int client_idx, char *buffer) {
-    printf("클라이언트 %d로부터 메시지: %s\n", client_idx, buffer);
-    
-    JsonValue *json_obj = json_parse(buffer);
-    if (!json_obj) {
-        fprintf(stderr, "유효하지 않은 JSON 메시지: %s\n", buffer);
-        return;
+void handle_client_message(Client *client, char *buffer, size_t len) {
+    // ✅ 고정 형식 메시지는 트리 없이 한 번에 디코드. 이스케이프 등 빠른 경로가 못 다루는 입력만
+    //    JSON 트리로 파싱하며, 트리는 리액터 아레나에 만들고 처리가 끝나면 통째로 리셋
+    DecodedMessage message;
+    JsonArena *previous_arena = NULL;
+    int used_tree = 0;
+    // 관전 연결이 보내는 메시지는 읽기만 하고 버림
+    if (client->spectator) return;
+    MetricsShard *metrics = reactor->metrics;
+    uint64_t start = metrics_start();
+    if (client->binary) {
+        // ✅ 바이너리 연결은 프레임을 바로 디코드 (폴백 없음)
+        if (!decodeBinaryMessage(buffer, len, &message)) {
+            fprintf(stderr, "유효하지 않은 바이너리 메시지 (%s, %zu bytes)\n", client->username, len);
+            metrics_count(metrics, COUNTER_PARSE_ERRORS);
+            return;
+        }
+    } else if (!decodeMessage(buffer, &message)) {
+        previous_arena = json_use_arena(&reactor->json_arena);
+        used_tree = 1;
+        JsonValue *json_obj = json_parse(buffer);
+        if (!json_obj) {
+            fprintf(stderr, "유효하지 않은 JSON 메시지: %s\n", buffer);
+            metrics_count(metrics, COUNTER_PARSE_ERRORS);
+            json_use_arena(previous_arena);
+            json_arena_reset(&reactor->json_arena);
+            return;
+        }
+        decodeMessageTree(json_obj, &message);
     }
-    
-    MessageType msg_type = parseMessageType(json_obj);
-    
-    switch (msg_type) {
+    metrics_finish(metrics, METRIC_PARSE, start);
+    metrics_message(metrics, message.type);
+
+    switch (message.type) {
         case MSG_REGISTER:
-            handle_register_message(client_idx, json_obj);
+            handle_register_message(client, &message);
             break;
-            
+
         case MSG_MOVE:
-            handle_move_message(client_idx, json_obj);
+            if (!client->registered) {
+                fprintf(stderr, "등록되지 않은 클라이언트의 이동 메시지\n");
+                break;
+            }
+            handle_move_message(client, &message);
+            break;
+
+        case MSG_SPECTATE:
+            handle_spectate_message(client, &message);
             break;
-            
+
         default:
             fprintf(stderr, "알 수 없는 메시지 유형\n");
             break;
     }
-    
-    json_free(json_obj);
-   
+
+    if (used_tree) {
+        json_use_arena(previous_arena);
+        json_arena_reset(&reactor->json_arena);
+    }
+    // 처리 중 연결이 다른 리액터로 넘어가도 지금 스레드의 샤드에 쌓음
+    metrics_finish(metrics, METRIC_HANDLE, start);
+}
+
+// timerfd를 가장 가까운 턴 마감에 맞춤 (없으면 해제)
+static void arm_timer_fd() {
+    uint64_t deadline = timer_next_deadline(&reactor->timers);
+    if (deadline == reactor->armed_deadline) return;
+    reactor->armed_deadline = deadline;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = deadline / 1000000000ULL;
+    spec.it_value.tv_nsec = deadline % 1000000000ULL;
+    timerfd_settime(reactor->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+// 새 연결을 EAGAIN이 날 때까지 모두 받음 (edge-triggered, 로비 리액터)
+static void accept_clients(int server_fd) {
+    for (;;) {
+        struct sockaddr_in address;
+        socklen_t addrlen = sizeof(address);
+        int new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen);
+        if (new_socket < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept");
+            return;
+        }
+
+        // 비차단 모드로 설정
+        set_socket_nonblocking(new_socket);
+
+        printf("새 연결, 소켓 fd: %d, IP: %s, 포트: %d\n",
+               new_socket, inet_ntoa(address.sin_addr), ntohs(address.sin_port));
+
+        Client *client = (Client*)calloc(1, sizeof(Client));
+        if (!client) {
+            // 추가 연결 거부
+            close(new_socket);
+            printf("연결 자원 부족. 연결 거부.\n");
+            continue;
+        }
+        if (framer_init(&client->in, max_frame) != 0) {
+            free(client);
+            close(new_socket);
+            printf("연결 자원 부족. 연결 거부.\n");
+            continue;
+        }
+        client->socket = new_socket;
+        timer_init(&client->write_timer, on_write_timeout, client);
+        metrics_count(reactor->metrics, COUNTER_CONNECTIONS);
+        metrics_gauge(reactor->metrics, GAUGE_CONNECTIONS, 1);
+        attach_client(client);
+    }
+}
+
+// 읽을 수 있는 데이터를 모두 읽어 처리 (edge-triggered이므로 EAGAIN까지)
+static void read_client(Client *client) {
+    // 인계 중인 연결은 새 리액터가 epoll에 붙일 때 다시 알림을 받는다
+    while (!client->handoff) {
+        // 보낼 것이 너무 쌓였으면 요청을 더 받지 않음 (flush_client가 비운 뒤 다시 읽음)
+        if (output_buffer_pending(&client->out) > OUTPUT_HIGH_WATER) {
+            client->read_paused = 1;
+            return;
+        }
+        // 링의 빈 공간에 바로 받음. 완성된 줄은 매번 모두 꺼내므로 남는 건 max_frame 이하라 공간은 항상 있다
+        size_t space;
+        char *dst = framer_write_space(&client->in, &space);
+        ssize_t valread = read(client->socket, dst, space);
+        if (valread > 0) {
+            framer_commit(&client->in, (size_t)valread);
+            process_client_frames(client);
+            if (client->socket == -1) return;
+            continue;
+        }
+        if (valread < 0 && errno == EINTR) continue;
+        if (valread < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+        // 연결 종료 또는 오류
+        handle_client_disconnect(client);
+        return;
+    }
+}
+
+// 메일박스 수신: 샤드는 새 세션을, 로비는 게임을 마친 연결을, 관전 리액터는 관전자와 관전 프레임을 받는다
+static void receive_mailbox() {
+    uint64_t count;
+    while (read(reactor->wake_fd, &count, sizeof(count)) > 0) {}
+
+    pthread_mutex_lock(&reactor->mailbox_lock);
+    GameSession *sessions = reactor->inbox_sessions;
+    Client *clients = reactor->inbox_clients;
+    SharedFrame *frames = reactor->inbox_frames;
+    reactor->inbox_sessions = NULL;
+    reactor->inbox_clients = NULL;
+    reactor->inbox_frames = NULL;
+    reactor->inbox_frames_tail = NULL;
+    pthread_mutex_unlock(&reactor->mailbox_lock);
+
+    while (sessions) {
+        GameSession *session = sessions;
+        sessions = session->next;
+        session_table_add(&reactor->sessions, session);
+        session->turn_timer.callback = on_turn_timeout;
+        for (int i = 0; i < SESSION_PLAYERS; i++) {
+            if (attach_client(session->players[i]) != 0) session->players[i] = NULL;
+        }
+        broadcast_game_start(session);
+        // 인계 전에 이미 받아 둔 메시지가 있으면 처리
+        for (int i = 0; i < SESSION_PLAYERS; i++) {
+            Client *player = session->players[i];
+            if (player && framer_pending(&player->in) > 0) process_client_frames(player);
+        }
+    }
+
+    while (clients) {
+        Client *client = clients;
+        clients = client->next_handoff;
+        if (attach_client(client) != 0) continue;
+        if (client->spectator) {
+            watch_games(client);
+        } else if (framer_pending(&client->in) > 0) {
+            process_client_frames(client);
+        }
+    }
+
+    // 관전 리액터: 새 관전자를 붙인 뒤 프레임을 보내야 늦게 온 관전자도 순서가 맞음
+    while (frames) {
+        SharedFrame *frame = frames;
+        frames = frame->next;
+        frame->next = NULL;
+        receive_frame(frame);
+    }
+}
+
+static int reactor_init(Reactor *target, int id, int listen_fd) {
+    memset(target, 0, sizeof(Reactor));
+    target->id = id;
+    target->listen_fd = listen_fd;
+    target->metrics = metrics_shard(id);
+    target->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    target->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    target->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (target->epoll_fd < 0 || target->timer_fd < 0 || target->wake_fd < 0) {
+        perror("epoll/timerfd/eventfd");
+        return -1;
+    }
+    if (hash_map_init(&target->clients_by_fd, 1024) != 0) return -1;
+    timer_queue_init(&target->timers);
+    session_table_init(&target->sessions);
+    json_arena_init(&target->json_arena, JSON_ARENA_CHUNK_SIZE);
+    pthread_mutex_init(&target->mailbox_lock, NULL);
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = target->timer_fd;
+    epoll_ctl(target->epoll_fd, EPOLL_CTL_ADD, target->timer_fd, &ev);
+    ev.data.fd = target->wake_fd;
+    epoll_ctl(target->epoll_fd, EPOLL_CTL_ADD, target->wake_fd, &ev);
+    if (listen_fd >= 0) {
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = listen_fd;
+        epoll_ctl(target->epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    }
+    return 0;
+}
+
+// 리액터 이벤트 루프 (로비는 메인 스레드, 샤드는 각자 스레드에서 실행)
+static void *reactor_main(void *arg) {
+    reactor = (Reactor*)arg;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (!__atomic_load_n(&reactor->stop, __ATOMIC_ACQUIRE)) {
+        int n = epoll_wait(reactor->epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno != EINTR) perror("epoll_wait");
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == reactor->listen_fd) {
+                // 새 연결 확인
+                accept_clients(fd);
+            } else if (fd == reactor->timer_fd) {
+                // 턴 마감 도달: 만료된 세션들 타임아웃 처리
+                uint64_t expirations;
+                while (read(reactor->timer_fd, &expirations, sizeof(expirations)) > 0) {}
+                timer_run_expired(&reactor->timers, monotonic_ns());
+            } else if (fd == reactor->wake_fd) {
+                receive_mailbox();
+            } else if (fd == signal_fd) {
+                // 종료 시그널: 이번 루프를 마치고 나가면 main이 나머지를 정리
+                struct signalfd_siginfo info;
+                while (read(signal_fd, &info, sizeof(info)) > 0) {}
+                reactor->stop = 1;
+            } else {
+                // 클라이언트 메시지 확인 (이미 닫힌 fd의 남은 이벤트는 무시)
+                Client *client = (Client*)hash_map_get(&reactor->clients_by_fd, (uint64_t)fd);
+                if (!client) continue;
+                if (events[i].events & EPOLLOUT) flush_client(client);
+                if (client->socket != -1 && (events[i].events & ~EPOLLOUT)) read_client(client);
+            }
+        }
+
+        // 보내기 → 해제 → 인계 순서 (인계 전에 보낼 수 있는 것은 이 리액터에서 보냄)
+        flush_dirty_clients();
+        free_closed_clients();
+        flush_handoffs();
+        arm_timer_fd();
+    }
+
+    return NULL;
 }
 
 int main(int argc __attribute__((unused)), char *argv[] __attribute__((unused))) {
-    int server_fd, new_socket;
+    int server_fd;
     struct sockaddr_in address;
-    int addrlen = sizeof(address);
-    
+
     // 명령줄 인자 파싱
     if (parse_arguments(argc, argv) != 0) {
         return EXIT_FAILURE;
     }
-    
-    // 시그널 핸들러 설정
-    signal(SIGINT, cleanup_and_exit);
-    signal(SIGTERM, cleanup_and_exit);
-    
+    if (shard_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        shard_count = (cpus < 1) ? 1 : (cpus > MAX_SHARDS ? MAX_SHARDS : (int)cpus);
+    }
+
+    // 종료 시그널은 핸들러 대신 signalfd로 로비 루프에서 받음 (뒤에 만드는 스레드도 막힌 마스크를 물려받음)
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+    // 무시(SIG_IGN)된 채로 물려받은 시그널은 signalfd에도 오지 않으므로 (백그라운드 실행 등) 기본값으로
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal_fd = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        perror("signalfd");
+        exit(EXIT_FAILURE);
+    }
+    // 끊긴 소켓에 send해도 프로세스가 죽지 않도록
+    signal(SIGPIPE, SIG_IGN);
+
     // 초기화
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        clients[i].socket = -1;
-        memset(clients[i].username, 0, sizeof(clients[i].username));
-    }
-     init_client_buffers();
-    // 게임 보드 초기화
-    initializeBoard(&game_board);
-    
+    if (hash_map_init(&clients_by_name, 1024) != 0 || hash_map_init(&game_feeds, 1024) != 0) {
+        fprintf(stderr, "Error: 연결 테이블 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // 계측: 리액터(로비, 게임 샤드, 관전)마다 하나
+    if (metrics_init(shard_count + 2) != 0) {
+        fprintf(stderr, "Error: 계측 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    if (admin_port && metrics_serve(admin_port) != 0) {
+        fprintf(stderr, "Error: 관리 포트 %d를 열 수 없습니다\n", admin_port);
+        exit(EXIT_FAILURE);
+    }
+
+    // 대국 기록 파일 (끝이 깨져 있으면 여기서 잘라냄)
+    if (record_path && record_log_open(&record_log, record_path) != 0) {
+        fprintf(stderr, "Error: 대국 기록 파일을 열 수 없습니다: %s\n", record_path);
+        exit(EXIT_FAILURE);
+    }
+
     // 소켓 생성
     if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
         perror("socket failed");
         exit(EXIT_FAILURE);
     }
-    
+
     // 소켓 옵션 설정
     int opt = 1;
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
         perror("setsockopt");
         exit(EXIT_FAILURE);
     }
-    
+
     // 주소 설정 (수정됨)
     address.sin_family = AF_INET;
-    
+
     // IP 주소 설정
     if (strcmp(server_ip, "0.0.0.0") == 0) {
         address.sin_addr.s_addr = INADDR_ANY;  // 모든 인터페이스
@@ -796,148 +1797,50 @@ int main(int argc __attribute__((unused)), char *argv[] __attribute__((unused)))
             exit(EXIT_FAILURE);
         }
     }
-    
+
     address.sin_port = htons(server_port);  // 포트 설정
-    
+
     // 바인딩
     if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
         perror("bind failed");
         printf("Failed to bind to %s:%d\n", server_ip, server_port);
         exit(EXIT_FAILURE);
     }
-    
-    // 리스닝
-    if (listen(server_fd, 3) < 0) {
+
+    // 리스닝 (동시에 많은 대국자가 접속하므로 백로그를 넉넉히)
+    if (listen(server_fd, SOMAXCONN) < 0) {
         perror("listen");
         exit(EXIT_FAILURE);
     }
-    
-    // 서버 시작 메시지 (수정됨)
-    printf("OctaFlip 서버가 %s:%d에서 시작되었습니다.\n", 
-           strcmp(server_ip, "0.0.0.0") == 0 ? "모든 인터페이스" : server_ip, 
-           server_port);
-    
-    char buffer[BUFFER_SIZE];
-    
-    // poll을 위한 구조체 배열 (서버 소켓 + 최대 클라이언트 수)
-    struct pollfd fds[MAX_CLIENTS + 1];
-    int nfds = 1;  // 현재 활성 파일 디스크립터 수
-    
-    // 서버 소켓 설정
-    fds[0].fd = server_fd;
-    fds[0].events = POLLIN;
-    
-    // 클라이언트 소켓 초기화
-    for (int i = 1; i <= MAX_CLIENTS; i++) {
-        fds[i].fd = -1;
-        fds[i].events = POLLIN;
-    }
-    
-    while (1) {
-        // 타임아웃 확인
-        check_timeout();
-        
-        // poll 호출 (100ms 타임아웃)
-        int poll_result = poll(fds, nfds, 100);
-        
-        if (poll_result < 0 && errno != EINTR) {
-            perror("poll error");
-            continue;
-        }
-        
-        // 새 연결 확인
-        if (fds[0].revents & POLLIN) {
-            if ((new_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t*)&addrlen)) < 0) {
-                perror("accept");
-                continue;
-            }
-            
-            // 비차단 모드로 설정
-            set_socket_nonblocking(new_socket);
-            
-            printf("새 연결, 소켓 fd: %d, IP: %s, 포트: %d\n",
-                   new_socket, inet_ntoa(address.sin_addr), ntohs(address.sin_port));
-            
-            // 빈 슬롯 찾기
-            int slot_found = 0;
-            for (int i = 0; i < MAX_CLIENTS; i++) {
-                if (clients[i].socket == -1) {
-                    clients[i].socket = new_socket;
-                    
-                    // poll 배열에 추가
-                    for (int j = 1; j <= MAX_CLIENTS; j++) {
-                        if (fds[j].fd == -1) {
-                            fds[j].fd = new_socket;
-                            if (j >= nfds) nfds = j + 1;
-                            break;
-                        }
-                    }
-                    
-                    client_count++;
-                    slot_found = 1;
-                    break;
-                }
-            }
-            
-            if (!slot_found) {
-                // 추가 연결 거부
-                close(new_socket);
-                printf("최대 클라이언트 수에 도달. 연결 거부.\n");
-            }
-        }
-        
-        // 클라이언트 메시지 확인
-                for (int i = 1; i <= MAX_CLIENTS && i < nfds; i++) {
-            if (fds[i].fd != -1 && (fds[i].revents & POLLIN)) {
-                // 클라이언트로부터 데이터 읽기
-                char temp_buffer[BUFFER_SIZE];
-                int valread = read(fds[i].fd, temp_buffer, BUFFER_SIZE - 1);
-                
-                if (valread > 0) {
-                    temp_buffer[valread] = '\0';
-                    
-                    // 해당 클라이언트 인덱스 찾기
-                    int client_idx = -1;
-                    for (int j = 0; j < MAX_CLIENTS; j++) {
-                        if (clients[j].socket == fds[i].fd) {
-                            client_idx = j;
-                            break;
-                        }
-                    }
-                    
-                    if (client_idx != -1) {
-                        // 청크 단위로 받은 데이터 처리
-                        process_client_data(client_idx, temp_buffer, valread);
-                    }
-                } else {
-                    // 연결 종료 또는 오류
-                    handle_client_disconnect(fds[i].fd);
-                    
-                    // 해당 클라이언트의 버퍼도 초기화
-                    int disconnected_idx = -1;
-                    for (int j = 0; j < MAX_CLIENTS; j++) {
-                        if (clients[j].socket == fds[i].fd) {
-                            disconnected_idx = j;
-                            break;
-                        }
-                    }
-                    if (disconnected_idx != -1) {
-                        memset(&client_buffers[disconnected_idx], 0, sizeof(ClientBuffer));
-                    }
-                    
-                    // poll 배열에서 제거
-                    fds[i].fd = -1;
-                    
-                    // nfds 재계산
-                    while (nfds > 1 && fds[nfds-1].fd == -1) {
-                        nfds--;
-                    }
-                }
-            }
+    set_socket_nonblocking(server_fd);
+
+    // 리액터 생성: 로비(메인 스레드) + 게임 샤드 N개
+    if (reactor_init(&lobby_reactor, 0, server_fd) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    struct epoll_event signal_event;
+    signal_event.events = EPOLLIN;
+    signal_event.data.fd = signal_fd;
+    epoll_ctl(lobby_reactor.epoll_fd, EPOLL_CTL_ADD, signal_fd, &signal_event);
+    for (int i = 0; i < shard_count; i++) {
+        if (reactor_init(&shards[i], i + 1, -1) != 0 ||
+            pthread_create(&shards[i].thread, NULL, reactor_main, &shards[i]) != 0) {
+            fprintf(stderr, "Error: 게임 스레드 %d 생성 실패\n", i + 1);
+            exit(EXIT_FAILURE);
         }
     }
-    
-    return 0;
-}
+    if (reactor_init(&spectator_hub, shard_count + 1, -1) != 0 ||
+        pthread_create(&spectator_hub.thread, NULL, reactor_main, &spectator_hub) != 0) {
+        fprintf(stderr, "Error: 관전 스레드 생성 실패\n");
+        exit(EXIT_FAILURE);
+    }
 
+    // 서버 시작 메시지 (수정됨)
+    printf("OctaFlip 서버가 %s:%d에서 시작되었습니다. (게임 스레드 %d개)\n",
+           strcmp(server_ip, "0.0.0.0") == 0 ? "모든 인터페이스" : server_ip,
+           server_port, shard_count);
 
+    reactor_main(&lobby_reactor);
+    shutdown_server();
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <string.h>
+#include <time.h>
+#include "timer_queue.h"
+
+#define SLOT_MASK ((uint64_t)TIMER_WHEEL_SLOTS - 1)
+#define LEVEL_SHIFT(level) ((level) * TIMER_WHEEL_BITS)
+// 휠 전체가 담을 수 있는 최대 거리 (틱)
+#define WHEEL_SPAN (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void timer_queue_init(TimerQueue *queue) {
+    memset(queue, 0, sizeof(TimerQueue));
+    queue->current_tick = monotonic_ns() / TIMER_TICK_NS;
+}
+
+void timer_queue_destroy(TimerQueue *queue) {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            for (Timer *timer = queue->slots[level][slot]; timer; timer = timer->next) {
+                timer->level = -1;
+            }
+        }
+    }
+    memset(queue, 0, sizeof(TimerQueue));
+}
+
+void timer_init(Timer *timer, TimerCallback callback, void *arg) {
+    memset(timer, 0, sizeof(Timer));
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->level = -1;
+}
+
+int timer_pending(const Timer *timer) {
+    return timer->level >= 0;
+}
+
+// expire_tick까지의 거리로 단계를 고르고 해당 칸 앞에 넣음
+static void wheel_insert(TimerQueue *queue, Timer *timer) {
+    uint64_t expire = timer->expire_tick;
+    if (expire <= queue->current_tick) expire = queue->current_tick + 1;
+    uint64_t delta = expire - queue->current_tick;
+    // 휠 범위를 넘으면 맨 위 단계 끝에 두었다가 내려올 때 다시 배치
+    if (delta >= WHEEL_SPAN) expire = queue->current_tick + WHEEL_SPAN - 1;
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           (expire - queue->current_tick) >= (1ULL << LEVEL_SHIFT(level + 1))) {
+        level++;
+    }
+    int slot = (int)((expire >> LEVEL_SHIFT(level)) & SLOT_MASK);
+
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = queue->slots[level][slot];
+    if (timer->next) timer->next->prev = timer;
+    queue->slots[level][slot] = timer;
+    queue->occupied[level] |= 1ULL << slot;
+}
+
+static void wheel_unlink(TimerQueue *queue, Timer *timer) {
+    if (timer->prev) timer->prev->next = timer->next;
+    else queue->slots[timer->level][timer->slot] = timer->next;
+    if (timer->next) timer->next->prev = timer->prev;
+    if (!queue->slots[timer->level][timer->slot]) {
+        queue->occupied[timer->level] &= ~(1ULL << timer->slot);
+    }
+    timer->prev = timer->next = NULL;
+    timer->level = -1;
+}
+
+int timer_schedule(TimerQueue *queue, Timer *timer, uint64_t deadline) {
+    if (timer_pending(timer)) {
+        wheel_unlink(queue, timer);
+        queue->count--;
+    }
+    timer->deadline = deadline;
+    timer->expire_tick = (deadline + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+    wheel_insert(queue, timer);
+    queue->count++;
+    return 0;
+}
+
+void timer_cancel(TimerQueue *queue, Timer *timer) {
+    if (!timer_pending(timer)) return;
+    wheel_unlink(queue, timer);
+    queue->count--;
+}
+
+// 상위 단계 칸의 타이머들을 현재 틱 기준으로 다시 배치
+static void cascade(TimerQueue *queue, int level, int slot) {
+    Timer *timer = queue->slots[level][slot];
+    queue->slots[level][slot] = NULL;
+    queue->occupied[level] &= ~(1ULL << slot);
+    while (timer) {
+        Timer *next = timer->next;
+        wheel_insert(queue, timer);
+        timer = next;
+    }
+}
+
+// 현재 틱에서 from 이후 처음으로 비트가 선 칸까지의 거리 (1..64), 없으면 0
+static int next_occupied_distance(uint64_t occupied, int from) {
+    if (!occupied) return 0;
+    // from 다음 칸이 비트 0에 오도록 회전
+    int shift = (from + 1) & (int)SLOT_MASK;
+    uint64_t rotated = (occupied >> shift) | (shift ? occupied << (TIMER_WHEEL_SLOTS - shift) : 0);
+    return __builtin_ctzll(rotated) + 1;
+}
+
+uint64_t timer_next_deadline(const TimerQueue *queue) {
+    if (queue->count == 0) return 0;
+    uint64_t best = UINT64_MAX;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        uint64_t position = queue->current_tick >> LEVEL_SHIFT(level);
+        int distance = next_occupied_distance(queue->occupied[level], (int)(position & SLOT_MASK));
+        if (!distance) continue;
+        // 0단계는 그 칸의 틱, 상위 단계는 그 칸이 아래로 내려오는 경계 틱
+        uint64_t tick = (position + distance) << LEVEL_SHIFT(level);
+        if (tick < best) best = tick;
+    }
+    return best * TIMER_TICK_NS;
+}
+
+int timer_run_expired(TimerQueue *queue, uint64_t now) {
+    uint64_t target = now / TIMER_TICK_NS;
+    int fired = 0;
+
+    while (queue->current_tick < target) {
+        if (queue->count == 0) {
+            queue->current_tick = target;
+            break;
+        }
+        // 0단계가 비어 있으면 다음 경계 직전까지 건너뜀
+        if (!queue->occupied[0]) {
+            uint64_t boundary_before = queue->current_tick | SLOT_MASK;
+            if (boundary_before > queue->current_tick) {
+                queue->current_tick = (boundary_before < target) ? boundary_before : target;
+                continue;
+            }
+        }
+
+        queue->current_tick++;
+        uint64_t tick = queue->current_tick;
+
+        // 단계 경계에 닿으면 위 단계 칸을 차례로 내려보냄
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((tick & ((1ULL << LEVEL_SHIFT(level)) - 1)) != 0) break;
+            int slot = (int)((tick >> LEVEL_SHIFT(level)) & SLOT_MASK);
+            if (queue->occupied[level] & (1ULL << slot)) cascade(queue, level, slot);
+        }
+
+        int slot = (int)(tick & SLOT_MASK);
+        while (queue->slots[0][slot]) {
+            Timer *timer = queue->slots[0][slot];
+            wheel_unlink(queue, timer);
+            queue->count--;
+            if (timer->expire_tick > tick) {
+                // 휠 범위를 넘어 잘렸던 타이머: 남은 거리만큼 다시 배치
+                wheel_insert(queue, timer);
+                queue->count++;
+                continue;
+            }
+            fired++;
+            if (timer->callback) timer->callback(timer->arg);
+        }
+    }
+    return fired;
+}
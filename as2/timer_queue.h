@@ -0,0 +1,59 @@
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+
+#include <stdint.h>
+
+// 턴 마감 시각 관리 (CLOCK_MONOTONIC, 나노초).
+// 계층형 타이머 휠: 1ms 틱, 단계마다 64칸 × 4단계 (64ms / 4.1s / 4.4분 / 4.7시간).
+// 등록/취소 O(1), 만료는 틱마다 한 칸씩 처리하고 상위 단계는 경계에서 아래로 내려보낸다.
+// 타이머는 세션 구조체 안에 들어 있어 별도 할당이 없다.
+
+#define TIMER_TICK_NS 1000000ULL
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+
+typedef void (*TimerCallback)(void *arg);
+
+typedef struct Timer {
+    uint64_t deadline;        // 만료 시각 (monotonic_ns 기준)
+    TimerCallback callback;
+    void *arg;
+    uint64_t expire_tick;     // deadline을 틱 단위로 올림
+    struct Timer *prev;       // 휠 칸의 이중 연결 목록
+    struct Timer *next;
+    int level;                // 들어 있는 단계, 대기 중이 아니면 -1
+    int slot;
+} Timer;
+
+typedef struct {
+    Timer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS];   // 비어 있지 않은 칸 비트맵
+    uint64_t current_tick;                   // 마지막으로 처리한 틱
+    int count;
+} TimerQueue;
+
+// 단조 증가 시계 (나노초)
+uint64_t monotonic_ns(void);
+
+void timer_queue_init(TimerQueue *queue);
+void timer_queue_destroy(TimerQueue *queue);
+
+void timer_init(Timer *timer, TimerCallback callback, void *arg);
+
+// 마감 시각 설정 (이미 대기 중이면 옮김). 실패 시 -1
+int timer_schedule(TimerQueue *queue, Timer *timer, uint64_t deadline);
+
+// 대기 중인 타이머 취소 (대기 중이 아니면 아무것도 안 함)
+void timer_cancel(TimerQueue *queue, Timer *timer);
+
+int timer_pending(const Timer *timer);
+
+// 다음에 깨어나야 할 시각, 없으면 0.
+// 상위 단계만 남아 있으면 실제 마감보다 이른 단계 경계 시각을 돌려준다 (깨어나서 아래로 내려보냄).
+uint64_t timer_next_deadline(const TimerQueue *queue);
+
+// now까지 만료된 타이머의 콜백 실행. 콜백 안에서 다시 schedule/cancel 가능. 실행 수 반환
+int timer_run_expired(TimerQueue *queue, uint64_t now);
+
+#endif /* TIMER_QUEUE_H */
@@ -220,6 +220,8 @@ short POSITION_WEIGHTS[BOARD_SIZE][BOARD_SIZE] = {
 };
 
 static unsigned long long zobrist_table[BOARD_SIZE][BOARD_SIZE][3];
+static unsigned long long zobrist_side;  // 빨강 차례일 때 XOR (패스 노드와 구분)
+static unsigned long long zobrist_perspective;  // 빨강 관점 평가일 때 XOR (폰더링 시 관점 분리)
 static int zobrist_initialized = 0;
 
 void initZobrist(void) {
@@ -251,6 +253,8 @@ NEXT_I:
         i++;
         goto I_CHECK;
 DONE_I:
+        zobrist_side = (((unsigned long long)rand() << 32) | rand());
+        zobrist_perspective = (((unsigned long long)rand() << 32) | rand());
         zobrist_initialized = 1;
     }
 END_INIT:
@@ -267,6 +271,14 @@ ALLOC_ENGINE:
     engine->transposition_table = NULL;
     engine->nodes_searched = 0;
     engine->time_limit_exceeded = 0;
+    engine->completed_depth = 0;
+    engine->time_limit = TIME_LIMIT;
+    engine->pondering = 0;
+    engine->ponder.phase = PONDER_IDLE;
+    engine->io_hook = NULL;
+    engine->io_hook_data = NULL;
+    engine->next_io_check = 0.0;
+    initSearchSettings(&engine->settings);
     goto ALLOC_TT;
 
 ALLOC_TT:
@@ -287,6 +299,21 @@ FAIL:
     return NULL;
 }
 
+void initSearchSettings(SearchSettings *settings) {
+    settings->lmr_enabled = 1;
+    settings->lmr_min_depth = LMR_MIN_DEPTH;
+    settings->lmr_full_depth_moves = LMR_FULL_DEPTH_MOVES;
+    settings->lmr_reduction = LMR_REDUCTION;
+    settings->lmr_late_move_index = LMR_LATE_MOVE_INDEX;
+    settings->futility_enabled = 1;
+    settings->futility_max_depth = FUTILITY_MAX_DEPTH;
+    settings->futility_margin = FUTILITY_MARGIN;
+    settings->futility_flip_bonus = FUTILITY_FLIP_BONUS;
+    settings->razoring_enabled = 1;
+    settings->razor_max_depth = RAZOR_MAX_DEPTH;
+    settings->razor_margin = RAZOR_MARGIN;
+}
+
 void destroyAIEngine(AIEngine *engine) {
     if (!engine) goto END_DESTROY;
 
@@ -299,15 +326,36 @@ END_DESTROY:
     return;
 }
 
+// 단조 증가 벽시계(초). clock()은 CPU 시간이라 상대 클라이언트와 코어를
+// 나눠 쓰거나 폰더링이 끼면 서버 제한 시간보다 늦게 끝날 수 있다.
+double engineClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// 탐색 중 소켓을 돌볼 훅 설정 (탐색 스레드를 따로 두지 않고 시간 확인 때 같이 부른다)
+void setEngineIOHook(AIEngine *engine, EngineIOHook hook, void *user_data) {
+    engine->io_hook = hook;
+    engine->io_hook_data = user_data;
+    engine->next_io_check = 0.0;
+}
+
 int isTimeUp(AIEngine *engine) {
     if (engine->time_limit_exceeded) goto TIMEUP;
     {
-        clock_t now = clock();
-        double elapsed = ((double)(now - engine->start_time)) / CLOCKS_PER_SEC;
-        if (elapsed >= TIME_LIMIT) {
+        double now = engineClock();
+        if (now - engine->start_time >= engine->time_limit) {
             engine->time_limit_exceeded = 1;
             goto TIMEUP;
         }
+        if (engine->io_hook && now >= engine->next_io_check) {
+            engine->next_io_check = now + IO_HOOK_INTERVAL;
+            if (engine->io_hook(engine->io_hook_data)) {
+                engine->time_limit_exceeded = 1;
+                goto TIMEUP;
+            }
+        }
     }
     return 0;
 TIMEUP:
@@ -460,7 +508,11 @@ STAB_DONE:
     return stability;
 }
 
+// 복제(1칸) 이동은 출발 칸과 무관하게 같은 보드를 만들므로 목표 칸당 하나만 생성한다.
+// 대표 출발 칸은 스캔 순서상 처음 찾은 실제 말이라 프로토콜로 그대로 전송 가능.
+// 점프(2칸) 이동은 출발 칸이 비워지므로 출발/목표 쌍마다 생성한다.
 void getAllValidMoves(const GameBoard *board, char player, Move *moves, int *count) {
+    unsigned long long clone_targets = 0ULL;  // 이미 생성한 복제 목표 칸 (비트 = r*8+c)
     *count = 0;
     int r = 0;
 R_CHECK_VM:
@@ -488,6 +540,11 @@ S_CHECK_VM:
                         if (board->cells[mr][mc] == RED_PLAYER || board->cells[mr][mc] == BLUE_PLAYER || board->cells[mr][mc] == BLOCKED_CELL) goto INC_S_VM;
                     }
                     if (board->cells[nr][nc] == EMPTY_CELL) {
+                        if (s == 1) {
+                            unsigned long long bit = 1ULL << (nr * BOARD_SIZE + nc);
+                            if (clone_targets & bit) goto INC_S_VM;
+                            clone_targets |= bit;
+                        }
                         moves[*count].player = player;
                         moves[*count].sourceRow = r;
                         moves[*count].sourceCol = c;
@@ -519,7 +576,174 @@ VM_DONE:
     return;
 }
 
+// 1칸 이동(말 복제) 여부
+int isCloneMove(const Move *move) {
+    int dr = absVal(move->targetRow - move->sourceRow);
+    int dc = absVal(move->targetCol - move->sourceCol);
+    return dr <= 1 && dc <= 1;
+}
+
+// 탐색 노드용 해시: 보드 + 둘 차례 (같은 보드라도 패스 후에는 다른 노드)
+// + 평가 관점 (TT 값은 original_player 관점이라 상대 관점 탐색과 섞이면 안 됨)
+static unsigned long long positionHash(const GameBoard *board, char side_to_move, char perspective) {
+    unsigned long long hash = calculateHash(board);
+    if (side_to_move == RED_PLAYER) hash ^= zobrist_side;
+    if (perspective == RED_PLAYER) hash ^= zobrist_perspective;
+    return hash;
+}
+
+static int sameMove(const Move *a, const Move *b) {
+    return a->sourceRow == b->sourceRow && a->sourceCol == b->sourceCol &&
+           a->targetRow == b->targetRow && a->targetCol == b->targetCol;
+}
+
+// 목표 칸 주변에서 뒤집히는 상대 말 수
+static int countFlips(const GameBoard *board, const Move *move) {
+    char opponent = (move->player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    int flips = 0;
+    for (int d = 0; d < 8; d++) {
+        int nr = move->targetRow + dRow[d];
+        int nc = move->targetCol + dCol[d];
+        if (nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE) continue;
+        if (board->cells[nr][nc] == opponent) flips++;
+    }
+    return flips;
+}
+
+// 같은 결과 보드를 만드는 이동인지 (복제 이동은 목표 칸만 비교)
+static int sameResult(const Move *a, const Move *b) {
+    if (isCloneMove(a) && isCloneMove(b)) {
+        return a->targetRow == b->targetRow && a->targetCol == b->targetCol;
+    }
+    return sameMove(a, b);
+}
+
+// 남은 이동 중 점수가 가장 높은 것을 index 위치로 가져옴 (선택 정렬 1단계)
+static void pickNextMove(MovePicker *picker, int index) {
+    int best = index;
+    for (int j = index + 1; j < picker->count; j++) {
+        if (picker->scores[j] > picker->scores[best]) best = j;
+    }
+    if (best != index) {
+        Move tmp_move = picker->moves[index];
+        picker->moves[index] = picker->moves[best];
+        picker->moves[best] = tmp_move;
+        int tmp = picker->scores[index];
+        picker->scores[index] = picker->scores[best];
+        picker->scores[best] = tmp;
+        tmp = picker->flips[index];
+        picker->flips[index] = picker->flips[best];
+        picker->flips[best] = tmp;
+    }
+}
+
+static void addPickerMove(MovePicker *picker, int sr, int sc, int tr, int tc, int flips) {
+    Move *move = &picker->moves[picker->count];
+    move->player = picker->player;
+    move->sourceRow = sr;
+    move->sourceCol = sc;
+    move->targetRow = tr;
+    move->targetCol = tc;
+    if (picker->has_tt_move && sameResult(move, &picker->tt_move)) return;
+    // 정렬 점수: 많이 뒤집을수록, 복제(1칸) 이동일수록, 코너일수록 우선
+    picker->scores[picker->count] = flips * 4 + (isCloneMove(move) ? 2 : 0) +
+                                    (isCorner(tr, tc) ? 3 : 0);
+    picker->flips[picker->count] = flips;
+    picker->count++;
+}
+
+// 목표 칸 기준 생성: want_captures면 상대 말이 인접한 빈 칸만, 아니면 나머지만.
+// 복제 이동은 목표 칸당 하나, 점프 이동은 출발 칸마다 하나.
+static void generatePickerMoves(MovePicker *picker, int want_captures) {
+    const GameBoard *board = picker->board;
+    char player = picker->player;
+    char opponent = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    picker->count = 0;
+    picker->index = 0;
+    for (int r = 0; r < BOARD_SIZE; r++) {
+        for (int c = 0; c < BOARD_SIZE; c++) {
+            if (board->cells[r][c] != EMPTY_CELL) continue;
+            int flips = 0;
+            int clone_r = -1, clone_c = -1;
+            for (int d = 0; d < 8; d++) {
+                int nr = r + dRow[d], nc = c + dCol[d];
+                if (nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE) continue;
+                if (board->cells[nr][nc] == opponent) flips++;
+                else if (board->cells[nr][nc] == player && clone_r < 0) {
+                    clone_r = nr;
+                    clone_c = nc;
+                }
+            }
+            if ((flips > 0) != want_captures) continue;
+            if (clone_r >= 0) addPickerMove(picker, clone_r, clone_c, r, c, flips);
+            for (int d = 0; d < 8; d++) {
+                int jr = r + dRow[d] * 2, jc = c + dCol[d] * 2;
+                if (jr < 0 || jr >= BOARD_SIZE || jc < 0 || jc >= BOARD_SIZE) continue;
+                if (board->cells[jr][jc] != player) continue;
+                if (board->cells[r + dRow[d]][c + dCol[d]] != EMPTY_CELL) continue;
+                addPickerMove(picker, jr, jc, r, c, flips);
+            }
+        }
+    }
+}
+
+void initMovePicker(MovePicker *picker, const GameBoard *board, char player, const Move *tt_move) {
+    picker->board = board;
+    picker->player = player;
+    picker->stage = PICK_TT_MOVE;
+    picker->count = 0;
+    picker->index = 0;
+    picker->yielded = 0;
+    picker->has_tt_move = 0;
+    if (tt_move && !(tt_move->sourceRow == tt_move->targetRow && tt_move->sourceCol == tt_move->targetCol)) {
+        picker->tt_move = *tt_move;
+        picker->tt_move.player = player;
+        picker->has_tt_move = isValidMove(board, &picker->tt_move);
+    }
+}
+
+// 다음 이동을 내준다. 더 이상 없으면 0.
+int nextMove(MovePicker *picker, Move *move, int *flips) {
+    for (;;) {
+        switch (picker->stage) {
+            case PICK_TT_MOVE:
+                picker->stage = PICK_GEN_CAPTURES;
+                if (picker->has_tt_move) {
+                    *move = picker->tt_move;
+                    *flips = countFlips(picker->board, move);
+                    picker->yielded++;
+                    return 1;
+                }
+                break;
+            case PICK_GEN_CAPTURES:
+                generatePickerMoves(picker, 1);
+                picker->stage = PICK_CAPTURES;
+                break;
+            case PICK_GEN_QUIETS:
+                generatePickerMoves(picker, 0);
+                picker->stage = PICK_QUIETS;
+                break;
+            case PICK_CAPTURES:
+            case PICK_QUIETS:
+                if (picker->index < picker->count) {
+                    pickNextMove(picker, picker->index);
+                    *move = picker->moves[picker->index];
+                    *flips = picker->flips[picker->index];
+                    picker->index++;
+                    picker->yielded++;
+                    return 1;
+                }
+                picker->stage = (picker->stage == PICK_CAPTURES) ? PICK_GEN_QUIETS : PICK_DONE;
+                break;
+            default:
+                return 0;
+        }
+    }
+}
+
 // Minimax with Alpha-Beta Pruning
+// 값은 항상 original_player 관점. 프런티어에서는 razoring/futility로,
+// 뒤쪽 이동은 LMR로 얕게 탐색한 뒤 경계를 넘으면(fail-high) 전체 깊이로 재탐색한다.
 int minimax(AIEngine *engine, GameBoard *board, int depth, int alpha, int beta, 
            char maximizing_player, char original_player, int game_phase) {
     
@@ -531,155 +755,201 @@ int minimax(AIEngine *engine, GameBoard *board, int depth, int alpha, int beta,
     }
     
     // 터미널 노드 또는 최대 깊이 도달
-    if (depth == 0 || hasGameEnded(board)) {
+    if (depth <= 0 || hasGameEnded(board)) {
         return evaluateBoard(board, original_player, game_phase);
     }
     
+    const SearchSettings *cfg = &engine->settings;
+    int is_max = (maximizing_player == original_player);
+    char next_player = (maximizing_player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    int alpha_orig = alpha;
+    int beta_orig = beta;
+    int null_window = (beta - alpha == 1);
+    
     // Transposition Table 조회
-    unsigned long long hash = calculateHash(board);
+    unsigned long long hash = positionHash(board, maximizing_player, original_player);
     TTEntry *tt_entry = lookupTT(engine, hash);
-    if (tt_entry && tt_entry->depth >= depth) {
-        if (tt_entry->flag == 'E') {
-            return tt_entry->value;
-        } else if (tt_entry->flag == 'L' && tt_entry->value >= beta) {
-            return tt_entry->value;
-        } else if (tt_entry->flag == 'U' && tt_entry->value <= alpha) {
-            return tt_entry->value;
+    Move tt_move = { 0 };
+    int has_tt_move = 0;
+    if (tt_entry) {
+        if (tt_entry->depth >= depth) {
+            if (tt_entry->flag == 'E') {
+                return tt_entry->value;
+            } else if (tt_entry->flag == 'L' && tt_entry->value >= beta) {
+                return tt_entry->value;
+            } else if (tt_entry->flag == 'U' && tt_entry->value <= alpha) {
+                return tt_entry->value;
+            }
         }
+        tt_move = tt_entry->best_move;
+        has_tt_move = 1;
     }
     
-    Move moves[256];
-    int move_count;
-    getAllValidMoves(board, maximizing_player, moves, &move_count);
+    // 프런티어 노드의 정적 평가 (razoring/futility 판단용)
+    int frontier_depth = 0;
+    if (cfg->razoring_enabled && cfg->razor_max_depth > frontier_depth) frontier_depth = cfg->razor_max_depth;
+    if (cfg->futility_enabled && cfg->futility_max_depth > frontier_depth) frontier_depth = cfg->futility_max_depth;
+    int static_eval = 0;
+    if (depth <= frontier_depth) {
+        static_eval = evaluateBoard(board, original_player, game_phase);
+    }
     
-    // 유효한 이동이 없으면 패스
-    if (move_count == 0) {
-        char opponent = (maximizing_player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
-        
-        // 상대도 이동할 수 없으면 게임 종료
-        Move opp_moves[256];
-        int opp_count;
-        getAllValidMoves(board, opponent, opp_moves, &opp_count);
-        if (opp_count == 0) {
-            return evaluateBoard(board, original_player, game_phase);
+    // Razoring: 널 윈도우 노드에서 정적 평가가 경계에서 한참 멀면
+    // 얕은 탐색으로 확인하고, 경계를 넘으면(fail-high) 정상 탐색으로 진행
+    if (cfg->razoring_enabled && null_window && depth <= cfg->razor_max_depth) {
+        int margin = cfg->razor_margin * depth;
+        if (is_max && static_eval + margin <= alpha) {
+            int value = minimax(engine, board, depth - 2, alpha, alpha + 1,
+                                maximizing_player, original_player, game_phase);
+            if (value <= alpha) return value;
+        } else if (!is_max && static_eval - margin >= beta) {
+            int value = minimax(engine, board, depth - 2, beta - 1, beta,
+                                maximizing_player, original_player, game_phase);
+            if (value >= beta) return value;
         }
-        
-        // 상대 턴으로 넘어감
-        return minimax(engine, board, depth - 1, alpha, beta, opponent, original_player, game_phase);
     }
     
     Move best_move;
     best_move.player = maximizing_player;
     best_move.sourceRow = best_move.sourceCol = best_move.targetRow = best_move.targetCol = 0;
-    char tt_flag = 'U';  // Upper bound
+    int best_eval = is_max ? NEG_INFINITY_VAL : INFINITY_VAL;
+    int searched = 0;
     
-    if (maximizing_player == original_player) {
-        // Maximizing player
-        int max_eval = NEG_INFINITY_VAL;
-        
-        for (int i = 0; i < move_count; i++) {
-            if (isTimeUp(engine)) break;
-            
-            GameBoard temp_board;
-            memcpy(&temp_board, board, sizeof(GameBoard));
-            applyMove(&temp_board, &moves[i]);
-            
-            char next_player = (maximizing_player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
-            int eval = minimax(engine, &temp_board, depth - 1, alpha, beta, next_player, original_player, game_phase);
-            
-            if (eval > max_eval) {
-                max_eval = eval;
-                best_move = moves[i];
-            }
-            
-            alpha = (alpha > eval) ? alpha : eval;
-            if (beta <= alpha) {
-                tt_flag = 'L';  // Lower bound
-                break;
-            }
+    // 이동은 단계별로 생성: 컷오프가 나면 나머지 단계는 생성하지 않음
+    MovePicker picker;
+    initMovePicker(&picker, board, maximizing_player, has_tt_move ? &tt_move : NULL);
+    Move move;
+    int flips;
+    
+    while (!isTimeUp(engine) && nextMove(&picker, &move, &flips)) {
+        // Futility Pruning: 프런티어에서 뒤집는 말을 감안해도 경계에 못 미치는 이동 생략
+        if (cfg->futility_enabled && searched > 0 && depth <= cfg->futility_max_depth) {
+            int gain = cfg->futility_margin * depth + flips * cfg->futility_flip_bonus;
+            if (is_max && static_eval + gain <= alpha) continue;
+            if (!is_max && static_eval - gain >= beta) continue;
         }
         
-        if (max_eval == alpha) tt_flag = 'E';  // Exact
-        storeInTT(engine, hash, depth, max_eval, best_move, tt_flag);
-        return max_eval;
+        GameBoard temp_board;
+        memcpy(&temp_board, board, sizeof(GameBoard));
+        applyMove(&temp_board, &move);
         
-    } else {
-        // Minimizing player
-        int min_eval = INFINITY_VAL;
+        int eval;
+        int reduction = 0;
+        if (cfg->lmr_enabled && depth >= cfg->lmr_min_depth &&
+            searched >= cfg->lmr_full_depth_moves) {
+            reduction = cfg->lmr_reduction;
+            if (searched >= cfg->lmr_late_move_index) reduction++;
+            if (flips == 0) reduction++;
+            if (reduction > depth - 2) reduction = depth - 2;
+        }
         
-        for (int i = 0; i < move_count; i++) {
-            if (isTimeUp(engine)) break;
-            
-            GameBoard temp_board;
-            memcpy(&temp_board, board, sizeof(GameBoard));
-            applyMove(&temp_board, &moves[i]);
-            
-            char next_player = (maximizing_player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
-            int eval = minimax(engine, &temp_board, depth - 1, alpha, beta, next_player, original_player, game_phase);
-            
-            if (eval < min_eval) {
-                min_eval = eval;
-                best_move = moves[i];
-            }
-            
-            beta = (beta < eval) ? beta : eval;
-            if (beta <= alpha) {
-                tt_flag = 'L';  // Lower bound
-                break;
+        if (reduction > 0) {
+            // 감축 깊이 널 윈도우 탐색 → 경계를 넘으면 전체 깊이로 재탐색
+            if (is_max) {
+                eval = minimax(engine, &temp_board, depth - 1 - reduction, alpha, alpha + 1,
+                               next_player, original_player, game_phase);
+                if (eval > alpha) {
+                    eval = minimax(engine, &temp_board, depth - 1, alpha, beta,
+                                   next_player, original_player, game_phase);
+                }
+            } else {
+                eval = minimax(engine, &temp_board, depth - 1 - reduction, beta - 1, beta,
+                               next_player, original_player, game_phase);
+                if (eval < beta) {
+                    eval = minimax(engine, &temp_board, depth - 1, alpha, beta,
+                                   next_player, original_player, game_phase);
+                }
             }
+        } else {
+            eval = minimax(engine, &temp_board, depth - 1, alpha, beta,
+                           next_player, original_player, game_phase);
         }
+        searched++;
         
-        if (min_eval == beta) tt_flag = 'E';  // Exact
-        storeInTT(engine, hash, depth, min_eval, best_move, tt_flag);
-        return min_eval;
+        if (is_max) {
+            if (eval > best_eval) {
+                best_eval = eval;
+                best_move = move;
+            }
+            if (eval > alpha) alpha = eval;
+        } else {
+            if (eval < best_eval) {
+                best_eval = eval;
+                best_move = move;
+            }
+            if (eval < beta) beta = eval;
+        }
+        if (beta <= alpha) break;
+    }
+    
+    if (searched == 0) {
+        // 유효한 이동이 없으면 패스
+        if (picker.yielded == 0 && !engine->time_limit_exceeded) {
+            // 상대도 이동할 수 없으면 게임 종료
+            if (!hasValidMove(board, next_player)) {
+                return evaluateBoard(board, original_player, game_phase);
+            }
+            // 상대 턴으로 넘어감
+            return minimax(engine, board, depth - 1, alpha, beta, next_player, original_player, game_phase);
+        }
+        // 첫 이동을 탐색하기 전에 시간이 다 됨 (futility는 첫 이동을 건너뛰지 않으므로 그 밖의 경우는 없음)
+        return evaluateBoard(board, original_player, game_phase);
     }
+    
+    // 시간 초과로 중단된 결과는 TT에 남기지 않음
+    if (!engine->time_limit_exceeded) {
+        char tt_flag = 'E';  // Exact
+        if (best_eval <= alpha_orig) tt_flag = 'U';       // Upper bound
+        else if (best_eval >= beta_orig) tt_flag = 'L';   // Lower bound
+        storeInTT(engine, hash, depth, best_eval, best_move, tt_flag);
+    }
+    return best_eval;
 }
 
 // 최고의 이동 찾기
 Move findBestMove(AIEngine *engine, const GameBoard *board, char player) {
-    engine->start_time = clock();
+    engine->start_time = engineClock();
     engine->time_limit_exceeded = 0;
     engine->nodes_searched = 0;
+    engine->completed_depth = 0;
     
     Move best_move;
     best_move.player = player;
     best_move.sourceRow = best_move.sourceCol = best_move.targetRow = best_move.targetCol = 0;
     
-    int best_value = NEG_INFINITY_VAL;
+    Move moves[256];
+    int move_count;
+    getAllValidMoves(board, player, moves, &move_count);
     
-    // Iterative Deepening
-    for (int depth = 1; depth <= MAX_DEPTH; depth++) {
-        if (isTimeUp(engine)) break;
-        
-        GameBoard temp_board;
-        memcpy(&temp_board, board, sizeof(GameBoard));
-        
-        Move moves[256];
-        int move_count;
-        getAllValidMoves(&temp_board, player, moves, &move_count);
-        
-        if (move_count == 0) {
-            // 패스
-            best_move.sourceRow = best_move.sourceCol = best_move.targetRow = best_move.targetCol = 0;
-            break;
+    if (move_count == 0) {
+        // 패스
+        return best_move;
+    }
+    
+    int current_game_phase = get_game_phase(board);
+    char opponent_player = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    unsigned long long root_hash = positionHash(board, player, player);
+
+    // 이전 탐색(폰더링 포함)이 남긴 루트 최선수를 맨 앞으로
+    TTEntry *root_entry = lookupTT(engine, root_hash);
+    if (root_entry) {
+        for (int i = 0; i < move_count; i++) {
+            if (sameResult(&moves[i], &root_entry->best_move)) {
+                Move tmp = moves[0];
+                moves[0] = moves[i];
+                moves[i] = tmp;
+                break;
+            }
         }
-        
-        Move current_best = { 0 };  
-        int current_best_value = NEG_INFINITY_VAL;
-        
-        int current_game_phase = get_game_phase(&temp_board);
+    }
 
-        // Try to prioritize a killer move
-        Move killer_m = findKillerMove(&temp_board, player); // findKillerMove is from winning_strategy.h
-        if (isValidMove(&temp_board, &killer_m)) { // Check if a valid killer move was found
+    // Try to prioritize a killer move (TT 최선수가 있거나 폰더링 중이면 생략)
+    if (!root_entry && !engine->pondering) {
+        Move killer_m = findKillerMove(board, player); // findKillerMove is from winning_strategy.h
+        if (isValidMove(board, &killer_m)) { // Check if a valid killer move was found
             // Search for the killer move in the general moves list and bring it to the front
             for (int k_idx = 0; k_idx < move_count; k_idx++) {
-                if (moves[k_idx].sourceRow == killer_m.sourceRow &&
-                    moves[k_idx].sourceCol == killer_m.sourceCol &&
-                    moves[k_idx].targetRow == killer_m.targetRow &&
-                    moves[k_idx].targetCol == killer_m.targetCol &&
-                    moves[k_idx].player == killer_m.player) {
-                    
+                if (sameMove(&moves[k_idx], &killer_m) && moves[k_idx].player == killer_m.player) {
                     // Swap killer_move to the front (moves[0])
                     if (k_idx > 0) {
                         Move temp_move_for_swap = moves[0];
@@ -691,17 +961,36 @@ Move findBestMove(AIEngine *engine, const GameBoard *board, char player) {
                 }
             }
         }
+    }
+    best_move = moves[0];
+    
+    // Iterative Deepening
+    for (int depth = 1; depth <= MAX_DEPTH; depth++) {
+        if (isTimeUp(engine)) break;
+        
+        Move current_best = moves[0];
+        int current_best_value = NEG_INFINITY_VAL;
         
+        // 첫 이동(직전 반복의 최선수)은 전체 윈도우, 나머지는 널 윈도우로 확인 후 재탐색
         for (int i = 0; i < move_count; i++) {
             if (isTimeUp(engine)) break;
             
             GameBoard move_board;
-            memcpy(&move_board, &temp_board, sizeof(GameBoard));
+            memcpy(&move_board, board, sizeof(GameBoard));
             applyMove(&move_board, &moves[i]);
             
-            char opponent_player = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER; // Renamed to avoid conflict
-            int value = minimax(engine, &move_board, depth - 1, NEG_INFINITY_VAL, INFINITY_VAL, 
-                              opponent_player, player, current_game_phase);
+            int value;
+            if (i == 0) {
+                value = minimax(engine, &move_board, depth - 1, NEG_INFINITY_VAL, INFINITY_VAL,
+                                opponent_player, player, current_game_phase);
+            } else {
+                value = minimax(engine, &move_board, depth - 1, current_best_value, current_best_value + 1,
+                                opponent_player, player, current_game_phase);
+                if (value > current_best_value) {
+                    value = minimax(engine, &move_board, depth - 1, current_best_value, INFINITY_VAL,
+                                    opponent_player, player, current_game_phase);
+                }
+            }
             
             if (value > current_best_value) {
                 current_best_value = value;
@@ -709,25 +998,258 @@ Move findBestMove(AIEngine *engine, const GameBoard *board, char player) {
             }
         }
         
-        if (!isTimeUp(engine) && current_best_value > best_value) {
-            best_value = current_best_value;
-            best_move = current_best;
+        if (isTimeUp(engine)) break;
+        
+        // 끝까지 탐색한 반복의 결과만 채택하고, 최선수를 다음 반복의 맨 앞으로
+        best_move = current_best;
+        engine->completed_depth = depth;
+        storeInTT(engine, root_hash, depth, current_best_value, current_best, 'E');
+        for (int i = 1; i < move_count; i++) {
+            if (sameMove(&moves[i], &current_best)) {
+                Move tmp = moves[0];
+                moves[0] = moves[i];
+                moves[i] = tmp;
+                break;
+            }
         }
     }
     return best_move;
 }
 
+// TT를 따라가며 주 변화(PV) 복원. 자식 노드는 minimax와 같은 키(둘 차례, player 관점)로 찾는다.
+static int extractPV(AIEngine *engine, const GameBoard *board, char player,
+                     Move first, Move *pv, int max_length) {
+    GameBoard walk;
+    memcpy(&walk, board, sizeof(GameBoard));
+    pv[0] = first;
+    applyMove(&walk, &first);
+    int length = 1;
+    char side = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+
+    while (length < max_length && !hasGameEnded(&walk)) {
+        if (!hasValidMove(&walk, side)) {
+            // 패스도 PV에 (0,0)->(0,0)으로 남김
+            Move pass = { 0 };
+            pass.player = side;
+            pv[length++] = pass;
+            side = (side == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+            continue;
+        }
+        TTEntry *entry = lookupTT(engine, positionHash(&walk, side, player));
+        if (!entry) break;
+        Move next = entry->best_move;
+        next.player = side;
+        if (!isValidMove(&walk, &next)) break;
+        if (next.sourceRow == 0 && next.sourceCol == 0 &&
+            next.targetRow == 0 && next.targetCol == 0) break;
+        applyMove(&walk, &next);
+        pv[length++] = next;
+        side = (side == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    }
+    return length;
+}
+
+// 분석 모드: 깊이마다 상위 multipv개 후보수와 점수, PV를 result에 채우고 callback 호출.
+// 각 루트 수를 "지금까지의 multipv번째 점수"를 alpha로 탐색하므로 상위 후보는 정확한 점수,
+// 나머지는 상한만 얻는다. time_limit <= 0이면 max_depth까지 제한 없이 탐색.
+// 반환값은 끝까지 탐색한 깊이.
+int analyzePosition(AIEngine *engine, const GameBoard *board, char player,
+                    int multipv, int max_depth, double time_limit,
+                    AnalysisCallback callback, void *user_data, AnalysisResult *result) {
+    double saved_limit = engine->time_limit;
+    engine->time_limit = (time_limit > 0) ? time_limit : 1e9;
+    engine->start_time = engineClock();
+    engine->time_limit_exceeded = 0;
+    engine->nodes_searched = 0;
+    engine->completed_depth = 0;
+
+    if (multipv < 1) multipv = 1;
+    if (multipv > MAX_MULTI_PV) multipv = MAX_MULTI_PV;
+    if (max_depth < 1 || max_depth > MAX_DEPTH) max_depth = MAX_DEPTH;
+    memset(result, 0, sizeof(AnalysisResult));
+
+    Move moves[256];
+    int scores[256];
+    int exact[256];
+    int move_count;
+    getAllValidMoves(board, player, moves, &move_count);
+    if (move_count == 0) goto DONE;
+    if (multipv > move_count) multipv = move_count;
+
+    int current_game_phase = get_game_phase(board);
+    char opponent_player = (player == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    unsigned long long root_hash = positionHash(board, player, player);
+
+    for (int depth = 1; depth <= max_depth; depth++) {
+        if (isTimeUp(engine)) break;
+
+        // top[]: 지금까지 정확한 점수를 얻은 상위 multipv개 (내림차순)
+        int top[MAX_MULTI_PV];
+        int top_count = 0;
+        int i;
+        for (i = 0; i < move_count; i++) {
+            if (isTimeUp(engine)) break;
+
+            int alpha = (top_count == multipv) ? top[multipv - 1] : NEG_INFINITY_VAL;
+            GameBoard move_board;
+            memcpy(&move_board, board, sizeof(GameBoard));
+            applyMove(&move_board, &moves[i]);
+            int value = minimax(engine, &move_board, depth - 1, alpha, INFINITY_VAL,
+                                opponent_player, player, current_game_phase);
+            scores[i] = value;
+            exact[i] = (value > alpha);
+            if (!exact[i]) continue;
+
+            int pos = (top_count < multipv) ? top_count++ : multipv - 1;
+            while (pos > 0 && top[pos - 1] < value) {
+                top[pos] = top[pos - 1];
+                pos--;
+            }
+            top[pos] = value;
+        }
+        if (i < move_count || isTimeUp(engine)) break;
+
+        // 정확한 점수 → 상한 순, 같은 종류끼리는 점수 내림차순 (안정 삽입 정렬)
+        for (int a = 1; a < move_count; a++) {
+            Move m = moves[a];
+            int sc = scores[a], ex = exact[a];
+            int b = a;
+            while (b > 0 && (exact[b - 1] < ex || (exact[b - 1] == ex && scores[b - 1] < sc))) {
+                moves[b] = moves[b - 1];
+                scores[b] = scores[b - 1];
+                exact[b] = exact[b - 1];
+                b--;
+            }
+            moves[b] = m;
+            scores[b] = sc;
+            exact[b] = ex;
+        }
+
+        engine->completed_depth = depth;
+        storeInTT(engine, root_hash, depth, scores[0], moves[0], 'E');
+
+        result->depth = depth;
+        result->nodes = engine->nodes_searched;
+        result->elapsed = engineClock() - engine->start_time;
+        result->line_count = multipv;
+        for (int k = 0; k < multipv; k++) {
+            AnalysisLine *line = &result->lines[k];
+            line->move = moves[k];
+            line->score = scores[k];
+            line->exact = exact[k];
+            line->pv_length = extractPV(engine, board, player, moves[k], line->pv, depth);
+        }
+        if (callback && callback(result, user_data)) break;
+    }
+
+DONE:
+    engine->time_limit = saved_limit;
+    return engine->completed_depth;
+}
+
+// 폰더링 시작: board는 상대 차례, me는 다음에 둘 내 색
+void startPonder(AIEngine *engine, const GameBoard *board, char me) {
+    PonderState *ponder = &engine->ponder;
+    ponder->phase = PONDER_PREDICT;
+    ponder->me = me;
+    ponder->opponent = (me == RED_PLAYER) ? BLUE_PLAYER : RED_PLAYER;
+    memcpy(&ponder->base_board, board, sizeof(GameBoard));
+    memcpy(&ponder->predicted_board, board, sizeof(GameBoard));
+    ponder->predict_elapsed = 0.0;
+    ponder->best_depth = 0;
+    memset(&ponder->predicted_reply, 0, sizeof(Move));
+    memset(&ponder->best_move, 0, sizeof(Move));
+}
+
+void stopPonder(AIEngine *engine) {
+    engine->ponder.phase = PONDER_IDLE;
+}
+
+// PONDER_SLICE만큼 탐색. 더 할 일이 남았으면 1, 쉬어도 되면 0.
+// 반복 심화는 매 조각마다 깊이 1부터 다시 시작하지만 TT가 남아 있어 금방 따라잡는다.
+int ponderStep(AIEngine *engine) {
+    PonderState *ponder = &engine->ponder;
+    if (ponder->phase != PONDER_PREDICT && ponder->phase != PONDER_SEARCH) return 0;
+
+    double saved_limit = engine->time_limit;
+    engine->time_limit = PONDER_SLICE;
+    if (ponder->phase == PONDER_PREDICT && PONDER_PREDICT_TIME - ponder->predict_elapsed < PONDER_SLICE) {
+        engine->time_limit = PONDER_PREDICT_TIME - ponder->predict_elapsed;
+    }
+    engine->pondering = 1;
+
+    if (ponder->phase == PONDER_PREDICT) {
+        // I/O 훅이 중간에 멈출 수 있으므로 실제로 쓴 시간만 더함
+        double started = engineClock();
+        Move reply = findBestMove(engine, &ponder->base_board, ponder->opponent);
+        ponder->predict_elapsed += engineClock() - started;
+        if (engine->completed_depth > 0) ponder->predicted_reply = reply;
+        if (engine->completed_depth >= PONDER_PREDICT_DEPTH ||
+            ponder->predict_elapsed >= PONDER_PREDICT_TIME) {
+            memcpy(&ponder->predicted_board, &ponder->base_board, sizeof(GameBoard));
+            if (isValidMove(&ponder->predicted_board, &ponder->predicted_reply) &&
+                !(ponder->predicted_reply.sourceRow == 0 && ponder->predicted_reply.sourceCol == 0 &&
+                  ponder->predicted_reply.targetRow == 0 && ponder->predicted_reply.targetCol == 0)) {
+                applyMove(&ponder->predicted_board, &ponder->predicted_reply);
+            }
+            ponder->phase = PONDER_SEARCH;
+        }
+    } else {
+        Move move = findBestMove(engine, &ponder->predicted_board, ponder->me);
+        if (engine->completed_depth >= ponder->best_depth && engine->completed_depth > 0) {
+            ponder->best_depth = engine->completed_depth;
+            ponder->best_move = move;
+        }
+        if (ponder->best_depth >= MAX_DEPTH) ponder->phase = PONDER_DONE;
+    }
+
+    engine->pondering = 0;
+    engine->time_limit = saved_limit;
+    return ponder->phase == PONDER_PREDICT || ponder->phase == PONDER_SEARCH;
+}
+
+// 실제 보드가 예측과 같고 충분히 깊게 봤으면 폰더링 결과를 바로 사용.
+// 빗나가도 TT는 데워져 있으므로 이어지는 탐색이 빨라진다.
+int ponderHit(AIEngine *engine, const GameBoard *board, char player, Move *move) {
+    PonderState *ponder = &engine->ponder;
+    int hit = 0;
+    if (ponder->phase != PONDER_IDLE && ponder->phase != PONDER_PREDICT &&
+        ponder->me == player && ponder->best_depth >= PONDER_MIN_HIT_DEPTH) {
+        hit = 1;
+        for (int r = 0; r < BOARD_SIZE && hit; r++) {
+            if (memcmp(board->cells[r], ponder->predicted_board.cells[r], BOARD_SIZE) != 0) hit = 0;
+        }
+        if (hit) {
+            *move = ponder->best_move;
+            hit = isValidMove(board, move);
+        }
+    }
+    ponder->phase = PONDER_IDLE;
+    return hit;
+}
+
 // 승리 보장 이동 생성 (메인 함수)
-Move generateWinningMove(const GameBoard *board, char player) {
+Move generateWinningMove(AIEngine *engine, const GameBoard *board, char player) {
     printf("=== 강력한 AI 엔진 시작 ===\n");
 
     // 오프닝 북 확인
     Move opening_move = checkOpeningBook(board, player);
     if (isValidMove(board, &opening_move)) {
         printf("오프닝 북 이동 사용!\n");
+        if (engine) stopPonder(engine);
         return opening_move;
     }
 
+    // 폰더링 적중 확인
+    Move pondered_move;
+    if (engine) {
+        int pondered_depth = engine->ponder.best_depth;
+        if (ponderHit(engine, board, player, &pondered_move)) {
+            printf("폰더링 적중! (깊이 %d) 즉시 이동\n", pondered_depth);
+            return pondered_move;
+        }
+    }
+
     // 종반이면 완전 계산 사용
     if (isEndgamePhase(board)) {
         printf("종반 단계 - 완전 계산 시작...\n");
@@ -736,18 +1258,17 @@ Move generateWinningMove(const GameBoard *board, char player) {
         return endgame_move;
     }
     
-    // 메인 AI 엔진 사용
+    // 메인 AI 엔진 사용 (폰더링으로 데워진 TT 재사용)
     printf("고급 AI 엔진 구동 중...\n");
-    AIEngine *engine = createAIEngine();
     if (!engine) {
         printf("AI 엔진 초기화 실패 - 기본 이동 사용\n");
         return generateMove(board);
     }
     
+    engine->time_limit = TIME_LIMIT;
     Move move = findBestMove(engine, board, player);
-    destroyAIEngine(engine);
+    printf("탐색 깊이: %d, 노드: %d\n", engine->completed_depth, engine->nodes_searched);
     
     printf("=== AI 엔진 최적해 선택 ===\n");
     return move;
 }
-
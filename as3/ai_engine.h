@@ -6,7 +6,7 @@
 #include <limits.h>
 #include <stdbool.h>
 // AI 설정 상수
-#define MAX_DEPTH 8
+#define MAX_DEPTH 16  // LMR/가지치기로 같은 시간에 더 깊이 탐색 가능
 #define TIME_LIMIT 2.5  // 4.5초 제한 (서버 5초 제한보다 여유)
 #define TRANSPOSITION_TABLE_SIZE 1000003  // 소수로 설정
 
@@ -61,6 +61,36 @@ extern short POSITION_WEIGHTS[BOARD_SIZE][BOARD_SIZE];
 #define STABILITY_WEIGHT_LATE 15
 #define POSITIONAL_WEIGHT_FACTOR_LATE 1
 
+// 탐색 가지치기 기본값 (SearchSettings로 엔진마다 조정 가능)
+// Late Move Reduction: 정렬상 뒤쪽 이동은 얕게 먼저 탐색
+#define LMR_MIN_DEPTH 3          // 남은 깊이가 이 이상일 때만 감축
+#define LMR_FULL_DEPTH_MOVES 3   // 앞쪽 N개 이동은 감축하지 않음
+#define LMR_REDUCTION 1          // 기본 감축 깊이
+#define LMR_LATE_MOVE_INDEX 10   // 이 순번 이후 이동은 1 더 감축
+// Futility Pruning: 프런티어 노드에서 가망 없는 이동 생략
+#define FUTILITY_MAX_DEPTH 2
+#define FUTILITY_MARGIN 400      // 깊이 1당 마진
+#define FUTILITY_FLIP_BONUS 60   // 뒤집는 말 1개당 기대 이득
+// Razoring: 정적 평가가 alpha보다 한참 낮으면 얕은 탐색으로 확인
+#define RAZOR_MAX_DEPTH 3
+#define RAZOR_MARGIN 600         // 깊이 1당 마진
+
+// 탐색 설정 (createAIEngine에서 위 기본값으로 초기화)
+typedef struct {
+    int lmr_enabled;
+    int lmr_min_depth;
+    int lmr_full_depth_moves;
+    int lmr_reduction;
+    int lmr_late_move_index;
+    int futility_enabled;
+    int futility_max_depth;
+    int futility_margin;
+    int futility_flip_bonus;
+    int razoring_enabled;
+    int razor_max_depth;
+    int razor_margin;
+} SearchSettings;
+
 // Transposition Table 엔트리
 typedef struct {
     unsigned long long hash;
@@ -70,18 +100,110 @@ typedef struct {
     char flag;  // 'E' = exact, 'L' = lower bound, 'U' = upper bound
 } TTEntry;
 
+// 단계별 이동 생성기 단계: TT 이동 → 상대 말을 뒤집는 이동 → 나머지
+typedef enum {
+    PICK_TT_MOVE,
+    PICK_GEN_CAPTURES,
+    PICK_CAPTURES,
+    PICK_GEN_QUIETS,
+    PICK_QUIETS,
+    PICK_DONE
+} PickStage;
+
+// 단계별(지연) 이동 생성기. 컷오프가 나면 이후 단계는 생성하지 않는다.
+typedef struct {
+    const GameBoard *board;
+    char player;
+    PickStage stage;
+    Move tt_move;
+    int has_tt_move;
+    Move moves[256];
+    int scores[256];
+    int flips[256];
+    int count;
+    int index;
+    int yielded;     // 지금까지 내준 이동 수 (0이면 패스)
+} MovePicker;
+
+// 폰더링 (상대 차례에 미리 탐색) 설정
+#define PONDER_SLICE 1.0          // 한 번에 탐색할 시간(초). 메시지가 오면 I/O 훅이 바로 멈춘다
+#define PONDER_PREDICT_TIME 0.5   // 상대 응수 예측에 쓸 최대 시간(초)
+#define PONDER_PREDICT_DEPTH 6    // 이 깊이까지 보면 예측 확정
+#define PONDER_MIN_HIT_DEPTH 7    // 예측 적중 시 바로 둘 수 있는 최소 깊이
+
+typedef enum {
+    PONDER_IDLE,
+    PONDER_PREDICT,   // 상대의 최선 응수 예측 중
+    PONDER_SEARCH,    // 예측 응수 이후 보드에서 내 최선수 탐색 중
+    PONDER_DONE       // MAX_DEPTH까지 탐색 완료
+} PonderPhase;
+
+typedef struct {
+    PonderPhase phase;
+    char me;
+    char opponent;
+    GameBoard base_board;        // 상대 차례 보드
+    GameBoard predicted_board;   // 예측 응수 후 보드 (내 차례)
+    Move predicted_reply;
+    double predict_elapsed;
+    Move best_move;              // predicted_board에서의 내 최선수
+    int best_depth;
+} PonderState;
+
+// 분석 모드 (여러 후보수와 주 변화 출력)
+#define MAX_MULTI_PV 8            // 한 번에 보고할 수 있는 최대 후보수
+#define MAX_PV_LENGTH MAX_DEPTH   // 주 변화(PV) 최대 길이
+
+// 후보수 하나: 점수는 둘 차례(player) 관점
+typedef struct {
+    Move move;
+    int score;
+    int exact;                    // 0이면 score는 상한 (다른 후보보다 나쁨만 확인)
+    Move pv[MAX_PV_LENGTH];       // pv[0] == move
+    int pv_length;
+} AnalysisLine;
+
+// 반복 심화 한 깊이를 끝낼 때마다 채워지는 결과
+typedef struct {
+    int depth;
+    int nodes;
+    double elapsed;               // 초
+    int line_count;
+    AnalysisLine lines[MAX_MULTI_PV];  // 점수 내림차순
+} AnalysisResult;
+
+// 깊이마다 호출되는 콜백. 0이 아닌 값을 돌려주면 분석 중단.
+typedef int (*AnalysisCallback)(const AnalysisResult *result, void *user_data);
+
+// 탐색 중 IO_HOOK_INTERVAL마다 불리는 훅 (소켓 처리 등). 0이 아닌 값을 돌려주면 탐색을 멈춘다
+typedef int (*EngineIOHook)(void *user_data);
+#define IO_HOOK_INTERVAL 0.005    // 초
+
 // AI 엔진 구조체
 typedef struct {
     TTEntry *transposition_table;
     int nodes_searched;
-    clock_t start_time;
+    double start_time;        // 탐색 시작 시각 (engineClock, 초)
+    double time_limit;        // 탐색 시간 제한(초), 기본 TIME_LIMIT
     int time_limit_exceeded;
+    int completed_depth;      // 마지막으로 끝까지 탐색한 반복 심화 깊이
+    int pondering;            // 폰더링 중 (로그 생략)
+    SearchSettings settings;
+    PonderState ponder;
+    EngineIOHook io_hook;     // 없으면 NULL
+    void *io_hook_data;
+    double next_io_check;     // 다음 훅 호출 시각 (engineClock)
 } AIEngine;
 
 // 함수 선언
 AIEngine* createAIEngine();
 void destroyAIEngine(AIEngine *engine);
+void setEngineIOHook(AIEngine *engine, EngineIOHook hook, void *user_data);
+void initSearchSettings(SearchSettings *settings);
 Move findBestMove(AIEngine *engine, const GameBoard *board, char player);
+int analyzePosition(AIEngine *engine, const GameBoard *board, char player,
+                    int multipv, int max_depth, double time_limit,
+                    AnalysisCallback callback, void *user_data, AnalysisResult *result);
 int minimax(AIEngine *engine, GameBoard *board, int depth, int alpha, int beta, 
            char maximizing_player, char original_player, int game_phase);
 int evaluateBoard(const GameBoard *board, char player, int game_phase);
@@ -94,8 +216,16 @@ int getStability(const GameBoard *board, char player);
 bool isCorner(int row, int col);
 int isEdge(int row, int col);
 void getAllValidMoves(const GameBoard *board, char player, Move *moves, int *count);
+int isCloneMove(const Move *move);
+void initMovePicker(MovePicker *picker, const GameBoard *board, char player, const Move *tt_move);
+int nextMove(MovePicker *picker, Move *move, int *flips);
+double engineClock(void);
 int isTimeUp(AIEngine *engine);
 // int get_game_phase(const GameBoard *board); // Prototype removed, function moved inline
-Move generateWinningMove(const GameBoard *board, char player);
+Move generateWinningMove(AIEngine *engine, const GameBoard *board, char player);
+void startPonder(AIEngine *engine, const GameBoard *board, char me);
+int ponderStep(AIEngine *engine);
+void stopPonder(AIEngine *engine);
+int ponderHit(AIEngine *engine, const GameBoard *board, char player, Move *move);
 
 #endif /* AI_ENGINE_H */
\ No newline at end of file
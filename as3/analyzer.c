@@ -0,0 +1,106 @@
+// 오프라인 분석기: 표준 입력으로 보드 8줄을 받아 깊이마다 상위 후보수와 PV 출력
+// 사용 예) ./analyzer -player R -multipv 3 -depth 10 -time 5 < board.txt
+#include "board.h"
+#include "ai_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void printMove(const Move *move) {
+    if (move->sourceRow == 0 && move->sourceCol == 0 &&
+        move->targetRow == 0 && move->targetCol == 0) {
+        printf("pass");
+        return;
+    }
+    // 프로토콜과 같은 1부터 시작하는 좌표
+    printf("(%d,%d)->(%d,%d)", move->sourceRow + 1, move->sourceCol + 1,
+           move->targetRow + 1, move->targetCol + 1);
+}
+
+static int printDepth(const AnalysisResult *result, void *user_data) {
+    (void)user_data;
+    printf("depth %d  nodes %d  time %.2fs\n", result->depth, result->nodes, result->elapsed);
+    for (int k = 0; k < result->line_count; k++) {
+        const AnalysisLine *line = &result->lines[k];
+        printf("  %d. %c%6d  ", k + 1, line->exact ? ' ' : '<', line->score);
+        for (int i = 0; i < line->pv_length; i++) {
+            if (i > 0) printf(" ");
+            printMove(&line->pv[i]);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    char player = RED_PLAYER;
+    int multipv = 3;
+    int max_depth = MAX_DEPTH;
+    double time_limit = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-player") == 0 && i + 1 < argc) {
+            player = argv[++i][0];
+        } else if (strcmp(argv[i], "-multipv") == 0 && i + 1 < argc) {
+            multipv = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-depth") == 0 && i + 1 < argc) {
+            max_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-time") == 0 && i + 1 < argc) {
+            time_limit = atof(argv[++i]);
+        } else {
+            printf("사용법: %s [-player R|B] [-multipv <개수>] [-depth <깊이>] [-time <초, 0이면 무제한>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (player != RED_PLAYER && player != BLUE_PLAYER) {
+        printf("플레이어는 R 또는 B\n");
+        return 1;
+    }
+
+    // board_alone과 같은 입력 형식
+    GameBoard board;
+    memset(&board, 0, sizeof(GameBoard));
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        if (scanf("%8s", board.cells[i]) != 1) {
+            printf("Invalid input\n");
+            return 0;
+        }
+        int count = 0;
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            char c = board.cells[i][j];
+            if (c == RED_PLAYER || c == BLUE_PLAYER || c == EMPTY_CELL || c == BLOCKED_CELL) {
+                count++;
+            }
+        }
+        if (count != BOARD_SIZE) {
+            printf("Board input error\n");
+            return 0;
+        }
+    }
+    board.currentPlayer = player;
+    countPieces(&board);
+
+    AIEngine *engine = createAIEngine();
+    if (!engine) {
+        printf("AI 엔진 초기화 실패\n");
+        return 1;
+    }
+
+    AnalysisResult result;
+    int depth = analyzePosition(engine, &board, player, multipv, max_depth, time_limit,
+                                printDepth, NULL, &result);
+    if (depth == 0 && !hasValidMove(&board, player)) {
+        printf("둘 수 있는 수가 없습니다 (pass)\n");
+    } else if (depth == 0) {
+        // 둘 수는 있는데 깊이 1도 끝내기 전에 시간이 다 됨
+        printf("제한 시간(-time %g초) 안에 완료한 깊이가 없습니다. -time을 늘려 보세요\n", time_limit);
+    } else {
+        printf("bestmove ");
+        printMove(&result.lines[0].move);
+        printf("\n");
+    }
+
+    destroyAIEngine(engine);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef BOARD_DELTA_H
+#define BOARD_DELTA_H
+
+#include <stdint.h>
+#include "msg_decoder.h"
+
+// register / register_ack의 capabilities "delta"로 협상하는 보드 델타 모드.
+// your_turn / move_ok / invalid_move에 보드 전체 대신 직전 수와 그 수로 뒤집힌 칸만 보낸다.
+// 메시지마다 적용 후 보드의 seq(그 대국에서 적용된 수의 개수)와 해시가 붙고,
+// 받는 쪽은 applyMove로 직접 적용한 뒤 뒤집힌 칸과 해시로 확인한다.
+// 대국의 첫 메시지, DELTA_SNAPSHOT_INTERVAL번째 델타마다, 그리고 invalid_move에는 보드 전체(스냅샷)를
+// 보내므로 한 번 어긋나도 곧 다시 맞춰진다.
+//
+// JSON 필드 (board 자리에 들어감):
+//   스냅샷     "board":[...],"seq":N,"hash":"..."
+//   수 하나    "seq":N,"sx":..,"sy":..,"tx":..,"ty":..,"flipped":"...","hash":"..."
+//   그대로     "seq":N,"hash":"..."
+// 마스크와 해시는 16진 문자열 (최대 16자리, 비트 = 행*8+열), 좌표는 move 메시지와 같이 1부터 시작.
+
+#define DELTA_SNAPSHOT_INTERVAL 16
+
+typedef enum {
+    BOARD_UPDATE_FULL = 0,      // 보드 전체만 (델타 모드가 아닌 연결)
+    BOARD_UPDATE_SNAPSHOT,      // 보드 전체 + seq, hash
+    BOARD_UPDATE_MOVE,          // 직전 수 하나 + 뒤집힌 칸
+    BOARD_UPDATE_SAME           // 마지막으로 보낸 뒤 바뀌지 않음 (seq, hash만)
+} BoardUpdateKind;
+
+// 보내는 쪽이 메시지 하나에 실을 보드 정보 (NULL이면 BOARD_UPDATE_FULL과 같음)
+typedef struct {
+    BoardUpdateKind kind;
+    uint32_t seq;
+    uint64_t hash;
+    Move move;                  // BOARD_UPDATE_MOVE: 1부터 시작하는 좌표
+    uint64_t flipped;           // BOARD_UPDATE_MOVE: 상대 말에서 뒤집힌 칸
+} BoardDelta;
+
+// 빨강/파랑/막힌 칸 비트 마스크
+void board_masks(const GameBoard *board, uint64_t *red, uint64_t *blue, uint64_t *blocked);
+// 말 배치(빨강, 파랑)에 대한 64비트 해시
+uint64_t board_hash(const GameBoard *board);
+// before → after 사이에 상대 말에서 player 말로 바뀐 칸
+uint64_t board_flipped(const GameBoard *before, const GameBoard *after, char player);
+
+// 받는 쪽 보드 동기화 상태 (대국마다 board_view_reset)
+typedef struct {
+    uint32_t seq;
+    int synced;                 // 서버와 seq가 맞음 (아니면 다음 스냅샷까지 델타를 적용하지 않음)
+} BoardView;
+
+void board_view_reset(BoardView *view);
+
+// 메시지의 보드 정보(전체 보드, 스냅샷, 델타)를 board에 반영. 보드 정보가 있었으면 1, 없으면 0.
+// 델타가 맞지 않으면(seq 건너뜀, 뒤집힌 칸이나 해시 불일치) 경고를 찍고 다음 스냅샷을 기다린다
+int board_view_update(BoardView *view, GameBoard *board, const DecodedMessage *message);
+
+#endif /* BOARD_DELTA_H */
@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include <string.h>
+#include "framer.h"
+
+int framer_init(LineFramer *framer, size_t max_frame) {
+    memset(framer, 0, sizeof(LineFramer));
+    if (max_frame == 0) max_frame = FRAMER_DEFAULT_MAX_FRAME;
+    size_t capacity = 64;
+    while (capacity < max_frame * 2) capacity *= 2;
+
+    framer->data = (char*)malloc(capacity + max_frame + 1);
+    if (!framer->data) return -1;
+    framer->capacity = capacity;
+    framer->max_frame = max_frame;
+    return 0;
+}
+
+void framer_destroy(LineFramer *framer) {
+    free(framer->data);
+    memset(framer, 0, sizeof(LineFramer));
+}
+
+char* framer_write_space(LineFramer *framer, size_t *space) {
+    size_t tail = (framer->head + framer->length) & (framer->capacity - 1);
+    size_t free_bytes = framer->capacity - framer->length - framer->reserved;
+    size_t until_end = framer->capacity - tail;
+    *space = (free_bytes < until_end) ? free_bytes : until_end;
+    return framer->data + tail;
+}
+
+void framer_commit(LineFramer *framer, size_t len) {
+    framer->length += len;
+}
+
+size_t framer_append(LineFramer *framer, const char *data, size_t len) {
+    size_t copied = 0;
+    while (copied < len) {
+        size_t space;
+        char *dst = framer_write_space(framer, &space);
+        if (space == 0) break;
+        if (space > len - copied) space = len - copied;
+        memcpy(dst, data + copied, space);
+        framer_commit(framer, space);
+        copied += space;
+    }
+    return copied;
+}
+
+// head부터 offset..length 범위에서 첫 개행 위치 (head 기준 거리), 없으면 -1
+static long find_newline(const LineFramer *framer, size_t offset) {
+    while (offset < framer->length) {
+        size_t pos = (framer->head + offset) & (framer->capacity - 1);
+        size_t run = framer->capacity - pos;
+        if (run > framer->length - offset) run = framer->length - offset;
+        const char *hit = (const char*)memchr(framer->data + pos, '\n', run);
+        if (hit) return (long)(offset + (size_t)(hit - (framer->data + pos)));
+        offset += run;
+    }
+    return -1;
+}
+
+static void consume(LineFramer *framer, size_t len) {
+    framer->head = (framer->head + len) & (framer->capacity - 1);
+    framer->length -= len;
+    framer->scanned = 0;
+}
+
+void framer_set_binary(LineFramer *framer) {
+    framer->binary = 1;
+    framer->scanned = 0;
+    framer->discarding = 0;
+}
+
+// 바이너리 프레임 본문 길이 (헤더가 아직 다 안 왔으면 -1)
+static long binary_frame_length(const LineFramer *framer) {
+    if (framer->length < 2) return -1;
+    unsigned char high = (unsigned char)framer->data[framer->head];
+    unsigned char low = (unsigned char)framer->data[(framer->head + 1) & (framer->capacity - 1)];
+    return ((long)high << 8) | low;
+}
+
+static int binary_next(LineFramer *framer, char **frame, size_t *len) {
+    long frame_len = binary_frame_length(framer);
+    if (frame_len < 0) return 0;
+    if ((size_t)frame_len > framer->max_frame) return -1;
+    if (framer->length < 2 + (size_t)frame_len) return 0;
+
+    size_t start = (framer->head + 2) & (framer->capacity - 1);
+    if (start + (size_t)frame_len > framer->capacity) {
+        // 링 끝에서 돌아 나온 프레임: 앞부분을 꼬리 공간에 이어 붙임
+        memcpy(framer->data + framer->capacity, framer->data, start + (size_t)frame_len - framer->capacity);
+    }
+    consume(framer, 2 + (size_t)frame_len);
+    framer->reserved = 2 + (size_t)frame_len;
+
+    *frame = framer->data + start;
+    *len = (size_t)frame_len;
+    return 1;
+}
+
+int framer_has_frame(LineFramer *framer) {
+    if (framer->binary) {
+        long frame_len = binary_frame_length(framer);
+        if (frame_len < 0) return 0;
+        // 길이 초과는 본문을 기다리지 않고 바로 알림 (framer_next가 -1)
+        return (size_t)frame_len > framer->max_frame || framer->length >= 2 + (size_t)frame_len;
+    }
+    long newline = find_newline(framer, framer->scanned);
+    if (newline < 0) {
+        framer->scanned = framer->length;
+        // 개행 없이 한계를 넘은 줄도 framer_next가 -1로 알릴 것이 있음 (이미 알린 줄의 나머지는 제외)
+        return !framer->discarding && framer->length > framer->max_frame;
+    }
+    framer->scanned = (size_t)newline;
+    return 1;
+}
+
+int framer_next(LineFramer *framer, char **line, size_t *len) {
+    // 지난번에 돌려준 줄은 이제 덮어써도 됨
+    framer->reserved = 0;
+    // 비었으면 처음부터 채워서 다음 줄이 링 끝에서 잘리지 않게
+    if (framer->length == 0) framer->head = 0;
+    if (framer->binary) return binary_next(framer, line, len);
+
+    for (;;) {
+        long newline = find_newline(framer, framer->scanned);
+        if (newline < 0) {
+            framer->scanned = framer->length;
+            // 개행 없이 한계를 넘으면 지금까지 받은 것을 버리고 다음 개행까지 계속 버림
+            if (framer->length > framer->max_frame) {
+                int reported = framer->discarding;
+                framer->discarding = 1;
+                consume(framer, framer->length);
+                if (!reported) return -1;
+            }
+            return 0;
+        }
+
+        size_t frame_len = (size_t)newline;
+        if (framer->discarding) {
+            // 너무 긴 줄의 나머지 부분
+            framer->discarding = 0;
+            consume(framer, frame_len + 1);
+            continue;
+        }
+        if (frame_len > framer->max_frame) {
+            consume(framer, frame_len + 1);
+            return -1;
+        }
+
+        char *start = framer->data + framer->head;
+        size_t first = framer->capacity - framer->head;
+        if (frame_len + 1 > first) {
+            // 링 끝에서 돌아 나온 줄: 앞부분을 꼬리 공간에 이어 붙임 (max_frame 이내)
+            memcpy(framer->data + framer->capacity, framer->data, frame_len + 1 - first);
+        }
+        start[frame_len] = '\0';
+        consume(framer, frame_len + 1);
+        framer->reserved = frame_len + 1;
+
+        *line = start;
+        *len = frame_len;
+        return 1;
+    }
+}
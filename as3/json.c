@@ -1,4 +1,5 @@
 #include "json.h"
+#include "json_scan.h"
 
 /**
  * JSON 라이브러리
@@ -12,118 +13,318 @@
  * - JSON 문자열로 변환 (stringify)
  * - JSON 문자열 파싱 (parse)
  * - 메모리 관리 (할당 및 해제)
+ *
+ * 기본은 값마다 malloc/free 하지만, json_use_arena로 아레나를 지정하면
+ * 그동안 만든 트리는 아레나에서 범프 할당되고 json_free는 아무것도 하지 않는다.
+ * 트리 전체는 json_arena_reset 한 번으로 회수된다.
+ * (한 트리 안에서 힙 값과 아레나 값을 섞으면 안 됨)
  */
 
+#define JSON_ARENA_ALIGN 8
+#define JSON_OBJECT_LINEAR_MAX 8    // 이 크기까지는 해시 색인 없이 선형 검색
+
+struct JsonArenaChunk {
+    JsonArenaChunk *next;
+    size_t capacity;
+    size_t used;
+    char data[];
+};
+
+// 스레드마다 따로 (서버 샤드 스레드가 각자 아레나를 씀)
+static __thread JsonArena *current_arena = NULL;
+
+void json_arena_init(JsonArena *arena, size_t chunk_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : JSON_ARENA_CHUNK_SIZE;
+}
+
+// 청크는 해제하지 않고 처음부터 다시 씀. 뒤쪽 청크는 넘어갈 때 비움
+void json_arena_reset(JsonArena *arena) {
+    arena->current = arena->first;
+    if (arena->current) {
+        arena->current->used = 0;
+    }
+}
+
+void json_arena_destroy(JsonArena *arena) {
+    JsonArenaChunk *chunk = arena->first;
+    while (chunk) {
+        JsonArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+JsonArena* json_use_arena(JsonArena *arena) {
+    JsonArena *previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+static void* arena_alloc(JsonArena *arena, size_t size) {
+    size = (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+
+    JsonArenaChunk *chunk = arena->current;
+    if (chunk && chunk->capacity - chunk->used >= size) {
+        void *ptr = chunk->data + chunk->used;
+        chunk->used += size;
+        return ptr;
+    }
+
+    // 리셋 이전에 쓰던 다음 청크들을 재사용
+    while (chunk && chunk->next) {
+        chunk = chunk->next;
+        chunk->used = 0;
+        if (chunk->capacity >= size) {
+            arena->current = chunk;
+            chunk->used = size;
+            return chunk->data;
+        }
+    }
+
+    size_t capacity = (size > arena->chunk_size) ? size : arena->chunk_size;
+    JsonArenaChunk *fresh = (JsonArenaChunk*)malloc(sizeof(JsonArenaChunk) + capacity);
+    if (!fresh) {
+        return NULL;
+    }
+    fresh->next = NULL;
+    fresh->capacity = capacity;
+    fresh->used = size;
+    if (chunk) {
+        chunk->next = fresh;
+    } else {
+        arena->first = fresh;
+    }
+    arena->current = fresh;
+    return fresh->data;
+}
+
+// 아레나 트리에 속한 메모리는 아레나에서, 아니면 malloc
+static void* json_alloc(int in_arena, size_t size) {
+    if (in_arena) {
+        return current_arena ? arena_alloc(current_arena, size) : NULL;
+    }
+    return malloc(size);
+}
+
+// 벡터 확장. 아레나에는 realloc이 없으므로 새로 받아 복사 (이전 블록은 리셋 때 회수)
+static void* json_grow(int in_arena, void *ptr, size_t old_size, size_t new_size) {
+    if (!in_arena) {
+        return realloc(ptr, new_size);
+    }
+    void *fresh = json_alloc(in_arena, new_size);
+    if (fresh && old_size > 0) {
+        memcpy(fresh, ptr, old_size);
+    }
+    return fresh;
+}
+
+static void json_release(int in_arena, void *ptr) {
+    if (!in_arena) {
+        free(ptr);
+    }
+}
+
+static char* json_strdup(int in_arena, const char *string) {
+    size_t length = strlen(string) + 1;
+    char *copy = (char*)json_alloc(in_arena, length);
+    if (copy) {
+        memcpy(copy, string, length);
+    }
+    return copy;
+}
+
+static JsonValue* json_new(JsonType type) {
+    int in_arena = (current_arena != NULL);
+    JsonValue *value = (JsonValue*)json_alloc(in_arena, sizeof(JsonValue));
+    if (value) {
+        value->type = type;
+        value->in_arena = in_arena;
+        memset(&value->value, 0, sizeof(value->value));
+    }
+    return value;
+}
+
 /**
  * JSON null 값 생성 함수
  * 
  * @return 새로 생성된 JSON null 값
  */
 JsonValue* json_null() {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
-    if (value) {
-        value->type = JSON_NULL;
-    }
-    return value;
+    return json_new(JSON_NULL);
 }
 
 JsonValue* json_boolean(int boolean) {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
+    JsonValue *value = json_new(JSON_BOOLEAN);
     if (value) {
-        value->type = JSON_BOOLEAN;
         value->value.boolean = boolean;
     }
     return value;
 }
 
 JsonValue* json_number(double number) {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
+    JsonValue *value = json_new(JSON_NUMBER);
     if (value) {
-        value->type = JSON_NUMBER;
         value->value.number = number;
     }
     return value;
 }
 
 JsonValue* json_string(const char *string) {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
+    JsonValue *value = json_new(JSON_STRING);
     if (value) {
-        value->type = JSON_STRING;
-        value->value.string = strdup(string);
+        value->value.string = json_strdup(value->in_arena, string);
     }
     return value;
 }
 
 JsonValue* json_array() {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
-    if (value) {
-        value->type = JSON_ARRAY;
-        value->value.array = NULL;
-    }
-    return value;
+    return json_new(JSON_ARRAY);
 }
 
 JsonValue* json_object() {
-    JsonValue *value = (JsonValue*)malloc(sizeof(JsonValue));
-    if (value) {
-        value->type = JSON_OBJECT;
-        value->value.object = NULL;
-    }
-    return value;
+    return json_new(JSON_OBJECT);
 }
 
-// JSON 배열에 값 추가
+// JSON 배열에 값 추가 (용량을 두 배씩 늘리므로 평균 O(1))
 void json_array_append(JsonValue *array, JsonValue *value) {
     if (!array || array->type != JSON_ARRAY || !value) {
         return;
     }
     
-    JsonArrayItem *new_item = (JsonArrayItem*)malloc(sizeof(JsonArrayItem));
-    if (!new_item) {
+    JsonArrayData *data = &array->value.array;
+    if (data->size == data->capacity) {
+        size_t capacity = data->capacity ? data->capacity * 2 : 4;
+        JsonValue **items = (JsonValue**)json_grow(array->in_arena, data->items,
+                                                   data->size * sizeof(JsonValue*),
+                                                   capacity * sizeof(JsonValue*));
+        if (!items) {
+            return;
+        }
+        data->items = items;
+        data->capacity = capacity;
+    }
+    data->items[data->size++] = value;
+}
+
+// 객체 키 해시 (FNV-1a)
+static unsigned int json_hash(const char *key) {
+    unsigned int hash = 2166136261u;
+    while (*key) {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void object_index_insert(JsonObjectData *data, size_t item) {
+    size_t mask = data->index_capacity - 1;
+    size_t slot = data->items[item].hash & mask;
+    while (data->index[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    data->index[slot] = (unsigned int)(item + 1);
+}
+
+// 색인을 새 크기로 다시 만듦. 실패하면 색인을 버리고 선형 검색으로 돌아감
+static void object_index_rebuild(JsonValue *object, size_t capacity) {
+    JsonObjectData *data = &object->value.object;
+    json_release(object->in_arena, data->index);
+    data->index = (unsigned int*)json_alloc(object->in_arena, capacity * sizeof(unsigned int));
+    if (!data->index) {
+        data->index_capacity = 0;
         return;
     }
+    memset(data->index, 0, capacity * sizeof(unsigned int));
+    data->index_capacity = capacity;
+    for (size_t i = 0; i < data->size; i++) {
+        object_index_insert(data, i);
+    }
+}
+
+// 키 위치 검색 (없으면 -1)
+static long object_find(const JsonObjectData *data, const char *key, unsigned int hash) {
+    if (!data->index) {
+        for (size_t i = 0; i < data->size; i++) {
+            if (data->items[i].hash == hash && strcmp(data->items[i].key, key) == 0) {
+                return (long)i;
+            }
+        }
+        return -1;
+    }
     
-    new_item->value = value;
-    new_item->next = NULL;
-    
-    if (!array->value.array) {
-        array->value.array = new_item;
-    } else {
-        JsonArrayItem *item = array->value.array;
-        while (item->next) {
-            item = item->next;
+    size_t mask = data->index_capacity - 1;
+    size_t slot = hash & mask;
+    while (data->index[slot]) {
+        const JsonObjectItem *item = &data->items[data->index[slot] - 1];
+        if (item->hash == hash && strcmp(item->key, key) == 0) {
+            return (long)(data->index[slot] - 1);
         }
-        item->next = new_item;
+        slot = (slot + 1) & mask;
     }
+    return -1;
 }
 
-// JSON 객체에 키-값 쌍 설정
-void json_object_set(JsonValue *object, const char *key, JsonValue *value) {
-    if (!object || object->type != JSON_OBJECT || !key || !value) {
+// 키의 소유권을 넘겨받아 객체에 설정 (파서는 복사 없이 바로 넘김)
+static void object_set_owned(JsonValue *object, char *key, JsonValue *value) {
+    JsonObjectData *data = &object->value.object;
+    unsigned int hash = json_hash(key);
+    
+    // 기존 키가 있으면 값만 교체
+    long found = object_find(data, key, hash);
+    if (found >= 0) {
+        json_release(object->in_arena, key);
+        json_free(data->items[found].value);
+        data->items[found].value = value;
         return;
     }
     
-    // 기존 키가 있는지 확인
-    JsonObjectItem *item = object->value.object;
-    while (item) {
-        if (strcmp(item->key, key) == 0) {
-            json_free(item->value);
-            item->value = value;
+    // 새 항목 추가
+    if (data->size == data->capacity) {
+        size_t capacity = data->capacity ? data->capacity * 2 : 4;
+        JsonObjectItem *items = (JsonObjectItem*)json_grow(object->in_arena, data->items,
+                                                           data->size * sizeof(JsonObjectItem),
+                                                           capacity * sizeof(JsonObjectItem));
+        if (!items) {
+            json_release(object->in_arena, key);
             return;
         }
-        item = item->next;
+        data->items = items;
+        data->capacity = capacity;
+    }
+    data->items[data->size].key = key;
+    data->items[data->size].value = value;
+    data->items[data->size].hash = hash;
+    data->size++;
+    
+    // 작은 객체는 선형 검색이 더 빠름. 커지면 적재율 1/2 이하로 색인 유지
+    if (data->size > JSON_OBJECT_LINEAR_MAX) {
+        if (data->size * 2 > data->index_capacity) {
+            size_t capacity = 16;
+            while (capacity < data->size * 4) {
+                capacity *= 2;
+            }
+            object_index_rebuild(object, capacity);
+        } else {
+            object_index_insert(data, data->size - 1);
+        }
     }
-    
-    // 새 항목 추가
-    JsonObjectItem *new_item = (JsonObjectItem*)malloc(sizeof(JsonObjectItem));
-    if (!new_item) {
+}
+
+// JSON 객체에 키-값 쌍 설정
+void json_object_set(JsonValue *object, const char *key, JsonValue *value) {
+    if (!object || object->type != JSON_OBJECT || !key || !value) {
         return;
     }
     
-    new_item->key = strdup(key);
-    new_item->value = value;
-    new_item->next = object->value.object;
-    object->value.object = new_item;
+    char *copy = json_strdup(object->in_arena, key);
+    if (!copy) {
+        return;
+    }
+    object_set_owned(object, copy, value);
 }
 
 // JSON 타입 확인 함수
@@ -170,32 +371,18 @@ JsonValue* json_object_get(const JsonValue *object, const char *key) {
         return NULL;
     }
     
-    JsonObjectItem *item = object->value.object;
-    while (item) {
-        if (strcmp(item->key, key) == 0) {
-            return item->value;
-        }
-        item = item->next;
-    }
-    
-    return NULL;
+    const JsonObjectData *data = &object->value.object;
+    long found = object_find(data, key, json_hash(key));
+    return (found >= 0) ? data->items[found].value : NULL;
 }
 
 // JSON 배열 인덱스 접근
 JsonValue* json_array_get(const JsonValue *array, size_t index) {
-    if (!array || array->type != JSON_ARRAY) {
+    if (!array || array->type != JSON_ARRAY || index >= array->value.array.size) {
         return NULL;
     }
     
-    JsonArrayItem *item = array->value.array;
-    size_t current = 0;
-    
-    while (item && current < index) {
-        item = item->next;
-        current++;
-    }
-    
-    return (item) ? item->value : NULL;
+    return array->value.array.items[index];
 }
 
 // JSON 배열 크기 확인
@@ -204,20 +391,38 @@ size_t json_array_size(const JsonValue *array) {
         return 0;
     }
     
-    size_t size = 0;
-    JsonArrayItem *item = array->value.array;
+    return array->value.array.size;
+}
+
+// JSON 객체 순회
+size_t json_object_size(const JsonValue *object) {
+    if (!object || object->type != JSON_OBJECT) {
+        return 0;
+    }
+    
+    return object->value.object.size;
+}
+
+const char* json_object_key(const JsonValue *object, size_t index) {
+    if (!object || object->type != JSON_OBJECT || index >= object->value.object.size) {
+        return NULL;
+    }
     
-    while (item) {
-        size++;
-        item = item->next;
+    return object->value.object.items[index].key;
+}
+
+JsonValue* json_object_value(const JsonValue *object, size_t index) {
+    if (!object || object->type != JSON_OBJECT || index >= object->value.object.size) {
+        return NULL;
     }
     
-    return size;
+    return object->value.object.items[index].value;
 }
 
 // JSON 메모리 해제
 void json_free(JsonValue *value) {
-    if (!value) {
+    // 아레나 트리는 json_arena_reset에서 통째로 회수
+    if (!value || value->in_arena) {
         return;
     }
     
@@ -227,25 +432,22 @@ void json_free(JsonValue *value) {
             break;
         
         case JSON_ARRAY: {
-            JsonArrayItem *item = value->value.array;
-            while (item) {
-                JsonArrayItem *next = item->next;
-                json_free(item->value);
-                free(item);
-                item = next;
+            JsonArrayData *data = &value->value.array;
+            for (size_t i = 0; i < data->size; i++) {
+                json_free(data->items[i]);
             }
+            free(data->items);
             break;
         }
         
         case JSON_OBJECT: {
-            JsonObjectItem *item = value->value.object;
-            while (item) {
-                JsonObjectItem *next = item->next;
-                free(item->key);
-                json_free(item->value);
-                free(item);
-                item = next;
+            JsonObjectData *data = &value->value.object;
+            for (size_t i = 0; i < data->size; i++) {
+                free(data->items[i].key);
+                json_free(data->items[i].value);
             }
+            free(data->items);
+            free(data->index);
             break;
         }
         
@@ -332,16 +534,12 @@ static void json_stringify_recursive(const JsonValue *value, char **buffer, size
         case JSON_ARRAY: {
             append_char(buffer, bufsize, offset, '[');
             
-            JsonArrayItem *item = value->value.array;
-            int first = 1;
-            
-            while (item) {
-                if (!first) {
+            const JsonArrayData *data = &value->value.array;
+            for (size_t i = 0; i < data->size; i++) {
+                if (i > 0) {
                     append_char(buffer, bufsize, offset, ',');
                 }
-                json_stringify_recursive(item->value, buffer, bufsize, offset);
-                first = 0;
-                item = item->next;
+                json_stringify_recursive(data->items[i], buffer, bufsize, offset);
             }
             
             append_char(buffer, bufsize, offset, ']');
@@ -351,20 +549,15 @@ static void json_stringify_recursive(const JsonValue *value, char **buffer, size
         case JSON_OBJECT: {
             append_char(buffer, bufsize, offset, '{');
             
-            JsonObjectItem *item = value->value.object;
-            int first = 1;
-            
-            while (item) {
-                if (!first) {
+            const JsonObjectData *data = &value->value.object;
+            for (size_t i = 0; i < data->size; i++) {
+                if (i > 0) {
                     append_char(buffer, bufsize, offset, ',');
                 }
                 
-                json_stringify_string(item->key, buffer, bufsize, offset);
+                json_stringify_string(data->items[i].key, buffer, bufsize, offset);
                 append_char(buffer, bufsize, offset, ':');
-                json_stringify_recursive(item->value, buffer, bufsize, offset);
-                
-                first = 0;
-                item = item->next;
+                json_stringify_recursive(data->items[i].value, buffer, bufsize, offset);
             }
             
             append_char(buffer, bufsize, offset, '}');
@@ -387,14 +580,14 @@ char* json_stringify(const JsonValue *value) {
 }
 
 // JSON 파싱
+// 배열/객체 중첩 한계: 파서가 재귀하므로 "[[[[..." 같은 긴 줄이 스택을 넘기지 못하게 (넘으면 파싱 실패)
+#define JSON_MAX_DEPTH 64
+
 static const char* skip_whitespace(const char *str) {
-    while (*str && (*str == ' ' || *str == '\t' || *str == '\r' || *str == '\n')) {
-        str++;
-    }
-    return str;
+    return json_scan_whitespace(str);
 }
 
-static const char* parse_value(const char *str, JsonValue **value);
+static const char* parse_value(const char *str, JsonValue **value, int depth);
 
 static const char* parse_string(const char *str, char **result) {
     if (*str != '"') {
@@ -403,45 +596,42 @@ static const char* parse_string(const char *str, char **result) {
     
     str++;
     
-    // 문자열 길이 계산
+    // 닫는 따옴표 찾기: 특수 문자('"', '\\', '\0')까지 벡터 스캔으로 건너뜀
     const char *start = str;
-    int escaped = 0;
-    int len = 0;
-    
-    while (*str) {
-        if (*str == '\\') {
-            escaped = 1;
-            str++;
-            if (!*str) {
-                return NULL; // 불완전한 이스케이프 시퀀스
-            }
-        } else if (*str == '"' && !escaped) {
+    int has_escape = 0;
+    
+    while (1) {
+        str = json_scan_string(str);
+        if (*str == '"') {
             break;
-        } else {
-            escaped = 0;
         }
-        
-        str++;
-        len++;
-    }
-    
-    if (*str != '"') {
-        return NULL; // 종료되지 않은 문자열
+        if (*str == '\0' || str[1] == '\0') {
+            return NULL; // 종료되지 않은 문자열 / 불완전한 이스케이프 시퀀스
+        }
+        has_escape = 1;
+        str += 2;
     }
     
-    // 문자열 복사
-    *result = (char*)malloc(len + 1);
+    // 문자열 복사 (아레나 모드면 아레나에). 이스케이프는 줄어들기만 하므로 원본 길이면 충분
+    size_t span = (size_t)(str - start);
+    *result = (char*)json_alloc(current_arena != NULL, span + 1);
     if (!*result) {
         return NULL;
     }
     
+    if (!has_escape) {
+        memcpy(*result, start, span);
+        (*result)[span] = '\0';
+        return str + 1; // '"' 건너뛰기
+    }
+    
     char *out = *result;
-    str = start;
+    const char *in = start;
     
-    while (len > 0) {
-        if (*str == '\\') {
-            str++;
-            switch (*str) {
+    while (in < str) {
+        if (*in == '\\') {
+            in++;
+            switch (*in) {
                 case '"': *out = '"'; break;
                 case '\\': *out = '\\'; break;
                 case '/': *out = '/'; break;
@@ -450,15 +640,14 @@ static const char* parse_string(const char *str, char **result) {
                 case 'n': *out = '\n'; break;
                 case 'r': *out = '\r'; break;
                 case 't': *out = '\t'; break;
-                default: *out = *str; break;
+                default: *out = *in; break;
             }
         } else {
-            *out = *str;
+            *out = *in;
         }
         
         out++;
-        str++;
-        len--;
+        in++;
     }
     
     *out = '\0';
@@ -476,7 +665,7 @@ static const char* parse_number(const char *str, double *result) {
     return end;
 }
 
-static const char* parse_array(const char *str, JsonValue **value) {
+static const char* parse_array(const char *str, JsonValue **value, int depth) {
     if (*str != '[') {
         return NULL;
     }
@@ -495,7 +684,7 @@ static const char* parse_array(const char *str, JsonValue **value) {
     
     while (1) {
         JsonValue *item_value = NULL;
-        str = parse_value(str, &item_value);
+        str = parse_value(str, &item_value, depth + 1);
         
         if (!str || !item_value) {
             json_free(*value);
@@ -520,7 +709,7 @@ static const char* parse_array(const char *str, JsonValue **value) {
     }
 }
 
-static const char* parse_object(const char *str, JsonValue **value) {
+static const char* parse_object(const char *str, JsonValue **value, int depth) {
     if (*str != '{') {
         return NULL;
     }
@@ -549,24 +738,23 @@ static const char* parse_object(const char *str, JsonValue **value) {
         
         str = skip_whitespace(str);
         if (*str != ':') {
-            free(key);
+            json_release((*value)->in_arena, key);
             json_free(*value);
             *value = NULL;
             return NULL;
         }
         
         JsonValue *item_value = NULL;
-        str = parse_value(skip_whitespace(str + 1), &item_value);
+        str = parse_value(skip_whitespace(str + 1), &item_value, depth + 1);
         
         if (!str || !item_value) {
-            free(key);
+            json_release((*value)->in_arena, key);
             json_free(*value);
             *value = NULL;
             return NULL;
         }
         
-        json_object_set(*value, key, item_value);
-        free(key);
+        object_set_owned(*value, key, item_value);
         
         str = skip_whitespace(str);
         if (*str == '}') {
@@ -583,7 +771,7 @@ static const char* parse_object(const char *str, JsonValue **value) {
     }
 }
 
-static const char* parse_value(const char *str, JsonValue **value) {
+static const char* parse_value(const char *str, JsonValue **value, int depth) {
     str = skip_whitespace(str);
     
     switch (*str) {
@@ -612,18 +800,25 @@ static const char* parse_value(const char *str, JsonValue **value) {
             char *string_value;
             const char *new_str = parse_string(str, &string_value);
             if (new_str) {
-                *value = json_string(string_value);
-                free(string_value);
+                // 파싱한 버퍼를 그대로 값으로 씀 (다시 복사하지 않음)
+                *value = json_new(JSON_STRING);
+                if (!*value) {
+                    json_release(current_arena != NULL, string_value);
+                    return NULL;
+                }
+                (*value)->value.string = string_value;
                 return new_str;
             }
             break;
         }
         
         case '[':
-            return parse_array(str, value);
+            if (depth >= JSON_MAX_DEPTH) return NULL;
+            return parse_array(str, value, depth);
         
         case '{':
-            return parse_object(str, value);
+            if (depth >= JSON_MAX_DEPTH) return NULL;
+            return parse_object(str, value, depth);
         
         default:
             if ((*str >= '0' && *str <= '9') || *str == '-') {
@@ -642,7 +837,7 @@ static const char* parse_value(const char *str, JsonValue **value) {
 
 JsonValue* json_parse(const char *string) {
     JsonValue *value = NULL;
-    const char *end = parse_value(string, &value);
+    const char *end = parse_value(string, &value, 0);
     
     if (!end || *skip_whitespace(end) != '\0') {
         json_free(value);
@@ -184,31 +184,46 @@ MessageType parseMessageType(JsonValue *jsonValue) {
         return MSG_UNKNOWN;
     }
     
-    if (strcmp(type, "register") == 0) {
-        return MSG_REGISTER;
-    } else if (strcmp(type, "move") == 0) {
-        return MSG_MOVE;
-    } else if (strcmp(type, "register_ack") == 0) {
-        return MSG_REGISTER_ACK;
-    } else if (strcmp(type, "register_nack") == 0) {
-        return MSG_REGISTER_NACK;
-    } else if (strcmp(type, "game_start") == 0) {
-        return MSG_GAME_START;
-    } else if (strcmp(type, "your_turn") == 0) {
-        return MSG_YOUR_TURN;
-    } else if (strcmp(type, "move_ok") == 0) {
-        return MSG_MOVE_OK;
-    } else if (strcmp(type, "invalid_move") == 0) {
-        return MSG_INVALID_MOVE;
-    } else if (strcmp(type, "pass") == 0) {
-        return MSG_PASS;
-    } else if (strcmp(type, "game_over") == 0) {
-        return MSG_GAME_OVER;
+    return parseMessageTypeName(type, strlen(type));
+}
+
+// 메시지 유형 이름 표 (parseMessageTypeName, messageTypeName 공용)
+static const struct {
+    const char *name;
+    MessageType type;
+} message_type_names[] = {
+    { "register", MSG_REGISTER },
+    { "move", MSG_MOVE },
+    { "spectate", MSG_SPECTATE },
+    { "register_ack", MSG_REGISTER_ACK },
+    { "register_nack", MSG_REGISTER_NACK },
+    { "game_start", MSG_GAME_START },
+    { "your_turn", MSG_YOUR_TURN },
+    { "move_ok", MSG_MOVE_OK },
+    { "invalid_move", MSG_INVALID_MOVE },
+    { "pass", MSG_PASS },
+    { "game_over", MSG_GAME_OVER },
+};
+
+// 메시지 유형 이름 → MessageType (이름은 '\0'으로 끝나지 않아도 됨)
+MessageType parseMessageTypeName(const char *type, size_t length) {
+    for (size_t i = 0; i < sizeof(message_type_names) / sizeof(message_type_names[0]); i++) {
+        if (strlen(message_type_names[i].name) == length && memcmp(message_type_names[i].name, type, length) == 0) {
+            return message_type_names[i].type;
+        }
     }
     
     return MSG_UNKNOWN;
 }
 
+// MessageType → 이름 (MSG_UNKNOWN 등 표에 없으면 "unknown")
+const char* messageTypeName(MessageType type) {
+    for (size_t i = 0; i < sizeof(message_type_names) / sizeof(message_type_names[0]); i++) {
+        if (message_type_names[i].type == type) return message_type_names[i].name;
+    }
+    return "unknown";
+}
+
 // 등록 메시지 파싱
 char* parseRegisterMessage(JsonValue *jsonValue) {
     JsonValue *usernameValue = json_object_get(jsonValue, "username");
@@ -370,20 +385,20 @@ int parseGameOverMessage(JsonValue *jsonValue, char players[2][64], int scores[2
     }
     
     // 첫 번째 플레이어/점수 쌍 찾기
-    JsonObjectItem *item = scoresValue->value.object;
+    size_t count = json_object_size(scoresValue);
     int playerIndex = 0;
     
-    while (item && playerIndex < 2) {
-        if (!json_is_number(item->value)) {
+    while ((size_t)playerIndex < count && playerIndex < 2) {
+        JsonValue *score = json_object_value(scoresValue, playerIndex);
+        if (!json_is_number(score)) {
             return 0;
         }
         
-        strncpy(players[playerIndex], item->key, 63);
+        strncpy(players[playerIndex], json_object_key(scoresValue, playerIndex), 63);
         players[playerIndex][63] = '\0';
-        scores[playerIndex] = (int)json_number_value(item->value);
+        scores[playerIndex] = (int)json_number_value(score);
         
         playerIndex++;
-        item = item->next;
     }
     
     return playerIndex == 2;
@@ -9,6 +9,7 @@ typedef enum {
     // 클라이언트에서 서버로
     MSG_REGISTER,
     MSG_MOVE,
+    MSG_SPECTATE,           // 관전 신청 (관전 스트림은 watch_* 메시지로 받음)
     
     // 서버에서 클라이언트로
     MSG_REGISTER_ACK,
@@ -56,6 +57,8 @@ JsonValue* createGameOverMessage(const char *players[2], int scores[2]);
 
 // 메시지 유형 파싱
 MessageType parseMessageType(JsonValue *jsonValue);
+MessageType parseMessageTypeName(const char *type, size_t length);
+const char* messageTypeName(MessageType type);
 
 // 등록 메시지 파싱
 char* parseRegisterMessage(JsonValue *jsonValue);
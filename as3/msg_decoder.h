@@ -0,0 +1,64 @@
+#ifndef MSG_DECODER_H
+#define MSG_DECODER_H
+
+#include <stdint.h>
+#include "message_handler.h"
+
+// OctaFlip 프로토콜 메시지 전용 디코더.
+// 받은 한 줄을 한 번만 훑으면서 필요한 필드를 바로 꺼낸다 (JsonValue 트리도, 문자열 복사도 없음).
+// 문자열 필드는 입력 버퍼 안을 가리키는 뷰이고, 디코드가 성공하면 닫는 따옴표 자리에 '\0'을 써서
+// 그대로 C 문자열로 쓸 수 있게 만든다. 따라서 뷰는 입력 버퍼가 살아 있는 동안만 유효하다.
+// 이스케이프가 든 문자열처럼 빠른 경로가 다루지 않는 입력이면 0을 돌려주고 버퍼는 건드리지 않으므로,
+// 호출자는 json_parse + decodeMessageTree로 처리하면 된다 (결과 형식은 같음).
+// 바이너리 프레이밍(msg_binary.h)을 협상한 연결의 프레임은 decodeBinaryMessage가 같은 형식으로 꺼낸다.
+// 보드 델타(board_delta.h)는 seq/hash/flipped와 move 좌표로 들어온다.
+
+// 메시지에 들어 있던 필드 (DecodedMessage.fields)
+#define DECODED_USERNAME        (1u << 0)
+#define DECODED_MOVE            (1u << 1)   // sx, sy, tx, ty 모두 숫자
+#define DECODED_REASON          (1u << 2)
+#define DECODED_PLAYERS         (1u << 3)   // 문자열 2개짜리 배열
+#define DECODED_FIRST_PLAYER    (1u << 4)
+#define DECODED_BOARD           (1u << 5)   // 문자열 8개짜리 배열
+#define DECODED_TIMEOUT         (1u << 6)
+#define DECODED_NEXT_PLAYER     (1u << 7)   // 문자열 또는 null
+#define DECODED_SCORES          (1u << 8)   // 앞의 두 항목이 숫자인 객체 (이름은 players에)
+#define DECODED_CAPABILITIES    (1u << 9)   // 문자열 배열 (아는 이름만 capabilities 비트로)
+#define DECODED_SEQ             (1u << 10)
+#define DECODED_HASH            (1u << 11)  // 16진 문자열
+#define DECODED_FLIPPED         (1u << 12)  // 16진 문자열
+#define DECODED_GAMES           (1u << 13)  // 숫자 배열 (spectate의 대국 번호, 앞의 DECODED_MAX_GAMES개까지)
+
+#define DECODED_MAX_GAMES 16
+
+typedef struct {
+    MessageType type;
+    unsigned int fields;
+    const char *username;
+    const char *reason;
+    const char *players[2];     // game_start의 players, game_over의 scores 키
+    const char *first_player;
+    const char *next_player;    // null이면 NULL
+    int scores[2];
+    Move move;                  // 좌표만 채움 (player는 호출자가)
+    double timeout;
+    unsigned int capabilities;  // CAPABILITY_* (msg_binary.h)
+    uint32_t seq;               // 보드 델타 (board_delta.h)
+    uint64_t hash;
+    uint64_t flipped;
+    int games[DECODED_MAX_GAMES];
+    int game_count;
+    GameBoard board;            // cells와 말 개수만 채움
+} DecodedMessage;
+
+// 빠른 경로. 성공하면 1, 다룰 수 없는 입력이면 0 (이때 line은 바뀌지 않음)
+int decodeMessage(char *line, DecodedMessage *message);
+
+// 바이너리 프레임 본문(길이 헤더 다음)을 디코드. 형식이 맞으면 1.
+// 문자열은 프레임 안의 '\0'으로 끝나는 바이트를 그대로 가리킨다
+int decodeBinaryMessage(const char *frame, size_t length, DecodedMessage *message);
+
+// 느린 경로: 이미 파싱된 트리에서 같은 형식으로 꺼냄. 문자열은 트리 안을 가리킨다
+void decodeMessageTree(const JsonValue *json, DecodedMessage *message);
+
+#endif /* MSG_DECODER_H */
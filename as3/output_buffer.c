@@ -0,0 +1,82 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "output_buffer.h"
+
+#define OUTPUT_BUFFER_INITIAL 4096
+
+void output_buffer_init(OutputBuffer *buffer) {
+    memset(buffer, 0, sizeof(OutputBuffer));
+}
+
+void output_buffer_destroy(OutputBuffer *buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(OutputBuffer));
+}
+
+// 용량을 늘리면서 내용을 앞쪽으로 펼침
+static int grow(OutputBuffer *buffer, size_t needed) {
+    size_t capacity = buffer->capacity ? buffer->capacity : OUTPUT_BUFFER_INITIAL;
+    while (capacity < needed) capacity *= 2;
+    if (capacity == buffer->capacity) return 0;
+
+    char *data = (char*)malloc(capacity);
+    if (!data) return -1;
+    size_t first = buffer->capacity - buffer->head;
+    if (first > buffer->length) first = buffer->length;
+    if (buffer->length > 0) {
+        memcpy(data, buffer->data + buffer->head, first);
+        memcpy(data + first, buffer->data, buffer->length - first);
+    }
+    free(buffer->data);
+    buffer->data = data;
+    buffer->capacity = capacity;
+    buffer->head = 0;
+    return 0;
+}
+
+int output_buffer_append(OutputBuffer *buffer, const char *data, size_t len) {
+    if (buffer->length + len > buffer->capacity && grow(buffer, buffer->length + len) != 0) {
+        return -1;
+    }
+    size_t mask = buffer->capacity - 1;
+    size_t tail = (buffer->head + buffer->length) & mask;
+    size_t first = buffer->capacity - tail;
+    if (first > len) first = len;
+    memcpy(buffer->data + tail, data, first);
+    memcpy(buffer->data, data + first, len - first);
+    buffer->length += len;
+    return 0;
+}
+
+int output_buffer_flush(OutputBuffer *buffer, int fd) {
+    while (buffer->length > 0) {
+        struct iovec iov[2];
+        size_t first = buffer->capacity - buffer->head;
+        if (first > buffer->length) first = buffer->length;
+        iov[0].iov_base = buffer->data + buffer->head;
+        iov[0].iov_len = first;
+        iov[1].iov_base = buffer->data;
+        iov[1].iov_len = buffer->length - first;
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (iov[1].iov_len > 0) ? 2 : 1;
+
+        // 끊긴 연결에 보내도 SIGPIPE 없이 EPIPE로 받음
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+            return -1;
+        }
+        buffer->head = (buffer->head + (size_t)sent) & (buffer->capacity - 1);
+        buffer->length -= (size_t)sent;
+    }
+    // 비면 처음부터 채우도록 (다음 메시지가 한 조각으로 나가게)
+    buffer->head = 0;
+    return 0;
+}
@@ -121,7 +121,7 @@ Move solveEndgame(const GameBoard *board, char player) {
     }
     
     // 종반에서는 더 깊게 탐색
-    engine->start_time = clock();
+    engine->start_time = engineClock();
     engine->time_limit_exceeded = 0;
     
     Move best_move;